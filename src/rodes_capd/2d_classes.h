@@ -17,7 +17,8 @@
 #include "classes.h"
 
 // Enumerations used for data_line status.
-enum {NOT_DONE, BEING_DONE, DONE, DO_AGAIN, FAILED, RESERVED};
+// REFINED: done as its four grids of P + 1 (see 'rodes --refine').
+enum {NOT_DONE, BEING_DONE, DONE, DO_AGAIN, FAILED, RESERVED, REFINED};
 enum {NOT_HIT, HIT};
 
 static const int    OUTPUT_PRECISION = 17; // string - double conversion exact.
@@ -50,14 +51,23 @@ class grid
 	return false;
       return true;
     }
-  friend BOX grid_to_box(const grid &g)
+  friend IVector grid_to_box(const grid &g)
     {
-      BOX result(2);
+      IVector result(2);
       result [ 0 ]  = interval ( g.u - 1, g.u + 1 );
       result [ 1 ] = interval ( g.v - 1, g.v + 1 );
-      result *= power( 2, -g.P );
+      result *= interval( ldexp(1.0, -g.P) ); // 2^-P, exactly.
       return result;
     }
+  friend void grid_children(const grid &g, grid child[4])
+    { // The four grids of P + 1 in g: the halves of its sides.
+      for ( int i = 0; i < 4; i++ )
+	{
+	  child[i].u = 2 * g.u + ( i & 1 ? 1 : -1 );
+	  child[i].v = 2 * g.v + ( i & 2 ? 1 : -1 );
+	  child[i].P = g.P + 1;
+	}
+    }
   friend ostream & operator << (ostream &out, const grid &g)
     {
       out.setf(ios::showpos);
@@ -98,7 +108,7 @@ public:
     {
       return (grd != rhs.grd);
     }
-  friend BOX ndl_to_box(const new_data_line &ndl)
+  friend IVector ndl_to_box(const new_data_line &ndl)
     {
       return grid_to_box(ndl.grd);
     }
@@ -0,0 +1,387 @@
+/*   File: checkpoint.cc
+
+     Checkpoints of a grid being done. See 'checkpoint.h'.
+
+     The file holds
+
+       RODES-CKPT <version>
+       <iterate>
+       stop <level> <trvl> <sign> <max_d_step>
+       in <n>                  followed by n parcels,
+       return <n>              followed by n parcels,
+       sets <m>                followed by m sets,
+       end
+
+     one parcel per line: "<trvl> <sign> <message> <time>
+     <box(1)> ... <box(SYSDIM)> [<angles> <expansion>]",
+     each interval given as "<inf> <sup>".
+
+     With 'rodes --lohner', m = n: the set of each parcel
+     of "in" (see 'doubleton' in 'classes.h'), one per
+     line: "<trvl> <sign>", followed, unless trvl = 0, by
+     c, r0, r, hull (SYSDIM intervals each), C and B (row
+     by row). Without it, m = 0. A checkpoint is only
+     resumed with the '--lohner' it was written with.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include <unistd.h>
+
+#include "checkpoint.h"
+#include "lohner.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+static int interval_seconds = CHECKPOINT_INTERVAL; // 0: never.
+
+static void write_double   (ostream &, const double &);
+static bool read_double    (istream &, double &);
+static void write_interval (ostream &, const interval &);
+static bool read_interval  (istream &, interval &);
+static void write_sets     (ostream &, List<parcel> &);
+static bool read_sets      (istream &, List<parcel> &);
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'work_on_grid' (rodes)
+// Calls to : none
+checkpoint::checkpoint(const std::string &name, const iterate &grid_it)
+  : file_name(name), it(grid_it), last(time(NULL))
+{
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'Flow_The_Parcel' (return_map)
+// Calls to : none
+bool checkpoint::due() const
+{
+  return ( interval_seconds > 0 &&
+	   difftime(time(NULL), last) >= interval_seconds );
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'Flow_The_Parcel' (return_map), 'flow_pool::pause'
+// Calls to : 'write_double', 'write_parcels', 'write_sets'
+// Writes the state of 'Flow_The_Parcel' next to the file, and then
+// renames it into place: a worker killed while writing leaves the
+// previous checkpoint.
+void checkpoint::write(const stop_parameters &sp, List<parcel> &In_List,
+		       List<parcel> &Return_List)
+{
+  std::string temp_name = file_name + "_new";
+  std::ofstream OutFile(temp_name.c_str(), ios::out);
+
+  OutFile << "RODES-CKPT " << CHECKPOINT_VERSION << "\n"
+	  << it << "\n"
+	  << "stop ";
+  write_double(OutFile, sp.level);
+  OutFile << " " << sp.trvl << " " << sp.sign << " ";
+  write_double(OutFile, sp.max_d_step);
+  OutFile << "\n";
+  write_parcels(OutFile, "in", In_List);
+  write_parcels(OutFile, "return", Return_List);
+  write_sets(OutFile, In_List);
+  OutFile << "end" << endl;
+  OutFile.close();
+
+  if ( !OutFile || rename(temp_name.c_str(), file_name.c_str()) != 0 )
+    {
+      cout << "Warning: could not write the checkpoint " << file_name << endl;
+      unlink(temp_name.c_str());
+    }
+  last = time(NULL);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'Compute_the_return' (return_map)
+// Calls to : 'read_double', 'read_parcels', 'read_sets'
+// Reads the state left by 'write', if there is a (complete)
+// checkpoint of our iterate. Returns false if we start afresh.
+bool checkpoint::resume(stop_parameters &sp, List<parcel> &In_List,
+			List<parcel> &Return_List)
+{
+  std::ifstream InFile(file_name.c_str(), ios::in);
+  std::string tag, line;
+  int version = 0;
+  iterate saved;
+
+  if ( !(InFile >> tag >> version) || tag != "RODES-CKPT" ||
+       version != CHECKPOINT_VERSION || !(InFile >> saved) ||
+       saved.ndl.grd.u != it.ndl.grd.u || saved.ndl.grd.v != it.ndl.grd.v ||
+       saved.ndl.grd.P != it.ndl.grd.P )
+    return false; // Not '==': the parcels of (u, v) are not those of (-u, -v).
+
+  stop_parameters temp_sp;
+  List<parcel> temp_in, temp_return;
+  if ( !(InFile >> tag) || tag != "stop" || !read_double(InFile, temp_sp.level) ||
+       !(InFile >> temp_sp.trvl >> temp_sp.sign) ||
+       !read_double(InFile, temp_sp.max_d_step) ||
+       !read_parcels(InFile, "in", temp_in) ||
+       !read_parcels(InFile, "return", temp_return) )
+    {
+      cout << "Warning: ignored the damaged checkpoint " << file_name << endl;
+      return false;
+    }
+  if ( !read_sets(InFile, temp_in) || !(InFile >> tag) || tag != "end" )
+    { // The sets are part of the state: without them, the parcels
+      // would be flowed differently.
+      cout << "Warning: ignored the checkpoint " << file_name << " (damaged, or "
+	   << ( Lohner() ? "not " : "" ) << "written with --lohner)" << endl;
+      return false;
+    }
+
+  sp = temp_sp;
+  while ( !IsEmpty(temp_in) )
+    {
+      In_List += First(temp_in);
+      --temp_in;
+    }
+  while ( !IsEmpty(temp_return) )
+    {
+      Return_List += First(temp_return);
+      --temp_return;
+    }
+  cout << "Resumed from " << file_name << ": " << Length(In_List)
+       << " parcels to flow, " << Length(Return_List) << " returns." << endl;
+  last = time(NULL);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'work_on_grid' (rodes)
+// Calls to : none
+// The grid is done (or has failed): there is nothing to resume.
+void checkpoint::remove()
+{
+  unlink(file_name.c_str());
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_the_options' (rodes)
+// Calls to : none
+// Sets the time between two checkpoints (seconds); 0 turns them off.
+void checkpoint_every(const int &seconds)
+{
+  interval_seconds = seconds;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main', 'work_in_thread' (rodes)
+// Calls to : none
+// Returns true (and the iterate in 'it') if the checkpoint file
+// 'file_name' was left by a worker that did not finish its grid.
+bool checkpoint_pending(const std::string &file_name, iterate &it)
+{
+  std::ifstream InFile(file_name.c_str(), ios::in);
+  std::string tag;
+  int version = 0;
+
+  return ( InFile >> tag >> version && tag == "RODES-CKPT" &&
+	   version == CHECKPOINT_VERSION && InFile >> it );
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Doubles are written in hexadecimal ("%a"): they are read back
+// exactly.
+static void write_double(ostream &out, const double &x)
+{
+  char text[40];
+
+  snprintf(text, sizeof(text), "%a", x);
+  out << text;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Reads a number written by 'write_double'. (Not "%la": with GNU
+// extensions, scanf takes 'a' to mean allocation.)
+static bool read_double(istream &in, double &x)
+{
+  std::string text;
+  char *end;
+
+  if ( !(in >> text) )
+    return false;
+  x = strtod(text.c_str(), &end);
+  return ( *end == '\0' );
+}
+
+////////////////////////////////////////////////////////////////////
+
+static void write_interval(ostream &out, const interval &x)
+{
+  write_double(out, Inf(x));
+  out << " ";
+  write_double(out, Sup(x));
+}
+
+////////////////////////////////////////////////////////////////////
+
+static bool read_interval(istream &in, interval &x)
+{
+  double lo, hi;
+
+  if ( !read_double(in, lo) || !read_double(in, hi) || !(lo <= hi) )
+    return false;
+  x = interval(lo, hi);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'checkpoint::write'
+// Calls to : 'write_interval'
+// The sets of the parcels (with '--lohner' only).
+static void write_sets(ostream &out, List<parcel> &pcl_List)
+{
+  out << "sets " << ( Lohner() ? Length(pcl_List) : 0 ) << "\n";
+  if ( !Lohner() || IsEmpty(pcl_List) )
+    return;
+  First(pcl_List);
+  while ( !Finished(pcl_List) )
+    {
+      const doubleton &s = Current(pcl_List).set;
+      out << s.trvl << " " << s.sign;
+      if ( s.trvl != 0 )
+	{
+	  for ( short i = 1; i <= SYSDIM; i++ )
+	    {
+	      out << " ";
+	      write_interval(out, s.c(i));
+	      out << " ";
+	      write_interval(out, s.r0(i));
+	      out << " ";
+	      write_interval(out, s.r(i));
+	      out << " ";
+	      write_interval(out, s.hull(i));
+	    }
+	  for ( short i = 1; i <= SYSDIM; i++ )
+	    for ( short j = 1; j <= SYSDIM; j++ )
+	      {
+		out << " ";
+		write_interval(out, s.C(i, j));
+		out << " ";
+		write_interval(out, s.B(i, j));
+	      }
+	}
+      out << "\n";
+      Next(pcl_List);
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'checkpoint::resume'
+// Calls to : 'read_interval'
+// Gives the parcels of pcl_List their sets. Returns false unless
+// there is one for each parcel with '--lohner', and none without.
+static bool read_sets(istream &in, List<parcel> &pcl_List)
+{
+  std::string word;
+  int count = -1;
+
+  if ( !(in >> word >> count) || word != "sets" ||
+       count != ( Lohner() ? Length(pcl_List) : 0 ) )
+    return false;
+  if ( count == 0 )
+    return true;
+  First(pcl_List);
+  while ( !Finished(pcl_List) )
+    {
+      doubleton s;
+      if ( !(in >> s.trvl >> s.sign) )
+	return false;
+      if ( s.trvl != 0 )
+	{
+	  for ( short i = 1; i <= SYSDIM; i++ )
+	    if ( !read_interval(in, s.c(i)) || !read_interval(in, s.r0(i)) ||
+		 !read_interval(in, s.r(i)) || !read_interval(in, s.hull(i)) )
+	      return false;
+	  for ( short i = 1; i <= SYSDIM; i++ )
+	    for ( short j = 1; j <= SYSDIM; j++ )
+	      if ( !read_interval(in, s.C(i, j)) || !read_interval(in, s.B(i, j)) )
+		return false;
+	}
+      Current(pcl_List).set = s;
+      Next(pcl_List);
+    }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'checkpoint::write', 'cache_store' (result_cache)
+// Calls to : 'write_interval'
+void write_parcels(ostream &out, const char *tag, List<parcel> &pcl_List)
+{
+  out << tag << " " << Length(pcl_List) << "\n";
+  if ( IsEmpty(pcl_List) )
+    return;
+  First(pcl_List);
+  while ( !Finished(pcl_List) )
+    {
+      const parcel &pcl = Current(pcl_List);
+      out << pcl.trvl << " " << pcl.sign << " " << pcl.message << " ";
+      write_interval(out, pcl.time);
+      for ( int i = 1; i <= SYSDIM; i++ )
+	{
+	  out << " ";
+	  write_interval(out, pcl.box(i));
+	}
+#ifdef COMPUTE_C1
+      out << " ";
+      write_interval(out, pcl.angles);
+      out << " ";
+      write_interval(out, pcl.expansion);
+#endif
+      out << "\n";
+      Next(pcl_List);
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'checkpoint::resume', 'cache_lookup' (result_cache)
+// Calls to : 'read_interval'
+bool read_parcels(istream &in, const char *tag, List<parcel> &pcl_List)
+{
+  std::string word;
+  int count = -1;
+
+  if ( !(in >> word >> count) || word != tag || count < 0 )
+    return false;
+  for ( int n = 0; n < count; n++ )
+    {
+      parcel pcl;
+      pcl.box = BOX(SYSDIM);
+      if ( !(in >> pcl.trvl >> pcl.sign >> pcl.message) ||
+	   !read_interval(in, pcl.time) )
+	return false;
+      for ( int i = 1; i <= SYSDIM; i++ )
+	if ( !read_interval(in, pcl.box(i)) )
+	  return false;
+#ifdef COMPUTE_C1
+      if ( !read_interval(in, pcl.angles) || !read_interval(in, pcl.expansion) )
+	return false;
+#endif
+      pcl_List += pcl;
+    }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
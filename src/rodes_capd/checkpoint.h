@@ -0,0 +1,70 @@
+/*   File: checkpoint.h
+
+     Checkpoints of a grid being done. Every so often,
+     'Flow_The_Parcel' writes its state (the parcels left
+     to flow, the returns found so far, and the stopping
+     parameters) to the file of the worker, together with
+     the iterate it works on. A worker restarted after
+     being killed finds the file, and resumes the grid
+     where the checkpoint left it.
+
+     The numbers are written exactly (in hexadecimal),
+     with the sets of the parcels under 'rodes --lohner',
+     so that a resumed grid gives the same result as an
+     uninterrupted one ('ckpt_test' checks this).
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <string>
+#include <ctime>
+
+#include "2d_classes.h"
+#include "classes.h"
+#include "list.h"
+
+////////////////////////////////////////////////////////////////////
+
+// The checkpoint of <proc_file> is <proc_file> followed by this suffix.
+static const char CHECKPOINT_SUFFIX[] = ".ckpt";
+
+const int CHECKPOINT_VERSION = 2;  // 2: with the sets.
+
+// The default time between two checkpoints (seconds).
+const int CHECKPOINT_INTERVAL = 600;
+
+////////////////////////////////////////////////////////////////////
+
+class checkpoint
+{
+ public:
+  checkpoint(const std::string &, const iterate &);
+
+  bool due    () const;
+  void write  (const stop_parameters &, List<parcel> &, List<parcel> &);
+  bool resume (stop_parameters &, List<parcel> &, List<parcel> &);
+  void remove ();
+
+ private:
+  std::string file_name;
+  iterate     it;         // The iterate being done.
+  time_t      last;       // The last checkpoint (or the start).
+};
+
+////////////////////////////////////////////////////////////////////
+
+void checkpoint_every   (const int &);
+
+bool checkpoint_pending (const std::string &, iterate &);
+
+// The parcels, one per line (also used by 'result_cache').
+void write_parcels      (ostream &, const char *, List<parcel> &);
+
+bool read_parcels       (istream &, const char *, List<parcel> &);
+
+////////////////////////////////////////////////////////////////////
+
+#endif // CHECKPOINT_H
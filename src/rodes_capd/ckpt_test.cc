@@ -0,0 +1,210 @@
+/*   File: ckpt_test.cc
+
+     Checks that a grid resumed from a checkpoint written
+     under '--lohner' gives the same returns as the run
+     that wrote it (see 'checkpoint.h'), and compares the
+     returns with those of the corner method.
+
+     The grid is flowed three times:
+
+       1. by the corner method (no checkpoint);
+       2. with '--lohner', a checkpoint being written every
+          second: the last one is left in the file, as by
+          a worker killed after writing it;
+       3. with '--lohner', resumed from that checkpoint.
+
+     The returns of 3 must be those of 2, bound for bound,
+     and the hulls of 1 and 2 must meet (both enclose the
+     image of the grid). Last, the checkpoint must not be
+     resumed without '--lohner': the grid is then flowed
+     afresh, and gives the returns of 1.
+
+     The grid should take a few seconds, so that a
+     checkpoint is written.
+
+     Usage: ckpt_test [u v P] [directory]
+            (default 1255 727 8, and /tmp)
+
+     Compilation: make ckpt_test
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+
+#include <unistd.h>
+
+#include "2d_classes.h"
+#include "classes.h"
+#include "checkpoint.h"
+#include "convert.h"
+#include "error_handler.h"
+#include "flow_functions.h"
+#include "list.h"
+#include "lohner.h"
+#include "return_map.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+static bool flow         (const iterate &, List<parcel> &, checkpoint *);
+static bool same_parcels (List<parcel> &, List<parcel> &);
+static bool same         (const interval &, const interval &);
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: none
+// Calls to : 'flow', 'same_parcels', 'Get_Hull', 'Intersection',
+//            'Set_Lohner', 'checkpoint_every'
+int main(int argc, char *argv[])
+{
+  if ( argc != 1 && argc != 2 && argc != 4 && argc != 5 )
+    {
+      cout << endl << "Usage: " << endl;
+      cout << "\t" << argv[0] << " [u v P] [directory]\n\n"
+	   << "\twhich checks that the grid (u, v, P) (default 1255 727 8)\n"
+	   << "\tresumed from a checkpoint under --lohner gives the returns\n"
+	   << "\tof an uninterrupted run, and compares them with the corner\n"
+	   << "\tmethod. The checkpoint is written in [directory] (default /tmp).\n"
+	   << endl;
+      exit(0);
+    }
+
+  iterate it;
+  it.ndl.grd.u = ( argc >= 4 ? atoi(argv[1]) : 1255 );
+  it.ndl.grd.v = ( argc >= 4 ? atoi(argv[2]) : 727 );
+  it.ndl.grd.P = ( argc >= 4 ? atoi(argv[3]) : 8 );
+#ifdef COMPUTE_C1
+  it.ndl.ang = DEG_TO_RAD * Hull(0.0, 10.0);
+  it.ndl.pre_exp = LARGE_NUMBER;
+  it.ndl.min_exp = LARGE_NUMBER;
+#endif
+  it.ndl.c_stat = NOT_DONE;
+  it.ndl.h_stat = NOT_HIT;
+  it.inf_grd = NULL_GRID;
+  it.sup_grd = NULL_GRID;
+
+  std::ostringstream name;
+  name << ( argc == 2 || argc == 5 ? argv[argc - 1] : "/tmp" )
+       << "/ckpt_test_" << getpid() << CHECKPOINT_SUFFIX;
+  const std::string ckpt_name = name.str();
+  List<parcel> corner, whole, resumed, afresh;
+  int errors = 0;
+
+  Set_Lohner(false);
+  if ( !flow(it, corner, NULL) )
+    return 1;
+
+  Set_Lohner(true);
+  checkpoint_every(1);
+  checkpoint writer(ckpt_name, it);
+  if ( !flow(it, whole, &writer) )
+    return 1;
+  if ( access(ckpt_name.c_str(), F_OK) != 0 )
+    {
+      cout << "Error: no checkpoint was written (the grid " << it.ndl.grd
+	   << " took under a second); give a larger grid." << endl;
+      return 1;
+    }
+
+  checkpoint_every(0); // The file is left as the second run wrote it.
+  checkpoint reader(ckpt_name, it);
+  if ( !flow(it, resumed, &reader) )
+    errors++;
+  else if ( !same_parcels(resumed, whole) )
+    {
+      cout << "Error: the resumed grid gives other returns." << endl;
+      errors++;
+    }
+
+  parcel hull_corner, hull_lohner;
+  BOX meet(SYSDIM);
+  Get_Hull(hull_corner, corner);
+  Get_Hull(hull_lohner, whole);
+  cout << "corner: " << Length(corner) << " returns, hull " << hull_corner.box << endl;
+  cout << "lohner: " << Length(whole) << " returns, hull " << hull_lohner.box << endl;
+  if ( !Intersection(meet, hull_corner.box, hull_lohner.box) )
+    {
+      cout << "Error: the returns of the two methods do not meet." << endl;
+      errors++;
+    }
+
+  Set_Lohner(false);
+  checkpoint ignorer(ckpt_name, it);
+  if ( !flow(it, afresh, &ignorer) )
+    errors++;
+  else if ( !same_parcels(afresh, corner) )
+    {
+      cout << "Error: a --lohner checkpoint was resumed without --lohner." << endl;
+      errors++;
+    }
+
+  unlink(ckpt_name.c_str());
+  cout << "checkpoint under --lohner: " << ( errors == 0 ? "ok" : "FAILED" ) << endl;
+  return ( errors == 0 ? 0 : 1 );
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main'
+// Calls to : 'iterate_to_parcel', 'Compute_the_return'
+// Flows the grid of 'it' (as 'work_on_grid' in rodes does). Returns
+// false if the integrator gave up.
+static bool flow(const iterate &it, List<parcel> &pcl_List, checkpoint *ckpt)
+{
+  parcel pcl;
+
+  iterate_to_parcel(it, pcl);
+  try
+    {
+      Compute_the_return(pcl, pcl_List, ckpt);
+    }
+  catch( Error_Handler error )
+    {
+      error.Print_Message();
+      cout << "Error: could not flow the grid " << it.ndl.grd << endl;
+      return false;
+    }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main'
+// Calls to : 'same'
+// Are the parcels of the two (sorted) lists the same, bound for bound?
+static bool same_parcels(List<parcel> &one, List<parcel> &other)
+{
+  if ( Length(one) != Length(other) )
+    return false;
+  if ( IsEmpty(one) )
+    return true;
+  First(one);
+  First(other);
+  while ( !Finished(one) )
+    {
+      const parcel &a = Current(one), &b = Current(other);
+      if ( a.trvl != b.trvl || a.sign != b.sign || !same(a.time, b.time) )
+	return false;
+      for ( short i = 1; i <= SYSDIM; i++ )
+	if ( !same(a.box(i), b.box(i)) )
+	  return false;
+      Next(one);
+      Next(other);
+    }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+
+static bool same(const interval &a, const interval &b)
+{
+  return ( Inf(a) == Inf(b) && Sup(a) == Sup(b) );
+}
+
+////////////////////////////////////////////////////////////////////
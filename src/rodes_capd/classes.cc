@@ -43,8 +43,8 @@ interval Symm_Radius(const double &dbl)
 // the symmetric radius of an interval
 interval Symm_Radius(const interval &iv)
 {  
-    interval d = diam( iv ) / 2.0;
-    return d;
+    double r = Sup( diam( iv ) / 2.0 ); // Rounded up.
+    return interval( -r, r );
 }
 
 // Returns (by reference) intervals containing both
@@ -113,7 +113,7 @@ BOX Center(const BOX &bx)
   BOX temp(SYSDIM);
 
   for (register short i = 1; i <= SYSDIM; i++)
-    temp[ i ] = mid ( bx [ i ] ); 
+    temp( i ) = mid ( bx ( i ) ); 
 
   return temp;
 }
@@ -125,7 +125,7 @@ BOX Radius(const BOX &bx)
   BOX temp(SYSDIM);
 
   for (register short i = 1; i <= SYSDIM; i++) 
-    temp[ i ] = diam ( bx [ i ] ) / 2.0;  
+    temp( i ) = diam ( bx ( i ) ) / 2.0;  
 
   return temp;
 }
@@ -137,7 +137,7 @@ BOX Symm_Radius(const BOX &bx)
   BOX temp(SYSDIM);
 
   for (register short i = 1; i <= SYSDIM; i++)
-    temp[ i ] = Symm_Radius ( bx[ i ] ); // jjb -- SymHull(diam(bx(i)) / 2.0);
+    temp( i ) = Symm_Radius ( bx( i ) ); // jjb -- SymHull(diam(bx(i)) / 2.0);
 
   return temp;
 }
@@ -148,7 +148,7 @@ void Mid_And_SymRad(BOX &center, BOX &symmrad, const BOX &bx)
 {
   for (register short i = 1; i <= SYSDIM; i++)
     {
-      symmrad[ i ] = Symm_Radius ( bx [ i ] );// jjb -- SymHull(diam(bx(i)) / 2.0);
+      symmrad( i ) = Symm_Radius ( bx ( i ) );// jjb -- SymHull(diam(bx(i)) / 2.0);
     } 
     center = midVector ( bx );
 }
@@ -161,7 +161,7 @@ BOX Rescale(const BOX &bx, const double &factor)
   BOX result(SYSDIM);
 
   for (register short i = 1; i <= SYSDIM; i++)
-    result[ i ] = Center(bx[ i ]) + factor * Symm_Radius(bx[ i ]);
+    result( i ) = Center(bx( i )) + factor * Symm_Radius(bx( i ));
       
   return result;
 }
@@ -184,6 +184,7 @@ parcel Hull(const parcel &pcl_1, const parcel &pcl_2)
   // 'Hull(interval,interval)'
   result.box  = intervalHull(pcl_1.box,  pcl_2.box);
   result.time = intervalHull(pcl_1.time, pcl_2.time);
+  result.set  = doubleton(); // Neither set encloses the hull.
 #ifdef COMPUTE_C1
   result.angles = intervalHull(pcl_1.angles, pcl_2.angles);
   result.expansion = intervalHull(pcl_1.expansion, pcl_2.expansion);
@@ -206,7 +207,7 @@ ostream & operator << (ostream &out, const parcel &pcl)
     {
       if ( i != 1 )
 	out << "         ";
-      out << pcl.box[ i ] << "; dx = " << diam(pcl.box[ i ]) << endl;
+      out << pcl.box( i ) << "; dx = " << diam(pcl.box( i )) << endl;
     }
 #ifdef COMPUTE_C1
   interval angles = RAD_TO_DEG * pcl.angles;
@@ -232,46 +233,46 @@ double Inf ( const interval &iv )
     return iv . leftBound ();
 }
 
-// Returns an IVector containing the lower bounds of the IVector vec. as singletons. 
-DVector Inf ( const IVector &vec )
+// Returns a DVector containing the lower bounds of the BOX vec.
+DVector Inf ( const BOX &vec )
 {
   // fill infVec with the infima of vec. 
-    DVector infVec ( vec.dimension() );
-    for ( register short i = 0; i < vec.dimension(); i++ )
+    DVector infVec;
+    for ( register short i = 0; i < SYSDIM; i++ )
       {
 	infVec [ i ] = vec [ i ] . leftBound(); 
       }
     return infVec;
 }
 
-// Returns an IVector containing the lower bounds of the IVector vec. as singletons. 
-DVector Sup ( const IVector &vec )
+// Returns a DVector containing the upper bounds of the BOX vec.
+DVector Sup ( const BOX &vec )
 {
   // fill infVec with the suprema of vec. 
-    DVector supVec ( vec.dimension() );
-    for ( register short i = 0; i < vec.dimension(); i++ )
+    DVector supVec;
+    for ( register short i = 0; i < SYSDIM; i++ )
       {
 	supVec [ i ] = vec [ i ] . rightBound(); 
       }
     return supVec;
 }
 
+// The sum/difference/quotient of two doubles, rounded outwards.
 interval AddBounds ( const double &d1, const double &d2 )
 {
-    interval result = interval ( d1 + d2 );
+    interval result = interval ( d1 ) + d2;
     return result;
 }
 
 interval SubBounds ( const double &d1, const double &d2 )
 {
-    interval result = interval ( d1 - d2 );
+    interval result = interval ( d1 ) - d2;
     return result;
 }
 
-IVector SubBounds ( const DVector &iv1, const DVector &iv2 )
+BOX SubBounds ( const DVector &iv1, const DVector &iv2 )
 {
-    DVector result = iv1 - iv2;
-    IVector sb ( result );
+    BOX sb = BOX ( iv1 ) - BOX ( iv2 );
     return sb;
 }
 // To comply with overloaded PROFIL function Hull() which takes
@@ -284,12 +285,12 @@ interval Hull ( const double &d1, const double &d2 )
 
 interval Hull ( const interval &iv1, const interval &iv2 )
 {
-    return capd::intervals::intervalHull ( iv1, iv2 );
+    return intervalHull ( iv1, iv2 );
 }
 
 interval Hull ( const double &dbl, const interval &iv )
 {
-    return capd::intervals::intervalHull ( interval ( dbl ), iv );
+    return intervalHull ( interval ( dbl ), iv );
 }
 
 interval Hull ( const double &dbl )
@@ -347,8 +348,8 @@ double Mid ( const interval &iv )
 }
 
 
-// Intersection: IVector
-bool Intersection ( IVector &overlap, const IVector &x, const IVector &y )
+// Intersection: BOX
+bool Intersection ( BOX &overlap, const BOX &x, const BOX &y )
 {
     try
       {
@@ -374,28 +375,30 @@ double Diam ( const interval &iv )
 
 interval DivBounds ( const double &d1, const double &d2 )
 {
-    interval iv ( d1 / d2 );
+    interval iv = interval ( d1 ) / d2;
     return iv;
 }
 
-IVector DivBounds ( const DVector &dvec, const double &d )
+BOX DivBounds ( const DVector &dvec, const double &d )
 {
-    DVector vec_copy = dvec;
-    vec_copy /= d;
-    IVector ivec ( vec_copy ); 
+    BOX ivec;
+    for ( register short i = 1; i <= SYSDIM; ++i )
+      ivec ( i ) = interval ( dvec ( i ) ) / d;
     return ivec;
 }
 
 // Return column 'idx' of the matrix 'mat'
-IVector Col ( const IMatrix &mat, const int &idx )
+BOX Col ( const IMatrix &mat, const int &idx )
 {
-    IVector iv ( mat . column ( idx ) );
+    BOX iv;
+    for ( register int i = 1; i <= SYSDIM; ++i )
+      iv ( i ) = mat ( i, idx );
     return iv;
 }
 
-void SetCol ( IMatrix &mat, const int &col_num, const IVector &iv )
+void SetCol ( IMatrix &mat, const int &col_num, const BOX &iv )
 {
-    for ( register int i = 1; i <= mat.numberOfRows(); ++i )
-      mat ( i, col_num ) = iv [ i ];
+    for ( register int i = 1; i <= SYSDIM; ++i )
+      mat ( i, col_num ) = iv ( i );
 }
 ////////////////////////////////////////////////////////////////////
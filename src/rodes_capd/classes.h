@@ -9,8 +9,6 @@
 #ifndef CLASSES_H
 #define CLASSES_H
 
-#define DEBUG  1
-
 #include <iomanip>
 #include <iostream>
 #include <cmath>
@@ -38,12 +36,31 @@ const short  SYSDIM           = 3;
 #undef  COMPUTE_C1 // Comment out next line for topological mode.
 //#define COMPUTE_C1 
 
-// define interval vectors and matrices based on interval type
+// The interval arithmetic: CAPD's, or, with HOISTED_ROUNDING (defined
+// on the next line, or by 'make ROUNDING=up'), 'up_interval', which
+// sets the rounding upward once instead of for each operation.
+//#define HOISTED_ROUNDING
+
+#ifdef HOISTED_ROUNDING
+#include "up_interval.h"
+#endif
+
+// define interval vectors and matrices based on interval type.
+// The integrator only works in SYSDIM dimensions, so its vectors
+// (DVector, BOX) and matrices (IMatrix) have their size fixed at
+// compile time: CAPD keeps them on the stack, with no malloc/free
+// and no checks of the dimensions. IVector is sized at run time;
+// it is used for the 2-dimensional rectangles of the grids.
+#ifdef HOISTED_ROUNDING
+typedef up_interval DInterval;
+#else
 typedef capd::intervals::Interval< double > DInterval;
+#endif
 typedef DInterval interval;
-typedef capd::vectalg::Vector < double, 0 > DVector;
+typedef capd::vectalg::Vector < double, SYSDIM > DVector;
 typedef capd::vectalg::Vector < interval, 0 > IVector;
-typedef capd::vectalg::Matrix < interval, 0, 0 > IMatrix;
+typedef capd::vectalg::Vector < interval, SYSDIM > IBox;
+typedef capd::vectalg::Matrix < interval, SYSDIM, SYSDIM > IMatrix;
 ////////////////////////////////////////////////////////////////////
 
 const interval PI = interval::pi(); // jjb -- = Succ(Hull(Constant::Pi));
@@ -63,9 +80,9 @@ int      Sign           (const interval &);
 void     Show_Interval  (const interval &);
 
 ////////////////////////////////////////////////////////////////////
-// *** We define the BOX type here to be an IVector ***
+// *** We define the BOX type here to be an IBox ***
 //
-#define BOX IVector    // Shorthand
+#define BOX IBox       // Shorthand
 
 BOX  Center         (const BOX &);
 BOX  Radius         (const BOX &);
@@ -79,9 +96,9 @@ bool Subset         (const BOX &, const BOX    &);
 
 // Redefine some of the global CAPD functions to align with common functions in RODES
 double Sup          ( const interval & );
-DVector Sup         ( const IVector & ); // Sup for a BOX -- > similar to Inf
+DVector Sup         ( const BOX & ); // Sup for a BOX -- > similar to Inf
 double Inf          ( const interval & );
-DVector Inf         ( const IVector & ); // Inf for a BOX -- > returns a DVector of infima for each dimension
+DVector Inf         ( const BOX & ); // Inf for a BOX -- > returns a DVector of infima for each dimension
 double Mig          ( const interval & );
 double Abs          ( const interval & );
 double Max          ( const BOX & );
@@ -92,9 +109,9 @@ void Resize         ( BOX, int );
 // of v and w. (similar for SubBounds, etc.)
 interval AddBounds  ( const double &, const double & );
 interval SubBounds  ( const double &, const double & );
-IVector SubBounds   ( const DVector &, const DVector & );
+BOX SubBounds       ( const DVector &, const DVector & );
 interval DivBounds  ( const double &, const double & );
-IVector DivBounds   ( const DVector &, const double & );
+BOX DivBounds       ( const DVector &, const double & );
 interval Hull       ( const double &, const double & );
 interval Hull       ( const interval &, const interval & );
 interval Hull       ( const double &, const interval & );
@@ -104,13 +121,35 @@ bool Subset         ( const double &, const interval & );
 //bool Subset         ( const double &, const IMatrix & );
 interval Norm2      ( const BOX & );
 double Mid          ( const interval & );
-bool Intersection   ( IVector &, const IVector& , const IVector& );
+bool Intersection   ( BOX &, const BOX& , const BOX& );
 bool Intersection   ( IMatrix &, const IMatrix& , const IMatrix& );
 double Diam         ( const interval & );
-IVector Col         ( const IMatrix &, const int & );
-void SetCol         ( IMatrix &, const int &, const IVector & );
+BOX Col             ( const IMatrix &, const int & );
+void SetCol         ( IMatrix &, const int &, const BOX & );
 
 ////////////////////////////////////////////////////////////////////
+// The set of a parcel, kept (with 'rodes --lohner') in its plane as
+//   c + C * r0 + B * r,   r0 in the box it started from (about c),
+// see 'lohner.h'. C and B are point matrices, zero in the row and
+// column trvl. It is only used while the box of the parcel is still
+// 'hull', on the same plane.
+class doubleton
+{
+public:
+  doubleton() : trvl(0), sign(0) {}
+
+  BOX     c;      // The center; c(trvl) is the level.
+  IMatrix C;      // The change of coordinates of r0,...
+  BOX     r0;
+  IMatrix B;      // ...and of r, what the steps added.
+  BOX     r;
+  BOX     hull;   // The box of the parcel it encloses.
+  short   trvl;   // 0 when there is no set.
+  short   sign;
+};
+
+////////////////////////////////////////////////////////////////////
+
 class parcel
 {
 public:
@@ -123,6 +162,7 @@ public:
   short sign;                // the direction of the flow: - 1 or + 1
   interval time;             // The "time" variable   
   short message;             // Any message that needs to be passed on 
+  doubleton set;             // Only with 'rodes --lohner'.
   friend parcel Hull(const parcel &, const parcel &);
   friend ostream & operator << (ostream &, const parcel &);
 };
@@ -156,4 +196,35 @@ typedef struct          // The structure defining
 
 ////////////////////////////////////////////////////////////////////
 
+// The products of the integrator, written out for the fixed sizes:
+// the loops run to SYSDIM, a compile time constant, so the compiler
+// unrolls them, and no temporary vectors or matrices are made.
+
+// result = a + M * x
+inline void Mult_Add(BOX &result, const BOX &a, const IMatrix &M, const BOX &x)
+{
+  for ( short i = 1; i <= SYSDIM; i++ )
+    {
+      interval sum = a(i);
+      for ( short j = 1; j <= SYSDIM; j++ )
+	sum += M(i, j) * x(j);
+      result(i) = sum;
+    }
+}
+
+// result = A * B ('result' must be neither A nor B)
+inline void Mult(IMatrix &result, const IMatrix &A, const IMatrix &B)
+{
+  for ( short i = 1; i <= SYSDIM; i++ )
+    for ( short j = 1; j <= SYSDIM; j++ )
+      {
+	interval sum = A(i, 1) * B(1, j);
+	for ( short k = 2; k <= SYSDIM; k++ )
+	  sum += A(i, k) * B(k, j);
+	result(i, j) = sum;
+      }
+}
+
+////////////////////////////////////////////////////////////////////
+
 #endif // CLASSES_H
@@ -15,12 +15,12 @@
 // Calls to : 'none'
 void iterate_to_parcel(const iterate &it, parcel &pcl)
 {
-    BOX rect ( ndl_to_box( it.ndl ) );
+    IVector rect ( ndl_to_box( it.ndl ) );
 
-    interval irect[] = { rect [ 0 ], rect [ 1 ], interval ( 27., 27. ) };
-    IVector iv ( 3, irect );
     // fill the box and other parcel attributes
-    pcl.box = iv;
+    pcl.box[ 0 ] = rect [ 0 ];
+    pcl.box[ 1 ] = rect [ 1 ];
+    pcl.box[ 2 ] = interval ( 27., 27. );
     pcl.time = interval ( 0.0, 0.0 );
     pcl.trvl = 3; pcl.sign = -1; pcl.message = 0;
 #ifdef COMPUTE_C1
@@ -32,12 +32,12 @@ void iterate_to_parcel(const iterate &it, parcel &pcl)
 ////////////////////////////////////////////////////////////////////
 // Called by: 'get_the_flags', 'pcl_List_to_it_List'.
 // Calls to : 'none'
-void rect_to_it_List(const BOX &box, const int &thePower, List<iterate> &it_List)
+void rect_to_it_List(const IVector &box, const int &thePower, List<iterate> &it_List)
 {
   int i, j;
   int inf[2], sup[2];
   iterate it;
-  BOX rect = power(2, thePower) * box; 
+  IVector rect = interval( ldexp(1.0, thePower) ) * box; // 2^P, exactly.
 
   for ( i = 0; i < 2; i++ )
     {
@@ -75,54 +75,49 @@ void rect_to_it_List(const BOX &box, const int &thePower, List<iterate> &it_List
 void pcl_List_to_it_List(List<parcel> &Parcel_List, const int &power,
 			 List<iterate> &Iterate_List)
 {
-  parcel pcl;
-  BOX rect(2);
-  iterate it, cmp_it;
+  IVector rect(2);
   List<iterate> it_List, Redundant_List;  
   List<parcel>  Dummy_pcl_List;         // Just to shut the compiler up!
   
   First(Parcel_List);
   while( !Finished(Parcel_List) )
     { // Loop through all parcels.
-      pcl = Current(Parcel_List);
+      const parcel &pcl = Current(Parcel_List);
       rect(1) = pcl.box(1);
       rect(2) = pcl.box(2);
       rect_to_it_List(rect, power, it_List); // Gives it.ndl.c_stat == NOT_DONE, and
       while ( !IsEmpty(it_List) )            // it.inf_grd == it.sup_grd == NULL_GRID.
 	{
-	  it = First(it_List);
+	  iterate &it = First(it_List);
 #ifdef COMPUTE_C1
 	  it.ndl.ang = pcl.angles;
 	  it.ndl.pre_exp = Inf(pcl.expansion); // Inf(E_{i,j}).
 	  it.ndl.min_exp = LARGE_NUMBER; // The iterates are not known to be computed yet.
 #endif
 	  it.ndl.h_stat = HIT;  // The iterates are known to be hit.
-	  Redundant_List += it; 
-	  RemoveCurrent(it_List);
+	  MoveFirst(it_List, Redundant_List); 
 	}
       Next(Parcel_List);
     }
 
   // Loop through Redundant_List, and remove redundancies.
   while( !IsEmpty(Redundant_List) )
-    {  // Get the first it and remove it.
-      it = First(Redundant_List);
-      RemoveCurrent(Redundant_List);
+    {  // Move the first it to Iterate_List, where it is the hull of all
+       // iterates that represent the same grid.
+      MoveFirst(Redundant_List, Iterate_List);
+      iterate &it = Last(Iterate_List);
 
 // ADDED Jul 10, 2000 TO REMOVE ANNOYING OUTPUT.
 
       if( IsEmpty(Redundant_List) )
-        {
-          Iterate_List += it;        
-          break;
-        }
+	break;
 
 // END ADDED.
 	
       First(Redundant_List);
       while( !IsEmpty(Redundant_List) && !Finished(Redundant_List) )
 	{ 
-	  cmp_it = Current(Redundant_List); // Get the next it for comparison.
+	  const iterate &cmp_it = Current(Redundant_List); // Get the next it for comparison.
 	  if ( it.ndl.grd == cmp_it.ndl.grd ) // If they represent the same grid...
 	    {
 #ifdef COMPUTE_C1                             // ... we take their hull...
@@ -135,7 +130,6 @@ void pcl_List_to_it_List(List<parcel> &Parcel_List, const int &power,
 	  else
 	    Next(Redundant_List);
 	}
-      Iterate_List += it; // Save the hull of all iterates that represent the same grid.
     }
 }
 
@@ -173,3 +167,33 @@ void New_Get_Image_Hull(iterate &it, List<iterate> &Iterate_List)
 }
 
 ////////////////////////////////////////////////////////////////////
+// Called by: 'Reflect_pcl_List'.
+// Calls to : 'none'
+//
+// The Lorenz system is symmetric under (x, y, z) -> (-x, -y, z):
+// the image of the parcel under it. On the plane z = 27 (where the
+// returns are) a line keeps its angle, so 'angles' is left as it
+// is. The set of the parcel is not carried over.
+void Reflect_parcel(parcel &pcl)
+{
+  pcl.box(1) = - pcl.box(1);
+  pcl.box(2) = - pcl.box(2);
+  pcl.set = doubleton();
+}
+
+////////////////////////////////////////////////////////////////////
+// Called by: 'work_on_grid'.
+// Calls to : 'Reflect_parcel'
+void Reflect_pcl_List(List<parcel> &Parcel_List)
+{
+  if ( IsEmpty(Parcel_List) )
+    return;
+  First(Parcel_List);
+  while( !Finished(Parcel_List) )
+    {
+      Reflect_parcel(Current(Parcel_List));
+      Next(Parcel_List);
+    }
+}
+
+////////////////////////////////////////////////////////////////////
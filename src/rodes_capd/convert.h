@@ -19,10 +19,13 @@
 ////////////////////////////////////////////////////////////////////
 
 void iterate_to_parcel   (const iterate &, parcel    &);
-void rect_to_it_List     (const BOX     &, const int &, List<iterate> &);
+void rect_to_it_List     (const IVector &, const int &, List<iterate> &);
 void pcl_List_to_it_List (List<parcel>  &, const int &, List<iterate> &);
 void New_Get_Image_Hull  (iterate       &, List<iterate> &); // Both u and v.
 
+void Reflect_parcel      (parcel        &);  // (x, y, z) -> (-x, -y, z).
+void Reflect_pcl_List    (List<parcel>  &);
+
 ////////////////////////////////////////////////////////////////////
 
 #endif // CONVERT_H
@@ -0,0 +1,352 @@
+/*   File: coordinator.cc
+
+     The client side of the coordinator protocol,
+     together with the socket helpers shared with
+     the coordinator itself ('rodes_coord.cc').
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+
+#include <pthread.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "coordinator.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+// Every thread has its own connection, since a GET is not answered
+// until there is a grid (or none left); meanwhile the other threads
+// must be able to PUT.
+class connection
+{
+ public:
+  int fd;
+  std::string buffer; // Bytes received but not yet used.
+};
+
+static std::string    coord_socket;  // Set by 'coord_connect'.
+static std::string    coord_hello;   // Our HELLO line.
+static pthread_key_t  coord_key;
+static pthread_once_t coord_once = PTHREAD_ONCE_INIT;
+static volatile bool  coord_down = false; // Set by 'coord_lost'.
+
+static void         coord_lost        ();
+static void         delete_connection (void *);
+static void         create_key        ();
+static connection * this_connection   ();
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'coord_connect', 'main' (rodes_coord)
+// Calls to : none
+// Returns a socket bound to (listening == true) or connected
+// to (listening == false) the UNIX socket 'socket_name'.
+// Returns -1 on failure.
+int coord_open_socket(const char *socket_name, const bool &listening)
+{
+  struct sockaddr_un addr;
+
+  if ( strlen(socket_name) >= sizeof(addr.sun_path) )
+    return -1;
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if ( fd < 0 )
+    return -1;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, socket_name);
+
+  if ( listening )
+    {
+      unlink(socket_name); // Left behind by a previous coordinator.
+      if ( bind(fd, (struct sockaddr *) &addr, sizeof(addr)) != 0 ||
+	   listen(fd, SOMAXCONN) != 0 )
+	{
+	  close(fd);
+	  return -1;
+	}
+    }
+  else if ( connect(fd, (struct sockaddr *) &addr, sizeof(addr)) != 0 )
+    {
+      close(fd);
+      return -1;
+    }
+  return fd;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'coord_get_grid', 'coord_insert'
+// Calls to : none
+// Reads one line (without the newline) from fd into 'line'. Bytes
+// received beyond the line are kept in 'buffer'. Returns false if
+// the connection was closed before a full line arrived, or if
+// nothing arrived for 'timeout' seconds.
+bool coord_read_line(const int &fd, std::string &buffer, std::string &line,
+		     const int &timeout)
+{
+  char chunk[4096];
+  std::string::size_type end;
+
+  while ( (end = buffer.find('\n')) == std::string::npos )
+    {
+      struct pollfd pfd;
+      pfd.fd = fd;
+      pfd.events = POLLIN;
+      int ready = poll(&pfd, 1, 1000 * timeout);
+      if ( ready < 0 && errno == EINTR )
+	continue;
+      if ( ready <= 0 )
+	return false;
+
+      ssize_t n = read(fd, chunk, sizeof(chunk));
+      if ( n < 0 && errno == EINTR )
+	continue;
+      if ( n <= 0 )
+	return false;
+      buffer.append(chunk, n);
+    }
+  line = buffer.substr(0, end);
+  buffer.erase(0, end + 1);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'coord_get_grid', 'coord_insert', 'serve_client' (rodes_coord)
+// Calls to : none
+// Writes all of 'message' to fd. A failure here is fatal for the
+// clients; the coordinator ignores it (the client is gone anyway).
+void coord_write_all(const int &fd, const std::string &message)
+{
+  const char *p = message.data();
+  std::string::size_type left = message.size();
+
+  while ( left > 0 )
+    {
+      ssize_t n = write(fd, p, left);
+      if ( n < 0 && errno == EINTR )
+	continue;
+      if ( n <= 0 )
+	return;
+      p += n;
+      left -= n;
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main' (rodes_coord), 'leave_the_coordinator' (rodes)
+// Calls to : none
+// Gives back <shared_file>, if it is held as <shared_file>_coord by a
+// coordinator that has died (killed before it could give it back).
+// Returns false if a coordinator still alive holds it.
+bool coord_take_back(const char *shared_file)
+{
+  std::string held     = std::string(shared_file) + COORD_FILE_SUFFIX;
+  std::string pid_name = std::string(shared_file) + COORD_PID_SUFFIX;
+  pid_t pid = 0;
+
+  if ( access(shared_file, F_OK) == 0 || access(held.c_str(), F_OK) != 0 )
+    return true; // Not held.
+
+  std::ifstream InFile(pid_name.c_str(), ios::in);
+  if ( InFile >> pid && pid > 0 && (kill(pid, 0) == 0 || errno == EPERM) )
+    return false;
+  InFile.close();
+
+  if ( rename(held.c_str(), shared_file) != 0 )
+    return ( access(shared_file, F_OK) == 0 ); // Someone was faster.
+  unlink(pid_name.c_str());
+  cout << "Gave back " << shared_file << ", held by a lost coordinator."
+       << endl;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_the_flags' (rodes)
+// Calls to : 'this_connection', 'exit(1)'
+// Connects the calling thread as 'owner', which will resume the grids
+// in 'resumed'; the other threads connect when they first talk to
+// the coordinator.
+void coord_connect(const char *socket_name, const char *owner,
+		   List<grid> &resumed)
+{
+  std::ostringstream hello;
+
+  hello << "HELLO " << owner << " " << getpid() << " " << Length(resumed);
+  if ( !IsEmpty(resumed) )
+    for ( First(resumed); !Finished(resumed); Next(resumed) )
+      hello << "   " << Current(resumed);
+  hello << "\n";
+
+  coord_socket = socket_name;
+  coord_hello  = hello.str();
+  signal(SIGPIPE, SIG_IGN); // A lost coordinator must not kill us.
+  if ( this_connection() == NULL )
+    {
+      cout << "Error: coord_connect(" << coord_socket
+	   << ") failed: " << strerror(errno) << endl;
+      exit(1);
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_a_grid', 'insert_it_List' (rodes)
+// Calls to : none
+// False once the coordinator is lost: we then use the shared file.
+bool coord_up()
+{
+  return !coord_down;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'coord_get_grid', 'coord_insert'
+// Calls to : none
+static void coord_lost()
+{
+  if ( !coord_down )
+    cout << "Warning: lost the connection to the coordinator;"
+	 << " going on with the shared file." << endl;
+  coord_down = true;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: the system, when a thread exits.
+static void delete_connection(void *c)
+{
+  close(((connection *) c)->fd);
+  delete (connection *) c;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'pthread_once'
+static void create_key()
+{
+  pthread_key_create(&coord_key, delete_connection);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'coord_connect', 'coord_get_grid', 'coord_insert'
+// Calls to : 'coord_open_socket', 'coord_write_all'
+// Returns the connection of the calling thread, connecting it (and
+// saying HELLO) the first time; NULL if we cannot connect.
+static connection * this_connection()
+{
+  pthread_once(&coord_once, create_key);
+
+  connection *c = (connection *) pthread_getspecific(coord_key);
+  if ( c == NULL )
+    {
+      int fd = coord_open_socket(coord_socket.c_str(), false);
+      if ( fd < 0 )
+	return NULL;
+      c = new connection;
+      c->fd = fd;
+      pthread_setspecific(coord_key, c);
+      coord_write_all(c->fd, coord_hello);
+    }
+  return c;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_a_grid' (rodes)
+// Calls to : 'this_connection', 'coord_write_all', 'coord_read_line',
+//            'coord_lost'
+// The RPC version of 'find_fresh_grid'. The coordinator does not
+// answer until it has a grid for us, or knows that there are none
+// left, or COORD_HOLD seconds have passed (WAIT). If it is lost, we
+// return WAITING_FOR_ONE, and 'coord_up' tells the caller to look
+// in the shared file instead.
+find_result coord_get_grid(iterate &it)
+{
+  connection *c = ( coord_down ? NULL : this_connection() );
+  std::string line;
+
+  if ( c == NULL )
+    {
+      coord_lost();
+      return WAITING_FOR_ONE;
+    }
+  coord_write_all(c->fd, "GET\n");
+  if ( !coord_read_line(c->fd, c->buffer, line, COORD_TIMEOUT) )
+    {
+      coord_lost();
+      return WAITING_FOR_ONE;
+    }
+
+  if ( line.compare(0, 4, "GOT ") == 0 )
+    {
+      std::istringstream in(line.substr(4));
+      if ( !(in >> it) )
+	{
+	  coord_lost();
+	  return WAITING_FOR_ONE;
+	}
+      return GOT_ONE;
+    }
+  if ( line == "WAIT" )
+    return WAITING_FOR_ONE;
+  return NONE_LEFT;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'insert_it_List' (rodes)
+// Calls to : 'this_connection', 'coord_write_all', 'coord_read_line',
+//            'coord_lost'
+// The RPC version of 'insert_it_List'. Add_List is left unchanged.
+// Returns false if the coordinator is lost: the caller then inserts
+// Add_List into the shared file.
+bool coord_insert(List<iterate> &Add_List, const bool &external_input)
+{
+  connection *c = ( coord_down ? NULL : this_connection() );
+  std::ostringstream out;
+  std::string line;
+
+  if ( c == NULL )
+    {
+      coord_lost();
+      return false;
+    }
+
+  out << "PUT " << Length(Add_List) << " " << (external_input ? 1 : 0) << endl;
+  First(Add_List);
+  while( !Finished(Add_List) )
+    {
+      out << Current(Add_List) << endl;
+      Next(Add_List);
+    }
+  coord_write_all(c->fd, out.str());
+
+  if ( !coord_read_line(c->fd, c->buffer, line, COORD_TIMEOUT) || line != "OK" )
+    {
+      coord_lost();
+      return false;
+    }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
@@ -0,0 +1,82 @@
+/*   File: coordinator.h
+
+     The client side of the coordinator protocol. The
+     coordinator ('rodes_coord') keeps the table of
+     iterates in memory, and serves the 'rodes' processes
+     over a UNIX domain socket. All messages are single
+     lines of text, using the same format as the shared file:
+
+       HELLO <owner> <pid> <n> <grid> ... (n)   (no answer)
+       GET                      ->  GOT <iterate> | WAIT | NONE
+       PUT <n> <external>       ->  OK
+         <iterate> (n lines)
+
+     A connection starts with HELLO, giving the [proc_nr]
+     of the process: the grids it takes are leased to it
+     (see 'lease.h'), also in <shared_file>.leases. When
+     a process disconnects, its grids are given back if
+     its heartbeat has stopped; else, when it stops. A
+     new process (pid) of the same [proc_nr] gets back
+     the grids still leased to the last one, except the
+     n grids it resumes from its checkpoints. A GET
+     is held by the coordinator while other grids are
+     being done, until a PUT gives it a grid (or leaves
+     none to be done), but for at most COORD_HOLD seconds:
+     it is then answered WAIT, and asked again. Each
+     thread of a 'rodes' process has its own connection.
+
+     A process getting no answer within COORD_TIMEOUT
+     seconds takes the coordinator for lost, and goes on
+     with the shared file. The coordinator holds the file
+     as <shared_file>_coord, and writes its pid to
+     <shared_file>_coord.pid; when that pid has died, the
+     file is given back (see 'coord_take_back').
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#ifndef COORDINATOR_H
+#define COORDINATOR_H
+
+#include <string>
+
+#include "2d_classes.h"
+#include "list.h"
+#include "share_table.h"
+
+////////////////////////////////////////////////////////////////////
+
+// The default socket name is <shared_file> followed by this suffix.
+static const char COORD_SOCKET_SUFFIX[] = ".sock";
+
+// The coordinator holds <shared_file> under this suffix...
+static const char COORD_FILE_SUFFIX[] = "_coord";
+
+// ...and writes its pid to the file with this suffix.
+static const char COORD_PID_SUFFIX[] = "_coord.pid";
+
+const int COORD_HOLD    =  60; // A GET is answered within a minute...
+const int COORD_TIMEOUT = 300; // ...or after five, we give up.
+
+////////////////////////////////////////////////////////////////////
+
+int         coord_open_socket (const char *, const bool &);
+
+bool        coord_read_line   (const int &, std::string &, std::string &,
+			       const int &);
+
+void        coord_write_all   (const int &, const std::string &);
+
+bool        coord_take_back   (const char *);
+
+void        coord_connect     (const char *, const char *, List<grid> &);
+
+bool        coord_up          ();
+
+find_result coord_get_grid    (iterate &);
+
+bool        coord_insert      (List<iterate> &, const bool &);
+
+////////////////////////////////////////////////////////////////////
+
+#endif // COORDINATOR_H
@@ -0,0 +1,197 @@
+/*   File: cost.cc
+
+     Estimates of the time it takes to do a grid.
+     See 'cost.h'.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <ctime>
+
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "cost.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+static std::string     cost_name;           // Set by 'cost_open'.
+static int             grids[ZONES + 1];    // Observed, per zone,...
+static double          seconds[ZONES + 1];  // ...by all processes.
+static time_t          last_load = 0;
+static pthread_mutex_t cost_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int  lock_cost_file (const bool &);
+static void read_costs     (const int &);
+static void write_costs    (const int &);
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_the_flags' (rodes), 'main' (rodes_coord)
+// Calls to : none
+// Shares the observed times with the other processes using
+// 'shared_file'. Without it, only the a priori costs are used.
+void cost_open(const char *shared_file)
+{
+  pthread_mutex_lock(&cost_mutex);
+  cost_name = std::string(shared_file) + COST_SUFFIX;
+  last_load = 0;
+  pthread_mutex_unlock(&cost_mutex);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'work_on_grid' (rodes)
+// Calls to : 'lock_cost_file', 'read_costs', 'write_costs'
+// Records that the grid g took 'time' seconds.
+void cost_observe(const grid &g, const double &time)
+{
+  int zone = Get_Grid_Zone(g);
+
+  pthread_mutex_lock(&cost_mutex);
+  int fd = lock_cost_file(true);
+  if ( fd >= 0 )
+    {
+      read_costs(fd);
+      last_load = ::time(NULL);
+    }
+  grids[zone]++;
+  seconds[zone] += time;
+  if ( fd >= 0 )
+    {
+      write_costs(fd);
+      close(fd); // Also releases the lock.
+    }
+  pthread_mutex_unlock(&cost_mutex);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'take_fresh_grids' (share_table), 'map_take_fresh_grids'
+// Calls to : 'lock_cost_file', 'read_costs'
+// The estimated cost (seconds) of a grid in each zone. Until some
+// grid has been done, the a priori costs are used as they are.
+void cost_of_zones(double cost[ZONES + 1])
+{
+  pthread_mutex_lock(&cost_mutex);
+  if ( !cost_name.empty() && difftime(time(NULL), last_load) >= COST_RELOAD )
+    {
+      int fd = lock_cost_file(false);
+      if ( fd >= 0 )
+	{
+	  read_costs(fd);
+	  close(fd);
+	}
+      last_load = time(NULL);
+    }
+
+  // The seconds per unit of a priori cost, over all grids done.
+  double observed = 0.0, expected = 0.0;
+  for ( int zone = 1; zone <= ZONES; zone++ )
+    {
+      observed += seconds[zone];
+      expected += grids[zone] * Get_Zone_Parameters(zone).cost;
+    }
+  double scale = ( expected > 0.0 && observed > 0.0 ? observed / expected : 1.0 );
+
+  cost[0] = 0.0;
+  for ( int zone = 1; zone <= ZONES; zone++ )
+    {
+      double prior = scale * Get_Zone_Parameters(zone).cost;
+      cost[zone] = ( (seconds[zone] + COST_PRIOR_WEIGHT * prior) /
+		     (grids[zone] + COST_PRIOR_WEIGHT) );
+    }
+  pthread_mutex_unlock(&cost_mutex);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'cost_observe', 'cost_of_zones'
+// Calls to : none
+// Opens <shared_file>.cost, and locks it (for writing, if 'write').
+// Returns -1 if there is no such file to be had.
+static int lock_cost_file(const bool &write)
+{
+  if ( cost_name.empty() )
+    return -1;
+
+  int fd = open(cost_name.c_str(), write ? O_RDWR | O_CREAT : O_RDONLY, 0666);
+  if ( fd < 0 )
+    return -1;
+
+  struct flock fl;
+  fl.l_type   = ( write ? F_WRLCK : F_RDLCK );
+  fl.l_whence = SEEK_SET;
+  fl.l_start  = 0;
+  fl.l_len    = 0;
+  if ( fcntl(fd, F_SETLKW, &fl) < 0 )
+    {
+      close(fd);
+      return -1;
+    }
+  return fd;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'cost_observe', 'cost_of_zones'
+// Calls to : none
+// Replaces the observed times by those in the (locked) file.
+static void read_costs(const int &fd)
+{
+  char buffer[64 * (ZONES + 1)];
+  ssize_t n = pread(fd, buffer, sizeof(buffer) - 1, 0);
+
+  if ( n <= 0 )
+    return;
+  buffer[n] = '\0';
+
+  for ( int zone = 0; zone <= ZONES; zone++ )
+    {
+      grids[zone] = 0;
+      seconds[zone] = 0.0;
+    }
+
+  const char *line = buffer;
+  while ( line != NULL && *line != '\0' )
+    {
+      int zone, count;
+      double time;
+      if ( sscanf(line, "%d %d %lf", &zone, &count, &time) == 3 &&
+	   zone >= 1 && zone <= ZONES && count >= 0 && time >= 0.0 )
+	{
+	  grids[zone] = count;
+	  seconds[zone] = time;
+	}
+      line = strchr(line, '\n');
+      if ( line != NULL )
+	line++;
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'cost_observe'
+// Calls to : none
+static void write_costs(const int &fd)
+{
+  std::string text;
+  char line[64];
+
+  for ( int zone = 1; zone <= ZONES; zone++ )
+    {
+      snprintf(line, sizeof(line), "%d %d %.3f\n", zone, grids[zone], seconds[zone]);
+      text += line;
+    }
+  if ( ftruncate(fd, 0) != 0 ||
+       pwrite(fd, text.data(), text.size(), 0) != (ssize_t) text.size() )
+    cout << "Warning: could not write " << cost_name << endl;
+}
+
+////////////////////////////////////////////////////////////////////
@@ -0,0 +1,45 @@
+/*   File: cost.h
+
+     Estimates of the time it takes to do a grid, used
+     for taking the expensive grids first, so that they
+     are not left for the end of the run.
+
+     The estimate for a zone (see 'zone.h') starts out
+     as its a priori cost, and moves towards the mean
+     of the observed times as grids of the zone are
+     done. The observed times are shared by all the
+     processes through the file <shared_file>.cost,
+     holding a line "<zone> <grids> <seconds>" per zone.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#ifndef COST_H
+#define COST_H
+
+#include "2d_classes.h"
+#include "zone.h"
+
+////////////////////////////////////////////////////////////////////
+
+// The costs of <shared_file> are kept in <shared_file> followed by
+// this suffix.
+static const char COST_SUFFIX[] = ".cost";
+
+// The a priori cost of a zone counts as this many observed grids.
+const int COST_PRIOR_WEIGHT = 5;
+
+// Read the observed times again after this many seconds.
+const int COST_RELOAD = 60;
+
+////////////////////////////////////////////////////////////////////
+
+void   cost_open     (const char *);
+
+void   cost_observe  (const grid &, const double &);
+
+void   cost_of_zones (double [ZONES + 1]);
+
+////////////////////////////////////////////////////////////////////
+
+#endif // COST_H
@@ -454,7 +454,7 @@ double Flow_Along(const iterate &f_1_it, List<iterate> &F_0_List,
   double min_acc_exp = Machine::PosInfinity;
   double min_exp;
   grid inf_grd, sup_grd;
-  BOX rect(2);
+  IVector rect(2);
   iterate it;
   List<iterate> Iterate_List, Image_List;
  
@@ -9,6 +9,7 @@
 */
 
 #include "fixed_point.h"
+#include "workspace.h"
 
 // Parameters defining the cube.
 static const double CUBE_RADIUS = 0.1;
@@ -22,7 +23,7 @@ static const interval NU = - E3_IV / E1_IV;
 // For logarithm change of base since CAPD intervals only have natural
 // log. leftBound() to get a double.
 static const double LOG10 = 
-    capd::intervals::log ( interval( 10. ) ).leftBound();
+    log ( interval( 10. ) ).leftBound();
 
 ////////////////////////////////////////////////////////////////////
 
@@ -79,12 +80,10 @@ static void Divide(List<parcel> &In_List, List<parcel> &Result_List,
 {
   List<parcel> dummy_List;
 
-  parcel cur_pcl;
   First(In_List);
   while ( !Finished(In_List) )
     {
-      cur_pcl = Current(In_List);
-      Divide(cur_pcl, Result_List, max_size, N);
+      Divide(Current(In_List), Result_List, max_size, N);
       Next(In_List);
     }
 }
@@ -94,17 +93,13 @@ static void Divide(List<parcel> &In_List, List<parcel> &Result_List,
 // Called by: 'Cube_Exit'.
 // Calls to : 'Deform'.
 // Returns a list of enclosures of the deformed incoming parcels.
+// They are deformed in place, and moved from In_List (emptied).
 static void Widen_via_entrance(List<parcel> &In_List, List<parcel> &Result_List)
 {
-  parcel cur_pcl;
-
-  First(In_List);
-  while ( !Finished(In_List) )
+  while ( !IsEmpty(In_List) )
     {
-      cur_pcl = Current(In_List);
-      Deform(cur_pcl);
-      Result_List += cur_pcl;
-      Next(In_List);
+      Deform(First(In_List));
+      MoveFirst(In_List, Result_List);
     }
 }
 
@@ -112,33 +107,29 @@ static void Widen_via_entrance(List<parcel> &In_List, List<parcel> &Result_List)
 
 // Called by: 'Cube_Exit'.
 // Calls to : none.
+// The parcels are moved from In_List (emptied); the left half of a
+// split one is the parcel itself.
 static void Check_for_splittings(List<parcel> &In_List, List<parcel> &Result_List)
 {
-  parcel cur_pcl;
-
-  First(In_List);
-  while ( !Finished(In_List) )
+  while ( !IsEmpty(In_List) )
     {
-      cur_pcl = Current(In_List);
+      parcel &cur_pcl = First(In_List);
       // Subset is defined in classes.cc using overloaded comparison
       // operators.
       if ( Subset( 0.0, cur_pcl.box(1) ) )
 	{
-	  parcel left_pcl  = cur_pcl;
 	  parcel right_pcl = cur_pcl;
 	  
 	  // jjb -- It seems that the only reason to use "Hull" here
 	  // in the orginal was so it returned an interval (convex
 	  // hull of two reals).
-	  left_pcl.box(1)  = interval( Inf ( cur_pcl.box ( 1 ) ), 0.0 );
 	  right_pcl.box(1) = interval( 0.0, Sup ( cur_pcl.box ( 1 ) ) );
-	  Result_List += left_pcl;
+	  cur_pcl.box(1)   = interval( Inf ( cur_pcl.box ( 1 ) ), 0.0 );
+	  MoveFirst(In_List, Result_List);
 	  Result_List += right_pcl;
 	}
       else
-	Result_List += cur_pcl;
-
-      Next(In_List);
+	MoveFirst(In_List, Result_List);
     }
 }
 
@@ -211,7 +202,7 @@ static void Compute_single_exit(const parcel &in_pcl, List<parcel> &Result_List)
       // interval::log is natrual log, so to be consistent we convert
       // to base 10. (See def'n of LOG10 above.
       double small_time = Inf(- 1.0 / E1_IV 
-			      * ( capd::intervals::log ( max_x_over_r ) / LOG10 ) ); 
+			      * ( log ( max_x_over_r ) / LOG10 ) ); 
       result.time += interval ( small_time, 
 				100000. );
 #ifdef COMPUTE_C1
@@ -229,7 +220,7 @@ static void Compute_single_exit(const parcel &in_pcl, List<parcel> &Result_List)
   else // No splitting.
     {    
       result.time += - 1.0 / E1_IV 
-	* ( capd::intervals::log ( abs_x_over_exit_rad ) / LOG10 );
+	* ( log ( abs_x_over_exit_rad ) / LOG10 );
 #ifdef COMPUTE_C1
       IMatrix P_M(SYSDIM, SYSDIM);  Clear(P_M); // Poincare map matrix.
 
@@ -251,19 +242,15 @@ static void Compute_single_exit(const parcel &in_pcl, List<parcel> &Result_List)
 // Called by: 'Cube_Exit'.
 // Calls to : 'Deform'.
 // Computes enclosures of all deformed outgoing elements 
-// of In_List, which are appended to Result_List.
+// of In_List, which are moved (deformed in place) to Result_List.
 static void Widen_via_exit(List<parcel> &In_List, List<parcel> &Result_List)
 {
-  parcel current_pcl;
   List<parcel> DummyList;            // Added to shut the compiler up!
 
-  First(In_List);
-  while ( !Finished(In_List) )
+  while ( !IsEmpty(In_List) )
     {
-      current_pcl = Current(In_List);
-      Deform(current_pcl);
-      Result_List += current_pcl;
-      Next(In_List);
+      Deform(First(In_List));
+      MoveFirst(In_List, Result_List);
     }
 }
 
@@ -275,13 +262,12 @@ static void Widen_via_exit(List<parcel> &In_List, List<parcel> &Result_List)
 static void Flatten_Parcels(List<parcel> &Lumpy_List, List<parcel> &Flat_List, const double &max_size)
 {
   List<parcel> Start_List, Image_List;
-  parcel current_pcl;
   stop_parameters stop_pmtr; 
 
   First(Lumpy_List);
   while ( !Finished(Lumpy_List) )
     { // Work through Lumpy_List
-      current_pcl = Current(Lumpy_List);
+      const parcel &current_pcl = Current(Lumpy_List);
       stop_pmtr.max_d_step = 
 	0.5 * diam( current_pcl.box( 1 ) ).leftBound(); // Set the stop parameters
       stop_pmtr.trvl  = current_pcl.trvl;
@@ -296,14 +282,9 @@ static void Flatten_Parcels(List<parcel> &Lumpy_List, List<parcel> &Flat_List, c
       Divide(current_pcl, Start_List, max_size, 1);
       while ( !IsEmpty(Start_List) )
 	{ // Work through Start_List, and delete it.
-	  current_pcl = First(Start_List);
-	  RemoveCurrent(Start_List);
-	  Local_Flow_The_Parcel(current_pcl, Image_List, stop_pmtr, max_size); // ADDED JUNE 5, 2000
-	  while ( !IsEmpty(Image_List) )                       
-	    { // Work through Image_List, and delete it.    
-	      Flat_List += First(Image_List);
-	      RemoveCurrent(Image_List);
-	    }
+	  Local_Flow_The_Parcel(First(Start_List), Image_List, stop_pmtr, max_size); // ADDED JUNE 5, 2000
+	  --Start_List;
+	  Append(Flat_List, Image_List); // Image_List is emptied.
 	}
       Next(Lumpy_List);
     }
@@ -315,13 +296,10 @@ static void Flatten_Parcels(List<parcel> &Lumpy_List, List<parcel> &Flat_List, c
 // Calls to : 'Compute_single_exit'. 
 static void Compute_exits(List<parcel> &In_List, List<parcel> &Result_List)
 {
-  parcel cur_pcl;
-  
   First(In_List);
   while ( !Finished(In_List) )
     {
-      cur_pcl = Current(In_List);
-      Compute_single_exit(cur_pcl, Result_List);
+      Compute_single_exit(Current(In_List), Result_List);
       Next(In_List);
     }
 }
@@ -335,6 +313,8 @@ static void Compute_exits(List<parcel> &In_List, List<parcel> &Result_List)
 // Adds the image(s) to the end of the list Image_List.
 void Cube_Exit(const parcel &pcl, List<parcel> &Image_List, const double &max_size)
 {
+    Thread_Workspace().stats.cube_exits++;
+
     parcel hull_pcl;
     hull_pcl.box ( SYSDIM );
     List<parcel> Split_List, Widened_List;
@@ -365,14 +345,10 @@ void Cube_Exit(const parcel &pcl, List<parcel> &Image_List, const double &max_si
   // Now append Flat_List to Image_List.
   // After debugging remove the code below,
   // and call Flatten_Parcels(Lumpy_List, Image_List).
-  parcel cur_pcl;
-  First(Flat_List);
   while ( !IsEmpty(Flat_List) )
-    { // Work through Flat_List and remove its contents.
-      cur_pcl = Current(Flat_List);
-      cur_pcl.message = 0;
-      Image_List += cur_pcl;
-      RemoveCurrent(Flat_List);
+    { // Work through Flat_List and move its contents.
+      First(Flat_List).message = 0;
+      MoveFirst(Flat_List, Image_List);
     }
 }
 
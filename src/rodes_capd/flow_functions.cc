@@ -7,6 +7,8 @@
 */
 #include "classes.h"
 #include "flow_functions.h"
+#include "workspace.h"
+#include "trace.h"
 
 static const short SWITCH_TRVL_ITERATES = 2;
 
@@ -18,12 +20,6 @@ static const short SWITCH_TRVL_ITERATES = 2;
 void Switch_Transversal(parcel &pcl, const short &trvl, const BOX &Switch_Box)
 {
     short new_trvl = abs(trvl); // account for 0-index in BOX/IVector indexing
-    
-    #ifdef DEBUG
-    cout << endl;
-    cout << "trvl = " << new_trvl << endl << endl;
-    #endif
- 
     short new_sign = Sign(trvl);
     interval time;
     BOX vf(SYSDIM);
@@ -33,6 +29,7 @@ void Switch_Transversal(parcel &pcl, const short &trvl, const BOX &Switch_Box)
 
     result.trvl = new_trvl;  
     result.sign = new_sign;
+    TRACE(1, TRACE_SWITCH, result, pcl.box, new_sign, 0.0);
 
   for ( register short j = 1; j <= SWITCH_TRVL_ITERATES; j++ ) // No point in doing
     {                                                          // more than a few laps.
@@ -86,49 +83,6 @@ void Switch_Transversal(parcel &pcl, const short &trvl, const BOX &Switch_Box)
 
 ////////////////////////////////////////////////////////////////////
 
-// Called by 'Work_Through_PSin', 'Test_Switch_Transversal' or 'Flow'.
-// Splits the 'BOX' of pcl into smaller pieces; a side is halved if
-// it is longer than 'size'. The result is passed via 'PSin'.
-void Single_Partition(const parcel &pcl, List<parcel> &PSin, const double &size)
-{
-    register int i, j;                    // Basic counters  
-    int nr = 1;                           // Current number of BOXes
-    double dx;                            // diam/radius of pcl.box(i)
-    //    BOX bx ( POWER );                        // Storage for the BOXes
-    BOX *bx = new ( SYSDIM ) IVector[ POWER ];
-
-    bx[0] = pcl.box;  // Initialize 
-
-  for(i = 1; i <= SYSDIM; i++)
-    if ( i != pcl.trvl )
-      {
-	dx = Sup(pcl.box[i]) - Inf(pcl.box[i]);
-	if ( dx > size )      // Check if splitting is necessary
-	  {
-	    dx /= 2.0;
-	    for(j = 0; j < nr; j++)
-	      { // Split in two
-		bx[nr + j] = bx[j];
-		// this is a particular interval referenced at bx[][]
-		bx[nr + j][i] = interval( Inf( bx[nr + j][i] ) + dx, 
-					      Sup( bx[nr + j][i] ) );
-		bx[j][i] = interval( Inf( bx[j][i] ), 
-				     Inf( bx[nr + j][i] ) );
-	      }
-	    nr += nr; // There are twice as many boxes now.
-	  }
-      }
-
-  parcel tmp_pcl = pcl;     // Temporary storage.
-  for(j = 0; j < nr; j++)   // Now we return the partitioned boxes.
-    {
-      tmp_pcl.box = bx[j];
-      PSin += tmp_pcl; 
-    }
-}
-
-////////////////////////////////////////////////////////////////////
-
 // Called by 'main' and 'Update_Transversal'.
 // Returns the hull of all parcels in PSdone
 void Get_Hull(parcel &hull_pcl, List<parcel> &pcl_List)
@@ -196,8 +150,9 @@ void Get_DPi_Matrix(IMatrix &DPi, const BOX &Outer_Box,
 // and finally return (by reference) 
 //   time = dx/Inf(Abs(vf(Outer_Box)))(trvl).
 // If a close return becomes a true return, we modify 'pcl.message'.
-void Get_Flow_Time(interval &time, parcel &pcl, const double &trvl_dist,
-		   BOX &Outer_Box)
+// Returns dx, which is less than 'trvl_dist' if the step was clipped.
+double Get_Flow_Time(interval &time, parcel &pcl, const double &trvl_dist,
+		     BOX &Outer_Box)
 {
     register short i;
     double temp_time;
@@ -207,10 +162,7 @@ void Get_Flow_Time(interval &time, parcel &pcl, const double &trvl_dist,
     Vf_Range(vf, Outer_Box);
     double min_time = 1e10; //Machine::PosInfinity; // A huge initial guess.
 
-    cout << endl;
-    cout << "In Get_Flow_Time()" << endl;
-    cout << "  min time = " << min_time << endl;
-    cout << "  OB = " << Outer_Box << endl;
+    TRACE(2, TRACE_OUTER_BOX, pcl, Outer_Box, trvl_dist, 0.0);
 
     for ( i = 1; i <= SYSDIM; i++ )  // Find the first time any point of Inner_Box hits  
       if ( i != pcl.trvl )        // a non-transversal boundary of Outer_Box.
@@ -240,7 +192,8 @@ void Get_Flow_Time(interval &time, parcel &pcl, const double &trvl_dist,
 						      interval ( level ) );
 	  }
 
-	cout << "  second OB = " << Outer_Box << endl;
+	TRACE(2, TRACE_TRIMMED_BOX, pcl, Outer_Box, trvl_dx, min_time);
+	Thread_Workspace().stats.clipped_steps++;
 
 	// Recompute the vector field. Compute the flow times required
 	// for all points in Inner_Box to flow through Outer_Box in
@@ -268,6 +221,7 @@ void Get_Flow_Time(interval &time, parcel &pcl, const double &trvl_dist,
   time = trvl_dx / Vf_Range(Outer_Box, pcl.trvl);  // Tighten time.
   if ( pcl.sign == - 1 )
     time = - time;
+  return trvl_dx;
 }
 
 ////////////////////////////////////////////////////////////////////
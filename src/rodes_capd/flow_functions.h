@@ -23,14 +23,12 @@ enum MESSAGE_CODE { OK, TOO_LARGE, CLOSE_STOP, STOP, PARTITION };
 
 void Switch_Transversal   (parcel &, const short &, const BOX &);
 
-void Single_Partition     (const parcel &, List<parcel> &, const double &);
-
 void Get_Hull             (parcel &, List<parcel> &);
 
 void Get_DPi_Matrix       (IMatrix &, const BOX &, const short &, 
 			   const interval &, const BOX &);
 
-void Get_Flow_Time        (interval &, parcel &, const double &, BOX &);
+double Get_Flow_Time      (interval &, parcel &, const double &, BOX &);
 
 void Flow_Tangent_Vectors (parcel &, const short &, const short &, 
 			   const IMatrix &);
@@ -0,0 +1,245 @@
+/*   File: flow_pool.cc
+
+     Flows the parcels of one grid on several threads.
+     See 'flow_pool.h'.
+
+     A parcel takes far longer to flow than to queue, so
+     one mutex guards all of the queues.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <time.h>
+
+#include "flow_pool.h"
+#include "workspace.h"
+
+////////////////////////////////////////////////////////////////////
+
+// What 'flow_pool::in_thread' needs to know.
+typedef struct
+{
+  flow_pool             *pool;
+  int                    index;  // 1,..., threads - 1.
+  const stop_parameters *sp;
+} pool_args;
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'Flow_The_Parcel' (return_map)
+// Calls to : none
+// A pool of 'nr_threads' threads (the calling one included), each
+// flowing parcels with 'flow'. The 'flow_context' is passed on.
+flow_pool::flow_pool(const int &nr_threads, flow_step flow, void *flow_context)
+  : threads(nr_threads), step(flow), context(flow_context),
+    queues(nr_threads), stats(nr_threads), returns(NULL),
+    queued(0), running(0), peak(0), paused(false), failed(false)
+{
+  pthread_mutex_init(&mutex, NULL);
+  pthread_cond_init(&changed, NULL);
+}
+
+////////////////////////////////////////////////////////////////////
+
+flow_pool::~flow_pool()
+{
+  pthread_cond_destroy(&changed);
+  pthread_mutex_destroy(&mutex);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'Flow_The_Parcel' (return_map)
+// Calls to : 'in_thread' (via 'pthread_create'), 'work', 'grid_stats::add'
+// Flows the parcels of In_List (which is emptied) until all of them
+// have returned; the returns are added to Return_List. The calling
+// thread works as well, and writes the checkpoints to 'ckpt' (unless
+// NULL). If a parcel could not be flowed, the other threads stop, and
+// the error is thrown again here.
+void flow_pool::run(List<parcel> &In_List, List<parcel> &Return_List,
+		    const stop_parameters &sp, checkpoint *ckpt)
+{
+  // Deal the parcels out, so that every thread starts with some.
+  for ( int n = 0; !IsEmpty(In_List); n++ )
+    {
+      queues[n % threads].push_back(First(In_List));
+      RemoveCurrent(In_List);
+      queued++;
+    }
+  peak     = queued;
+  returns  = &Return_List;
+  running  = 0;
+  failed   = false;
+
+  std::vector<pthread_t> ids(threads);
+  std::vector<pool_args> args(threads);
+  int started = 1;
+  for ( ; started < threads; started++ )
+    {
+      args[started].pool  = this;
+      args[started].index = started;
+      args[started].sp    = &sp;
+      if ( pthread_create(&ids[started], NULL, in_thread, &args[started]) != 0 )
+	{ // We do with the threads we have.
+	  cout << "Warning: could only start " << started
+	       << " threads to flow the parcels." << endl;
+	  break;
+	}
+    }
+
+  work(0, sp, ckpt);
+  for ( int i = 1; i < started; i++ )
+    pthread_join(ids[i], NULL);
+
+  workspace &ws = Thread_Workspace();
+  for ( int i = 1; i < started; i++ )
+    ws.stats.add(stats[i]);
+  ws.stats.note_peak(peak);
+
+  for ( int i = 0; i < threads; i++ )
+    queues[i].clear();
+  queued = 0;
+  returns = NULL;
+  if ( failed )
+    throw error;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'run' (via 'pthread_create')
+// Calls to : 'work', 'Trace_Flush'
+// A thread helping the calling thread of 'run'. Its counts and CPU
+// time are kept for 'run', and its trace written, since its workspace
+// goes with the thread.
+void * flow_pool::in_thread(void *arg)
+{
+  pool_args *args = (pool_args *) arg;
+  flow_pool *pool = args->pool;
+  struct timespec cpu;
+
+  Thread_Workspace().stats.clear();
+  pool->work(args->index, *args->sp, NULL);
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+  Thread_Workspace().stats.cpu = cpu.tv_sec + 1e-9 * cpu.tv_nsec;
+  pool->stats[args->index] = Thread_Workspace().stats;
+  Trace_Flush();
+  return NULL;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'work'
+// Calls to : none
+// Takes the parcel thread 'index' queued last or, if its queue is
+// empty, the one queued first by another thread. The mutex is locked.
+bool flow_pool::take(const int &index, parcel &pcl)
+{
+  if ( !queues[index].empty() )
+    {
+      pcl = queues[index].back();
+      queues[index].pop_back();
+      queued--;
+      return true;
+    }
+  for ( int k = 1; k < threads; k++ )
+    {
+      std::deque<parcel> &victim = queues[(index + k) % threads];
+      if ( !victim.empty() )
+	{
+	  pcl = victim.front();
+	  victim.pop_front();
+	  queued--;
+	  return true;
+	}
+    }
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'run', 'in_thread'
+// Calls to : 'take', 'pause', 'step'
+// The loop of each thread: flows parcels until no parcel is queued,
+// and no other thread is flowing one (which could give more).
+void flow_pool::work(const int &index, const stop_parameters &sp, checkpoint *ckpt)
+{
+  parcel pcl;
+
+  pthread_mutex_lock(&mutex);
+  while ( !failed )
+    {
+      if ( ckpt != NULL && ckpt->due() )
+	pause(sp, ckpt);
+      while ( paused )
+	pthread_cond_wait(&changed, &mutex);
+      if ( failed )
+	break;
+      if ( !take(index, pcl) )
+	{
+	  if ( running == 0 ) // We are done.
+	    break;
+	  pthread_cond_wait(&changed, &mutex);
+	  continue;
+	}
+      running++;
+      pthread_mutex_unlock(&mutex);
+
+      List<parcel> More_List, Found_List;
+      bool ok = true;
+      Error_Handler thrown;
+      try
+	{
+	  step(pcl, More_List, Found_List, context);
+	}
+      catch ( Error_Handler err )
+	{
+	  thrown = err;
+	  ok = false;
+	}
+
+      pthread_mutex_lock(&mutex);
+      running--;
+      if ( !ok && !failed )
+	{
+	  failed = true;
+	  error  = thrown;
+	}
+      while ( !IsEmpty(More_List) )
+	{
+	  queues[index].push_back(First(More_List));
+	  RemoveCurrent(More_List);
+	  queued++;
+	}
+      Append(*returns, Found_List);
+      if ( queued > peak )
+	peak = queued;
+      pthread_cond_broadcast(&changed);
+    }
+  pthread_cond_broadcast(&changed); // Wake the others: we are done.
+  pthread_mutex_unlock(&mutex);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'work'
+// Calls to : 'checkpoint::write'
+// Stops the other threads once they are between two parcels, and
+// writes all the parcels queued and the returns found so far. The
+// mutex is locked.
+void flow_pool::pause(const stop_parameters &sp, checkpoint *ckpt)
+{
+  paused = true;
+  while ( running > 0 )
+    pthread_cond_wait(&changed, &mutex);
+
+  List<parcel> In_List;
+  for ( int i = 0; i < threads; i++ )
+    for ( unsigned k = 0; k < queues[i].size(); k++ )
+      In_List += queues[i][k];
+  ckpt->write(sp, In_List, *returns);
+
+  paused = false;
+  pthread_cond_broadcast(&changed);
+}
+
+////////////////////////////////////////////////////////////////////
@@ -0,0 +1,78 @@
+/*   File: flow_pool.h
+
+     Flows the parcels of one grid on several threads.
+     Every parcel taken from the list of parcels to flow
+     is independent of the others: it is flowed until it
+     returns, or is split (or switches transversal, or
+     enters the cube at the origin), and the pieces are
+     put back in the list. Here each thread keeps its own
+     queue of parcels: it flows the last one it put there
+     (depth first), and when its queue is empty it steals
+     the oldest parcel of another thread (the largest
+     piece of work left).
+
+     The order in which the returns are found depends on
+     the threads; 'Compute_the_return' sorts them.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#ifndef FLOW_POOL_H
+#define FLOW_POOL_H
+
+#include <deque>
+#include <vector>
+
+#include <pthread.h>
+
+#include "checkpoint.h"
+#include "classes.h"
+#include "error_handler.h"
+#include "list.h"
+#include "telemetry.h"
+
+////////////////////////////////////////////////////////////////////
+
+// Flows one parcel (in place): the pieces still to flow go to the
+// first list, the returns to the second one. The last argument is
+// passed on from 'flow_pool::run'.
+typedef void (*flow_step) (parcel &, List<parcel> &, List<parcel> &, void *);
+
+////////////////////////////////////////////////////////////////////
+
+class flow_pool
+{
+ public:
+  flow_pool(const int &, flow_step, void *);
+  ~flow_pool();
+
+  void run (List<parcel> &, List<parcel> &, const stop_parameters &, checkpoint *);
+
+ private:
+  static void * in_thread (void *);
+
+  bool take  (const int &, parcel &);
+  void work  (const int &, const stop_parameters &, checkpoint *);
+  void pause (const stop_parameters &, checkpoint *);
+
+  int       threads;
+  flow_step step;
+  void     *context;
+
+  pthread_mutex_t mutex;    // Guards all of the below.
+  pthread_cond_t  changed;  // Parcels were queued, or flowed.
+
+  std::vector< std::deque<parcel> > queues; // One per thread.
+  std::vector<grid_stats> stats;            // The counts of each thread.
+  List<parcel>  *returns;
+  int            queued;    // The parcels in all of the queues,...
+  int            running;   // ...and the ones being flowed.
+  int            peak;      // The most parcels queued at once.
+  bool           paused;    // Set while a checkpoint is written.
+  bool           failed;    // Set by the first error,...
+  Error_Handler  error;     // ...which is thrown again by 'run'.
+};
+
+////////////////////////////////////////////////////////////////////
+
+#endif // FLOW_POOL_H
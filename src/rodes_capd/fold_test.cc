@@ -0,0 +1,159 @@
+/*   File: fold_test.cc
+
+     Checks that images of a grid not yet in the shared
+     file are folded into a single iterate when they are
+     merged (see 'merge_it_List' in 'share_table.cc'),
+     both with the text file and with the binary one
+     ('map_merge_it_List').
+
+     The file holds one grid, DONE. The images of a grid
+     are merged in: that grid, twice more, its reflection
+     (-u, -v), and another grid, twice. The file must
+     then hold the DONE grid, and one iterate for each of
+     the other two, as the first image gave it: (u, v),
+     not (-u, -v). (Before, each of these images was
+     appended.)
+
+     Usage: fold_test [directory]  (default /tmp)
+
+     Compilation: make fold_test
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+#include "2d_classes.h"
+#include "classes.h"
+#include "list.h"
+#include "share_map.h"
+#include "share_table.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+static iterate make_iterate (const int &, const int &, const short &);
+static void    seed         (List<iterate> &);
+static void    images       (List<iterate> &);
+static bool    check        (List<iterate> &);
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: none
+// Calls to : 'seed', 'images', 'merge_it_List', 'map_write_it_List',
+//            'map_open', 'map_merge_it_List', 'map_close',
+//            'map_read_it_List', 'check'
+int main(int argc, char *argv[])
+{
+  std::ostringstream name;
+  name << ( argc == 2 ? argv[1] : "/tmp" ) << "/fold_test_" << getpid();
+  const std::string map_name = name.str();
+
+  List<iterate> Table, Add_List;
+  seed(Table);
+  images(Add_List);
+  merge_it_List(Table, Add_List, false);
+  bool text = check(Table);
+
+  List<iterate> Map_List;
+  seed(Map_List);
+  map_write_it_List(map_name.c_str(), Map_List);
+  images(Add_List);
+  map_open(map_name.c_str());
+  map_merge_it_List(Add_List, false);
+  map_close();
+  List<iterate> Read_List;
+  map_read_it_List(map_name.c_str(), Read_List);
+  bool binary = check(Read_List);
+  unlink(map_name.c_str());
+
+  cout << "text file:   " << (text ? "ok" : "FAILED") << endl;
+  cout << "binary file: " << (binary ? "ok" : "FAILED") << endl;
+  return ( text && binary ? 0 : 1 );
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'seed', 'images'
+static iterate make_iterate(const int &u, const int &v, const short &c_stat)
+{
+  iterate it;
+
+  it.ndl.grd.u = u;
+  it.ndl.grd.v = v;
+  it.ndl.grd.P = 8;
+#ifdef COMPUTE_C1
+  it.ndl.ang = DEG_TO_RAD * Hull(0.0, 10.0);
+  it.ndl.pre_exp = LARGE_NUMBER;
+  it.ndl.min_exp = LARGE_NUMBER;
+#endif
+  it.ndl.c_stat = c_stat;
+  it.ndl.h_stat = HIT;
+  it.inf_grd = NULL_GRID;
+  it.sup_grd = NULL_GRID;
+  return it;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main'
+// The shared file: the grid (1, 1), done.
+static void seed(List<iterate> &it_List)
+{
+  it_List += make_iterate(1, 1, DONE);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main'
+// The images of a grid: (1, 1), which is in the file, (3, 5) three
+// times (once as (-3, -5)), and (7, 9) twice.
+static void images(List<iterate> &it_List)
+{
+  it_List += make_iterate(3, 5, NOT_DONE);
+  it_List += make_iterate(1, 1, NOT_DONE);
+  it_List += make_iterate(3, 5, NOT_DONE);
+  it_List += make_iterate(7, 9, NOT_DONE);
+  it_List += make_iterate(-3, -5, NOT_DONE);
+  it_List += make_iterate(7, 9, NOT_DONE);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main'
+// Is it_List (1, 1) DONE, then (3, 5) and (7, 9), NOT_DONE and HIT?
+static bool check(List<iterate> &it_List)
+{
+  const int u[] = {1, 3, 7}, v[] = {1, 5, 9};
+  const short c_stat[] = {DONE, NOT_DONE, NOT_DONE};
+
+  if ( Length(it_List) != 3 )
+    {
+      cout << "Error: " << Length(it_List) << " iterates, not 3:" << endl;
+      if ( !IsEmpty(it_List) )
+	for ( First(it_List); !Finished(it_List); Next(it_List) )
+	  cout << "  " << Current(it_List).ndl.grd << endl;
+      return false;
+    }
+
+  int n = 0;
+  for ( First(it_List); !Finished(it_List); Next(it_List), n++ )
+    {
+      const iterate &it = Current(it_List);
+      if ( it.ndl.grd.u != u[n] || it.ndl.grd.v != v[n] ||
+	   it.ndl.c_stat != c_stat[n] || it.ndl.h_stat != HIT )
+	{
+	  cout << "Error: iterate " << n << " is " << it.ndl.grd << " ("
+	       << it.ndl.c_stat << ", " << it.ndl.h_stat << ")." << endl;
+	  return false;
+	}
+    }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
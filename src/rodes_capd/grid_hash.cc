@@ -0,0 +1,136 @@
+/*   File: grid_hash.cc
+
+     An open addressing (linear probing) hash table
+     from grids to integers. Entries are never removed;
+     a value may be overwritten by -1, though, which
+     makes 'find' report the grid as absent.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include "grid_hash.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+static const unsigned MIN_SLOTS = 64;
+
+static unsigned grid_hash(const grid &);
+
+////////////////////////////////////////////////////////////////////
+
+grid_index::grid_index()
+{
+  clear();
+}
+
+////////////////////////////////////////////////////////////////////
+
+void grid_index::clear()
+{
+  slot empty;
+  empty.taken = false;
+  empty.key = NULL_GRID;
+  empty.value = -1;
+
+  table.assign(MIN_SLOTS, empty);
+  taken_slots = 0;
+}
+
+////////////////////////////////////////////////////////////////////
+
+int grid_index::find(const grid &g) const
+{
+  return table[locate(canonical_grid(g))].value;
+}
+
+////////////////////////////////////////////////////////////////////
+
+void grid_index::set(const grid &g, const int &value)
+{
+  grid key = canonical_grid(g);
+  unsigned i = locate(key);
+
+  if ( !table[i].taken )
+    {
+      if ( 2 * (taken_slots + 1) > (int) table.size() )
+	{ // Keep the table at most half full.
+	  grow();
+	  i = locate(key);
+	}
+      table[i].taken = true;
+      table[i].key = key;
+      taken_slots++;
+    }
+  table[i].value = value;
+}
+
+////////////////////////////////////////////////////////////////////
+
+bool grid_index::insert(const grid &g, const int &value)
+{
+  if ( find(g) >= 0 )
+    return false;
+  set(g, value);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Returns the slot holding 'key' (which must be canonical), or
+// else the free slot where it belongs.
+unsigned grid_index::locate(const grid &key) const
+{
+  unsigned mask = table.size() - 1;
+  unsigned i = grid_hash(key) & mask;
+
+  while ( table[i].taken )
+    {
+      const grid &k = table[i].key;
+      if ( k.u == key.u && k.v == key.v && k.P == key.P )
+	break;
+      i = (i + 1) & mask;
+    }
+  return i;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Doubles the number of slots (unless most of the taken ones have
+// no value), and re-inserts the entries having a value.
+void grid_index::grow()
+{
+  std::vector<slot> old;
+  old.swap(table);
+
+  int live = 0;
+  for ( unsigned k = 0; k < old.size(); k++ )
+    if ( old[k].value >= 0 )
+      live++;
+
+  slot empty;
+  empty.taken = false;
+  empty.key = NULL_GRID;
+  empty.value = -1;
+  table.assign(4 * live < (int) old.size() ? old.size() : 2 * old.size(), empty);
+
+  taken_slots = 0;
+  for ( unsigned k = 0; k < old.size(); k++ )
+    if ( old[k].value >= 0 )
+      {
+	table[locate(old[k].key)] = old[k];
+	taken_slots++;
+      }
+}
+
+////////////////////////////////////////////////////////////////////
+
+static unsigned grid_hash(const grid &g)
+{
+  unsigned h = (unsigned) g.u * 73856093u ^ (unsigned) g.v * 19349663u
+    ^ (unsigned) g.P * 83492791u;
+  return h ^ (h >> 15);
+}
+
+////////////////////////////////////////////////////////////////////
@@ -0,0 +1,70 @@
+/*   File: grid_hash.h
+
+     A hash table from grids to (non-negative) integers,
+     used for finding iterates in the shared table without
+     comparing every pair. Grids are identified modulo the
+     symmetry (u, v) <-> (-u, -v), just as 'grid::operator=='
+     does, by first bringing them to 'canonical_grid' form.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#ifndef GRID_HASH_H
+#define GRID_HASH_H
+
+#include <vector>
+
+#include "2d_classes.h"
+
+////////////////////////////////////////////////////////////////////
+
+// The representative of {(u, v), (-u, -v)} having u > 0,
+// or u == 0 and v >= 0.
+inline grid canonical_grid(const grid &g)
+{
+  if ( g.u < 0 || (g.u == 0 && g.v < 0) )
+    {
+      grid result = {-g.u, -g.v, g.P};
+      return result;
+    }
+  return g;
+}
+
+////////////////////////////////////////////////////////////////////
+
+class grid_index
+{
+ public:
+  grid_index();
+
+  void clear   ();
+
+  // Returns the value stored for g, or -1 if there is none.
+  int  find    (const grid &g) const;
+
+  // Stores 'value' for g, replacing any earlier value.
+  void set     (const grid &g, const int &value);
+
+  // Stores 'value' for g, unless g already has a value.
+  // Returns true if it was stored.
+  bool insert  (const grid &g, const int &value);
+
+ private:
+  class slot
+  {
+   public:
+    bool taken; // Once taken, a slot keeps its key.
+    grid key;   // Canonical.
+    int  value; // -1 if there is no value.
+  };
+
+  std::vector<slot> table; // The size is always a power of two.
+  int taken_slots;         // Including those without a value.
+
+  unsigned locate (const grid &) const;
+  void     grow   ();
+};
+
+////////////////////////////////////////////////////////////////////
+
+#endif // GRID_HASH_H
@@ -0,0 +1,348 @@
+/*   File: lease.cc
+
+     Leases on the grids being done. See 'lease.h'.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <fstream>
+#include <ctime>
+
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <utime.h>
+#include <sys/stat.h>
+
+#include "grid_hash.h"
+#include "lease.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+static std::string shared_name;  // Set by 'lease_start'.
+static std::string own_name;     // Our [proc_nr].
+static std::string alive_name;   // Our heartbeat file.
+static volatile bool beating = false;
+
+static std::string heartbeat_name (const std::string &);
+static void *      heartbeat      (void *);
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_the_flags' (rodes)
+// Calls to : 'heartbeat' (via 'pthread_create')
+// Starts the heartbeat of the process 'owner' sharing 'shared_file'.
+void lease_start(const char *shared_file, const char *owner)
+{
+  shared_name = shared_file;
+  own_name    = owner;
+  alive_name  = heartbeat_name(own_name);
+
+  int fd = open(alive_name.c_str(), O_WRONLY | O_CREAT, 0666);
+  if ( fd >= 0 )
+    close(fd);
+
+  pthread_t id;
+  beating = true;
+  if ( pthread_create(&id, NULL, heartbeat, NULL) == 0 )
+    pthread_detach(id);
+  else
+    cout << "Warning: no heartbeat; our leases will expire." << endl;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'terminate_process' (rodes)
+// Calls to : none
+// We are done: nobody can hold a lease of ours any more.
+void lease_stop()
+{
+  beating = false;
+  if ( !alive_name.empty() )
+    unlink(alive_name.c_str());
+}
+
+////////////////////////////////////////////////////////////////////
+
+const std::string & lease_owner()
+{
+  return own_name;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'expired_leases', 'map_take_fresh_grids'
+// Calls to : 'heartbeat_name'
+// Returns true if the heartbeat of 'owner' has stopped. The leases
+// of unknown owners (and all leases, before 'lease_start') never
+// expire.
+bool lease_expired(const std::string &owner)
+{
+  if ( shared_name.empty() || owner.empty() || owner == own_name )
+    return false;
+
+  struct stat st;
+  if ( stat(heartbeat_name(owner).c_str(), &st) != 0 )
+    return true;
+  return ( difftime(time(NULL), st.st_mtime) > LEASE_TIME );
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'find_fresh_grids', 'insert_it_List' (rodes)
+// Calls to : none
+void read_lease_List(const char *file_name, List<lease> &lease_List)
+{
+  lease temp;
+  std::ifstream InFile(file_name, ios::in);
+
+  while ( InFile >> temp )
+    lease_List += temp;
+  InFile.close();
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'find_fresh_grids', 'insert_it_List' (rodes)
+// Calls to : none
+void write_lease_List(const char *file_name, List<lease> &lease_List)
+{
+  std::ofstream OutFile(file_name, ios::out);
+
+  if ( !IsEmpty(lease_List) )
+    {
+      First(lease_List);
+      while( !Finished(lease_List) )
+	{
+	  OutFile << Current(lease_List) << "\n";
+	  Next(lease_List);
+	}
+    }
+  OutFile.close();
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'find_fresh_grids' (rodes), 'journal_take_fresh_grids',
+//            'replay_line'
+// Calls to : none
+// Leases the grids of 'taken' to 'owner'.
+void add_leases(List<lease> &lease_List, List<iterate> &taken,
+		const std::string &owner)
+{
+  lease temp;
+  temp.owner = owner;
+
+  if ( IsEmpty(taken) )
+    return;
+  First(taken);
+  while ( !Finished(taken) )
+    {
+      temp.grd = Current(taken).ndl.grd;
+      lease_List += temp;
+      Next(taken);
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'insert_it_List' (rodes), 'journal_merge_it_List',
+//            'replay_line'
+// Calls to : 'remove_leases'
+// Ends the leases of the source iterates in Add_List (those not
+// NOT_DONE, see 'update'): their computations are over.
+void drop_leases(List<lease> &lease_List, List<iterate> &Add_List)
+{
+  List<grid> done;
+
+  if ( IsEmpty(Add_List) )
+    return;
+  First(Add_List);
+  while ( !Finished(Add_List) )
+    {
+      if ( Current(Add_List).ndl.c_stat != NOT_DONE )
+	done += Current(Add_List).ndl.grd;
+      Next(Add_List);
+    }
+  remove_leases(lease_List, done);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'drop_leases', 'replay_line'
+// Calls to : none
+// Removes the (first) lease of each grid in 'grids'.
+void remove_leases(List<lease> &lease_List, List<grid> &grids)
+{
+  grid_index gone;
+
+  if ( IsEmpty(grids) || IsEmpty(lease_List) )
+    return;
+  First(grids);
+  while ( !Finished(grids) )
+    {
+      gone.set(Current(grids), 1);
+      Next(grids);
+    }
+
+  First(lease_List);
+  while ( !Finished(lease_List) )
+    {
+      const grid &g = Current(lease_List).grd;
+      if ( gone.find(g) >= 0 )
+	{
+	  gone.set(g, -1);
+	  RemoveCurrent(lease_List);
+	}
+      else
+	Next(lease_List);
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'find_fresh_grids' (rodes), 'journal_take_fresh_grids'
+// Calls to : 'lease_expired'
+// Moves the grids of the expired leases to 'expired'.
+void expired_leases(List<lease> &lease_List, List<grid> &expired)
+{
+  List<lease> alive;  // Owners known to be alive, and...
+  List<lease> dead;   // ...dead, to stat each owner only once.
+
+  if ( IsEmpty(lease_List) )
+    return;
+  First(lease_List);
+  while ( !Finished(lease_List) )
+    {
+      const lease &l = Current(lease_List);
+      bool known = false, is_dead = false;
+
+      if ( !IsEmpty(dead) )
+	for ( First(dead); !Finished(dead) && !known; Next(dead) )
+	  if ( Current(dead).owner == l.owner )
+	    known = is_dead = true;
+      if ( !IsEmpty(alive) && !known )
+	for ( First(alive); !Finished(alive) && !known; Next(alive) )
+	  if ( Current(alive).owner == l.owner )
+	    known = true;
+      if ( !known )
+	{
+	  is_dead = lease_expired(l.owner);
+	  if ( is_dead )
+	    dead += l;
+	  else
+	    alive += l;
+	}
+
+      if ( is_dead )
+	{
+	  expired += l.grd;
+	  RemoveCurrent(lease_List);
+	}
+      else
+	Next(lease_List);
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'release_own_grids' (rodes), 'journal_release_own',
+//            'serve_request' (rodes_coord)
+// Calls to : none
+// Moves the grids leased to 'owner', except those in 'resumed', to
+// 'own'. Called as 'owner' starts, before it takes any grid, these
+// are left by an earlier run under the same [proc_nr], killed before
+// doing them: nobody else will give them back, since the heartbeat
+// of 'owner' is alive again.
+void own_leases(List<lease> &lease_List, const std::string &owner,
+		List<grid> &resumed, List<grid> &own)
+{
+  grid_index keep;
+
+  if ( IsEmpty(lease_List) || owner.empty() )
+    return;
+  if ( !IsEmpty(resumed) )
+    for ( First(resumed); !Finished(resumed); Next(resumed) )
+      keep.set(Current(resumed), 1);
+
+  First(lease_List);
+  while ( !Finished(lease_List) )
+    {
+      const lease &l = Current(lease_List);
+      if ( l.owner == owner && keep.find(l.grd) < 0 )
+	{
+	  own += l.grd;
+	  RemoveCurrent(lease_List);
+	}
+      else
+	Next(lease_List);
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'find_fresh_grids' (rodes), 'journal_take_fresh_grids',
+//            'replay_line', 'serve_client' (rodes_coord)
+// Calls to : none
+// Gives back the grids in 'grids': the first BEING_DONE (or
+// DO_AGAIN) iterate of each grid becomes NOT_DONE.
+void release_grids(List<iterate> &Table, List<grid> &grids)
+{
+  grid_index release;
+
+  if ( IsEmpty(grids) || IsEmpty(Table) )
+    return;
+  First(grids);
+  while ( !Finished(grids) )
+    {
+      release.set(Current(grids), 1);
+      Next(grids);
+    }
+
+  First(Table);
+  while ( !Finished(Table) )
+    {
+      iterate &it = Current(Table);
+      if ( (it.ndl.c_stat == BEING_DONE || it.ndl.c_stat == DO_AGAIN) &&
+	   release.find(it.ndl.grd) >= 0 )
+	{
+	  release.set(it.ndl.grd, -1);
+	  it.ndl.c_stat = NOT_DONE;
+	  cout << "Released the grid " << it.ndl.grd
+	       << " of a lost process." << endl;
+	}
+      Next(Table);
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// The heartbeat file of 'owner'.
+static std::string heartbeat_name(const std::string &owner)
+{
+  return shared_name + "_" + owner + ".alive";
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'lease_start' (via 'pthread_create')
+// Calls to : none
+// Touches our heartbeat file every LEASE_BEAT seconds.
+static void * heartbeat(void *)
+{
+  while ( beating )
+    {
+      if ( utime(alive_name.c_str(), NULL) != 0 && beating )
+	{ // Removed by someone; make a new one.
+	  int fd = open(alive_name.c_str(), O_WRONLY | O_CREAT, 0666);
+	  if ( fd >= 0 )
+	    close(fd);
+	}
+      sleep(LEASE_BEAT);
+    }
+  return NULL;
+}
+
+////////////////////////////////////////////////////////////////////
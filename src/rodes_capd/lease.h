@@ -0,0 +1,90 @@
+/*   File: lease.h
+
+     Leases on the grids being done. A process taking a
+     grid (c_stat = BEING_DONE) records itself as the
+     owner of the grid. While it lives, a thread of the
+     process touches the file <shared_file>_<owner>.alive
+     every LEASE_BEAT seconds. When that file has not been
+     touched for LEASE_TIME seconds (or is gone), the lease
+     has expired: the process has been killed, and its
+     grids are given back (c_stat = NOT_DONE).
+
+     The owner is the [proc_nr] given to 'rodes', which
+     must be distinct for all processes (and a number,
+     with a binary file: see 'map_open'). Our own leases
+     never expire; when we are restarted under the same
+     [proc_nr], the grids still leased to us (except the
+     ones resumed from a checkpoint) are given back at
+     once (see 'own_leases').
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#ifndef LEASE_H
+#define LEASE_H
+
+#include <string>
+
+#include "2d_classes.h"
+#include "list.h"
+
+////////////////////////////////////////////////////////////////////
+
+// The leases of <shared_file> are kept in <shared_file> followed
+// by this suffix (when the text file is shared without journal).
+static const char LEASE_SUFFIX[] = ".leases";
+
+const unsigned LEASE_BEAT =  60; // Heartbeat every minute...
+const unsigned LEASE_TIME = 600; // ...expired after ten minutes.
+
+////////////////////////////////////////////////////////////////////
+
+class lease
+{
+ public:
+  grid grd;
+  std::string owner;
+
+  friend ostream & operator << (ostream &out, const lease &l)
+    {
+      out << l.owner << " " << l.grd;
+      return out;
+    }
+  friend istream & operator >> (istream &in, lease &l)
+    {
+      in >> l.owner >> l.grd;
+      return in;
+    }
+};
+
+////////////////////////////////////////////////////////////////////
+
+void                lease_start      (const char *, const char *);
+
+void                lease_stop       ();
+
+const std::string & lease_owner      ();
+
+bool                lease_expired    (const std::string &);
+
+void                read_lease_List  (const char *, List<lease> &);
+
+void                write_lease_List (const char *, List<lease> &);
+
+void                add_leases       (List<lease> &, List<iterate> &,
+				      const std::string &);
+
+void                drop_leases      (List<lease> &, List<iterate> &);
+
+void                remove_leases    (List<lease> &, List<grid> &);
+
+void                expired_leases   (List<lease> &, List<grid> &);
+
+void                own_leases       (List<lease> &, const std::string &,
+				      List<grid> &, List<grid> &);
+
+void                release_grids    (List<iterate> &, List<grid> &);
+
+////////////////////////////////////////////////////////////////////
+
+#endif // LEASE_H
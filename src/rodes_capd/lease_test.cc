@@ -0,0 +1,264 @@
+/*   File: lease_test.cc
+
+     Checks that the grids of a worker killed in the
+     middle of a batch are given back when it is
+     restarted under the same [proc_nr] (see 'lease.h'),
+     both with the text file and with its journal.
+
+     A worker "8" takes a grid, and a worker "7" takes a
+     batch of BATCH grids; both are killed (SIGKILL).
+     Worker "7" is then restarted, resuming the first
+     grid of its batch as from a checkpoint. All other
+     grids of its batch must be NOT_DONE again, while
+     the resumed grid and the grid of "8" (whose
+     heartbeat is still fresh) stay BEING_DONE.
+
+     Usage: lease_test [directory]  (default /tmp)
+
+     Compilation: make lease_test
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <cstdio>
+#include <csignal>
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "2d_classes.h"
+#include "classes.h"
+#include "list.h"
+#include "lease.h"
+#include "request.h"
+#include "share_table.h"
+#include "share_journal.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+const int GRIDS = 8;  // In the shared file at the start.
+const int BATCH = 4;  // Taken by worker "7" ('rodes --batch 4').
+
+static void  seed_file     (const std::string &);
+static void  take_and_die  (const std::string &, const bool &,
+			    const char *, const int &);
+static int   restart       (const std::string &, const bool &);
+static bool  run           (const std::string &, const bool &);
+static pid_t in_child      (const std::string &, const bool &,
+			    const char *, const int &);
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: none
+// Calls to : 'run'
+int main(int argc, char *argv[])
+{
+  std::string dir = ( argc == 2 ? argv[1] : "/tmp" );
+  std::ostringstream name;
+
+  name << dir << "/lease_test_" << getpid();
+  bool text    = run(name.str() + "_text", false);
+  bool journal = run(name.str() + "_journal", true);
+
+  cout << "text file: " << (text ? "ok" : "FAILED") << endl;
+  cout << "journal:   " << (journal ? "ok" : "FAILED") << endl;
+  return ( text && journal ? 0 : 1 );
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main'
+// Calls to : 'seed_file', 'in_child', 'restart'
+// Runs the two workers and the restart, each in a process of its own
+// (as 'lease_start' is called once per process), then cleans up.
+static bool run(const std::string &shared, const bool &journal)
+{
+  int status = -1;
+
+  seed_file(shared);
+  waitpid(in_child(shared, journal, "8", 1), &status, 0);
+  waitpid(in_child(shared, journal, "7", BATCH), &status, 0);
+  bool killed = ( WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL );
+
+  pid_t pid = fork();
+  if ( pid == 0 )
+    _exit(restart(shared, journal));
+  waitpid(pid, &status, 0);
+
+  const char *suffixes[] = {"", LEASE_SUFFIX, JOURNAL_SUFFIX, ".resumed",
+			    "_7.alive", "_8.alive"};
+  for ( unsigned i = 0; i < sizeof(suffixes) / sizeof(suffixes[0]); i++ )
+    unlink((shared + suffixes[i]).c_str());
+
+  return ( killed && WIFEXITED(status) && WEXITSTATUS(status) == 0 );
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'run'
+// Calls to : 'take_and_die'
+static pid_t in_child(const std::string &shared, const bool &journal,
+		      const char *owner, const int &count)
+{
+  pid_t pid = fork();
+
+  if ( pid == 0 )
+    take_and_die(shared, journal, owner, count);
+  return pid;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'run'
+// Calls to : 'write_it_List'
+// GRIDS grids, NOT_DONE, none of them the reflection of another.
+static void seed_file(const std::string &shared)
+{
+  List<iterate> it_List;
+  iterate it;
+
+  for ( int i = 0; i < GRIDS; i++ )
+    {
+      it.ndl.grd.u = 2 * i + 1;
+      it.ndl.grd.v = 1;
+      it.ndl.grd.P = 8;
+#ifdef COMPUTE_C1
+      it.ndl.ang = DEG_TO_RAD * Hull(0.0, 10.0);
+      it.ndl.pre_exp = LARGE_NUMBER;
+      it.ndl.min_exp = LARGE_NUMBER;
+#endif
+      it.ndl.c_stat = NOT_DONE;
+      it.ndl.h_stat = NOT_HIT;
+      it.inf_grd = NULL_GRID;
+      it.sup_grd = NULL_GRID;
+      it_List += it;
+    }
+  write_it_List(shared.c_str(), it_List);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'in_child'
+// Calls to : 'lease_start', 'journal_open', 'journal_take_fresh_grids',
+//            'get_file', 'read_it_List', 'read_lease_List',
+//            'take_fresh_grids', 'add_leases', 'write_it_List',
+//            'write_lease_List', 'release_file'
+// Takes 'count' grids as 'owner' does in 'get_a_grid' (rodes), notes
+// the first one (the grid its checkpoint will resume), and is killed.
+static void take_and_die(const std::string &shared, const bool &journal,
+			 const char *owner, const int &count)
+{
+  std::string proc_name  = shared + "_" + owner;
+  std::string lease_name = shared + LEASE_SUFFIX;
+  List<iterate> taken;
+
+  lease_start(shared.c_str(), owner);
+  if ( journal )
+    {
+      journal_open(shared.c_str());
+      journal_take_fresh_grids(taken, count);
+    }
+  else
+    {
+      List<iterate> File_List;
+      List<lease> Lease_List;
+
+      get_file(shared.c_str(), proc_name.c_str());
+      read_it_List(proc_name.c_str(), File_List);
+      read_lease_List(lease_name.c_str(), Lease_List);
+      take_fresh_grids(File_List, taken, count);
+      add_leases(Lease_List, taken, lease_owner());
+      write_it_List(proc_name.c_str(), File_List);
+      write_lease_List(lease_name.c_str(), Lease_List);
+      release_file(shared.c_str(), proc_name.c_str());
+    }
+
+  if ( std::string(owner) == "7" && !IsEmpty(taken) )
+    {
+      std::ofstream OutFile((shared + ".resumed").c_str(), ios::out);
+      OutFile << First(taken).ndl.grd << "\n";
+    }
+  kill(getpid(), SIGKILL); // In the middle of the batch.
+  _exit(1);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'run'
+// Calls to : 'lease_start', 'lease_expired', 'journal_open',
+//            'journal_release_own', 'journal_take_fresh_grids',
+//            'get_file', 'read_it_List', 'read_lease_List',
+//            'own_leases', 'release_grids', 'take_fresh_grids',
+//            'release_file'
+// Worker "7" again: gives back its grids (as 'release_own_grids' does
+// in 'rodes'), then takes all that is left. Returns 0 if these are
+// the GRIDS - 2 grids other than the resumed one and that of "8".
+static int restart(const std::string &shared, const bool &journal)
+{
+  std::string proc_name  = shared + "_7";
+  std::string lease_name = shared + LEASE_SUFFIX;
+  List<grid> resumed;
+  List<iterate> taken;
+  grid g;
+
+  std::ifstream InFile((shared + ".resumed").c_str(), ios::in);
+  if ( !(InFile >> g) )
+    {
+      cout << "Error: worker 7 took no grid." << endl;
+      return 1;
+    }
+  resumed += g;
+
+  lease_start(shared.c_str(), "7");
+  if ( lease_expired("7") || lease_expired("8") )
+    {
+      cout << "Error: a live heartbeat has expired." << endl;
+      return 1;
+    }
+  if ( journal )
+    {
+      journal_open(shared.c_str());
+      journal_release_own(resumed);
+      journal_take_fresh_grids(taken, GRIDS);
+    }
+  else
+    {
+      List<iterate> File_List;
+      List<lease> Lease_List;
+      List<grid> own;
+
+      get_file(shared.c_str(), proc_name.c_str());
+      read_it_List(proc_name.c_str(), File_List);
+      read_lease_List(lease_name.c_str(), Lease_List);
+      own_leases(Lease_List, lease_owner(), resumed, own);
+      release_grids(File_List, own);
+      take_fresh_grids(File_List, taken, GRIDS);
+      release_file(shared.c_str(), proc_name.c_str());
+    }
+
+  int errors = 0;
+  if ( Length(taken) != GRIDS - 2 )
+    {
+      cout << "Error: " << Length(taken) << " grids left, not "
+	   << GRIDS - 2 << "." << endl;
+      errors++;
+    }
+  if ( !IsEmpty(taken) )
+    for ( First(taken); !Finished(taken); Next(taken) )
+      if ( Current(taken).ndl.grd == g )
+	{
+	  cout << "Error: the resumed grid " << g << " was given back." << endl;
+	  errors++;
+	}
+  return ( errors == 0 ? 0 : 1 );
+}
+
+////////////////////////////////////////////////////////////////////
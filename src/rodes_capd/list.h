@@ -4,6 +4,20 @@
      with dynamic memory allocation.
 
      Usage: List<int>, List<vector>, etc...
+
+     The nodes come from a pool per TYPE ('ListPool'):
+     each thread keeps its own free list of nodes, which
+     is refilled LIST_CHUNK nodes at a time. So '+=',
+     '*=', '--' and 'RemoveCurrent' do not call new and
+     delete, and the nodes of a list made in one go lie
+     next to each other. A node stays where it is until
+     it is removed, as before: references to elements
+     (e.g. from 'Current') stay valid.
+
+     A List cannot be copied. Instead, 'MoveFirst',
+     'MoveCurrent' and 'Append' pass elements on to
+     another List without copying them: only the nodes
+     are linked in there.
  
      Latest edit: Sun Jul 24 2000
 */
@@ -13,6 +27,9 @@
 
 #include <iostream.h>
 #include <stdio.h>
+#include <new>
+
+#include <pthread.h>
 
 //#include "list_funcs.h"
 
@@ -24,6 +41,9 @@ template < class TYPE > TYPE & Next ( List < TYPE > & );
 template < class TYPE > TYPE & Last ( const List < TYPE > & ); 
 template < class TYPE > TYPE & Current ( const List < TYPE > & );
 template < class TYPE > void RemoveCurrent ( List < TYPE > & );
+template < class TYPE > void MoveFirst ( List < TYPE > &, List < TYPE > & );
+template < class TYPE > void MoveCurrent ( List < TYPE > &, List < TYPE > & );
+template < class TYPE > void Append ( List < TYPE > &, List < TYPE > & );
 template < class TYPE > 
 ostream & operator << ( ostream &, const List < TYPE > & );
 
@@ -36,6 +56,42 @@ struct ListObject
   TYPE  element;
 };
 
+////////////////////////////////////////////////////////////////////////////
+
+const int LIST_CHUNK = 256;            // Nodes allocated (or moved) at a time.
+const int LIST_SPARE = 4 * LIST_CHUNK; // The most free nodes a thread keeps.
+
+// The free nodes of all Lists of a TYPE. 'take' returns a node without
+// an element, 'give' takes one back (its element destroyed). A thread
+// with more than LIST_SPARE free nodes passes LIST_CHUNK of them on to
+// the spares shared by all threads, where a thread without free nodes
+// looks first; so do the free nodes of a thread that ends. The memory
+// is never given back to the system.
+template<class TYPE>
+class ListPool
+{
+  public:
+    static ListObject<TYPE> * take ();
+    static void               give (ListObject<TYPE> *);
+
+  private:
+    struct cache
+    {
+      ListObject<TYPE> *free;
+      int count;
+    };
+    static cache * thread_cache ();
+    static void    make_key     ();
+    static void    end_thread   (void *);
+    static void    refill       (cache *);
+    static void    spill        (cache *);
+
+    static pthread_key_t     key;
+    static pthread_once_t    once;
+    static pthread_mutex_t   mutex; // For 'spare'.
+    static ListObject<TYPE> *spare;
+};
+
 ////////////////////////////////////////////////////////////////////////////
 // 'friend' members are there so that they have access to speific
 // private members of List
@@ -76,6 +132,9 @@ class List
     friend TYPE & Last    <TYPE>(const List &);
     friend TYPE & Current <TYPE>(const List &);
     friend void RemoveCurrent <TYPE>(List &);
+    friend void MoveFirst     <TYPE>(List &, List &);
+    friend void MoveCurrent   <TYPE>(List &, List &);
+    friend void Append        <TYPE>(List &, List &);
     friend ostream & operator << <TYPE>(ostream &, const List &);
 
 };
@@ -83,6 +142,107 @@ class List
 ////////////////////////////////////////////////////////////////////////////
 // Member function definitions follow
 
+template<class TYPE> pthread_key_t     ListPool<TYPE>::key;
+template<class TYPE> pthread_once_t    ListPool<TYPE>::once  = PTHREAD_ONCE_INIT;
+template<class TYPE> pthread_mutex_t   ListPool<TYPE>::mutex = PTHREAD_MUTEX_INITIALIZER;
+template<class TYPE> ListObject<TYPE> *ListPool<TYPE>::spare = __null;
+
+template<class TYPE>
+ListObject<TYPE> * ListPool<TYPE>::take()
+{
+  cache *c = thread_cache();
+  if (c->free == __null) refill(c);
+  ListObject<TYPE> *p = c->free;
+  c->free = p->next;
+  c->count--;
+  return p;
+}
+
+template<class TYPE>
+void ListPool<TYPE>::give(ListObject<TYPE> *p)
+{
+  cache *c = thread_cache();
+  p->next = c->free;
+  c->free = p;
+  if (++c->count > LIST_SPARE) spill(c);
+}
+
+template<class TYPE>
+typename ListPool<TYPE>::cache * ListPool<TYPE>::thread_cache()
+{
+  pthread_once(&once, make_key);
+  cache *c = (cache *) pthread_getspecific(key);
+  if (c == __null) {
+    c = new cache;
+    c->free = __null;
+    c->count = 0;
+    pthread_setspecific(key, c);
+  }
+  return c;
+}
+
+template<class TYPE>
+void ListPool<TYPE>::make_key()
+{
+  pthread_key_create(&key, end_thread);
+}
+
+// The free nodes of a thread that ends go to the spares.
+template<class TYPE>
+void ListPool<TYPE>::end_thread(void *arg)
+{
+  cache *c = (cache *) arg;
+  if (c->free != __null) {
+    ListObject<TYPE> *last = c->free;
+    while (last->next != __null) last = last->next;
+    pthread_mutex_lock(&mutex);
+    last->next = spare;
+    spare = c->free;
+    pthread_mutex_unlock(&mutex);
+  }
+  delete c;
+}
+
+// Takes (up to) LIST_CHUNK spares, or else a new chunk of nodes.
+template<class TYPE>
+void ListPool<TYPE>::refill(cache *c)
+{
+  pthread_mutex_lock(&mutex);
+  while (spare != __null && c->count < LIST_CHUNK) {
+    ListObject<TYPE> *p = spare;
+    spare = p->next;
+    p->next = c->free;
+    c->free = p;
+    c->count++;
+  }
+  pthread_mutex_unlock(&mutex);
+  if (c->free != __null) return;
+
+  ListObject<TYPE> *chunk =
+    (ListObject<TYPE> *) ::operator new(LIST_CHUNK * sizeof(ListObject<TYPE>));
+  for (int i = LIST_CHUNK - 1; i >= 0; i--) { // In the order of memory.
+    chunk[i].next = c->free;
+    c->free = &chunk[i];
+  }
+  c->count = LIST_CHUNK;
+}
+
+// Passes LIST_CHUNK free nodes on to the spares.
+template<class TYPE>
+void ListPool<TYPE>::spill(cache *c)
+{
+  ListObject<TYPE> *first = c->free, *last = c->free;
+  for (int i = 1; i < LIST_CHUNK; i++) last = last->next;
+  c->free = last->next;
+  c->count -= LIST_CHUNK;
+  pthread_mutex_lock(&mutex);
+  last->next = spare;
+  spare = first;
+  pthread_mutex_unlock(&mutex);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 template<class TYPE>
 List<TYPE>::~List()		 
 {
@@ -90,7 +250,8 @@ List<TYPE>::~List()
 
   while (start != __null) {
     temp = start; start = start->next;
-    delete temp;
+    temp->element.~TYPE();
+    ListPool<TYPE>::give(temp);
   }
   start = end = __null;
   len = 0;
@@ -101,8 +262,8 @@ List<TYPE>::~List()
 template<class TYPE>
 void List<TYPE>::operator += (const TYPE & obj)
 {
-  ListObject<TYPE> *p = new ListObject<TYPE>;
-  p->element = obj;
+  ListObject<TYPE> *p = ListPool<TYPE>::take();
+  new (&p->element) TYPE(obj);
   p->next = __null;
   if (start == __null) start = p;
   else end->next = p;
@@ -116,8 +277,8 @@ void List<TYPE>::operator += (const TYPE & obj)
 template<class TYPE>
 void List<TYPE>::operator *= (const TYPE & obj)
 {
-  ListObject<TYPE> *p = new ListObject<TYPE>;
-  p->element = obj;
+  ListObject<TYPE> *p = ListPool<TYPE>::take();
+  new (&p->element) TYPE(obj);
   p->next = start;
   if (start == __null) end = p;
   start = p;
@@ -132,7 +293,8 @@ void List<TYPE>::operator -- ()
 {
   if (start == __null) printf("List (--): empty list\n");
   ListObject<TYPE> *p = start->next;
-  delete start;
+  start->element.~TYPE();
+  ListPool<TYPE>::give(start);
   start = p;
   if (start == __null) end = __null;
   len--;
@@ -204,13 +366,74 @@ void RemoveCurrent (List<TYPE> & li)
   ListObject<TYPE> *del_cur = li.current;
   if (li.current == __null) printf("List (RemoveCurrent): no element\n");
   li.current = li.current->next;
-  delete del_cur;
+  del_cur->element.~TYPE();
+  ListPool<TYPE>::give(del_cur);
   li.len--;
   if (li.lastcur == __null) li.start = li.current;
   else li.lastcur->next = li.current;
   if (li.current == __null) li.end = li.lastcur;
 }
 
+////////////////////////////////////////////////////////////////////////////
+// Moves the first element of 'from' to the end of 'to' (which may be
+// 'from' itself), without copying it.
+template<class TYPE>
+void MoveFirst (List<TYPE> & from, List<TYPE> & to)
+{
+  ListObject<TYPE> *p = from.start;
+  if (p == __null) printf("List (MoveFirst): empty list\n");
+  from.start = p->next;
+  if (from.start == __null) from.end = __null;
+  if (from.current == p) from.current = from.start;
+  if (from.lastcur == p) from.lastcur = __null;
+  from.len--;
+
+  p->next = __null;
+  if (to.start == __null) to.start = p;
+  else to.end->next = p;
+  to.end = p;
+  to.len++;
+  if (to.len > to.maxlen) to.maxlen = to.len;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// As 'RemoveCurrent', but the element goes to the end of 'to' (not
+// 'from'), without being copied.
+template<class TYPE>
+void MoveCurrent (List<TYPE> & from, List<TYPE> & to)
+{
+  ListObject<TYPE> *p = from.current;
+  if (p == __null) printf("List (MoveCurrent): no element\n");
+  from.current = p->next;
+  from.len--;
+  if (from.lastcur == __null) from.start = from.current;
+  else from.lastcur->next = from.current;
+  if (from.current == __null) from.end = from.lastcur;
+
+  p->next = __null;
+  if (to.start == __null) to.start = p;
+  else to.end->next = p;
+  to.end = p;
+  to.len++;
+  if (to.len > to.maxlen) to.maxlen = to.len;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Moves all of 'from' (not 'to') to the end of 'to', leaving 'from'
+// empty. Nothing is copied, whatever the lengths.
+template<class TYPE>
+void Append (List<TYPE> & to, List<TYPE> & from)
+{
+  if (from.start == __null) return;
+  if (to.start == __null) to.start = from.start;
+  else to.end->next = from.start;
+  to.end = from.end;
+  to.len += from.len;
+  if (to.len > to.maxlen) to.maxlen = to.len;
+  from.start = from.end = from.current = from.lastcur = __null;
+  from.len = 0;
+}
+
 //#endif // __linux
 
 ////////////////////////////////////////////////////////////////////////////
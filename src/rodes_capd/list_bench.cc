@@ -0,0 +1,213 @@
+/*   File: list_bench.cc
+
+     Times 'List' (see 'list.h', whose nodes come from a
+     pool) against the list as it was before, with a node
+     taken by 'new' and given back by 'delete': the queue
+     of parcels of 'Compute_the_return' (take the first,
+     add its pieces at the end), and lists of grids made,
+     run through and emptied, as in 'share_table.cc'.
+
+     Usage: list_bench [rounds]
+
+     Compilation: make list_bench
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+#include <sys/time.h>
+
+#include "2d_classes.h"
+#include "classes.h"
+#include "list.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+const int QUEUE_LENGTH = 64;    // Parcels waiting to be flowed.
+const int PIECES       = 4;     // What a parcel is split into.
+const int GRIDS        = 1000;  // The images of a grid.
+
+// The list before 'ListPool': what is timed against.
+template<class TYPE>
+class OldList
+{
+  public:
+    OldList () : start(NULL), end(NULL), len(0) {}
+    ~OldList ()
+    {
+      while ( start != NULL )
+	{
+	  ListObject<TYPE> *temp = start;
+	  start = start->next;
+	  delete temp;
+	}
+    }
+    void operator += (const TYPE &obj)
+    {
+      ListObject<TYPE> *p = new ListObject<TYPE>;
+      p->element = obj;
+      p->next = NULL;
+      if ( start == NULL ) start = p; else end->next = p;
+      end = p;
+      len++;
+    }
+    void operator -- ()
+    {
+      ListObject<TYPE> *p = start->next;
+      delete start;
+      start = p;
+      if ( start == NULL ) end = NULL;
+      len--;
+    }
+    friend TYPE & First (OldList &li)      { return li.start->element; }
+    friend int IsEmpty  (const OldList &li) { return li.start == NULL; }
+    friend int Length   (const OldList &li) { return li.len; }
+
+  private:
+    ListObject<TYPE> *start, *end;
+    int len;
+};
+
+static double seconds_since (const struct timeval &);
+static parcel make_parcel   ();
+
+template<class LIST>
+static double time_queue    (const int &, const parcel &);
+template<class LIST>
+static double time_grids    (const int &, long &);
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: none
+// Calls to : 'make_parcel', 'time_queue', 'time_grids'
+int main(int argc, char *argv[])
+{
+  int rounds = ( argc == 2 ? atoi(argv[1]) : 1000 );
+  if ( rounds <= 0 )
+    {
+      cout << endl << "Usage: " << endl;
+      cout << "\t" << argv[0] << " [rounds]\n\n"
+	   << "\twhich times 'List' against a list of 'new' nodes,\n"
+	   << "\t[rounds] (default 1000) times.\n" << endl;
+      exit(0);
+    }
+
+  parcel pcl = make_parcel();
+  long sum_old = 0, sum_new = 0;
+
+  double queue_old = time_queue<OldList<parcel> >(rounds, pcl);
+  double queue_new = time_queue<List<parcel> >(rounds, pcl);
+  double grids_old = time_grids<OldList<grid> >(rounds, sum_old);
+  double grids_new = time_grids<List<grid> >(rounds, sum_new);
+
+  cout << rounds << " rounds:" << endl;
+  cout << "  parcel queue (" << QUEUE_LENGTH << " x " << PIECES << " pieces)" << endl;
+  cout << "    new/delete " << setw(10) << queue_old << " s" << endl;
+  cout << "    List       " << setw(10) << queue_new << " s   ("
+       << ( queue_new > 0.0 ? queue_old / queue_new : 0.0 ) << " times faster)" << endl;
+  cout << "  grid lists (" << GRIDS << " grids)" << endl;
+  cout << "    new/delete " << setw(10) << grids_old << " s" << endl;
+  cout << "    List       " << setw(10) << grids_new << " s   ("
+       << ( grids_new > 0.0 ? grids_old / grids_new : 0.0 ) << " times faster)" << endl;
+  if ( sum_old != sum_new )
+    {
+      cout << "Error: the lists do not hold the same grids!" << endl;
+      return 1;
+    }
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main'
+// Each round, QUEUE_LENGTH parcels are taken from the front of the
+// queue, and each is put back as PIECES parcels, then all but
+// QUEUE_LENGTH are taken off again.
+template<class LIST>
+static double time_queue(const int &rounds, const parcel &pcl)
+{
+  struct timeval start;
+  LIST queue;
+
+  for ( int i = 0; i < QUEUE_LENGTH; i++ )
+    queue += pcl;
+
+  gettimeofday(&start, NULL);
+  for ( int n = 0; n < rounds; n++ )
+    {
+      for ( int i = 0; i < QUEUE_LENGTH; i++ )
+	{
+	  parcel piece = First(queue);
+	  --queue;
+	  for ( int k = 0; k < PIECES; k++ )
+	    queue += piece;
+	}
+      while ( Length(queue) > QUEUE_LENGTH )
+	--queue;
+    }
+  return seconds_since(start);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main'
+// Each round, a list of GRIDS grids is made, then emptied from the
+// front; 'sum' adds up what was taken, for checking.
+template<class LIST>
+static double time_grids(const int &rounds, long &sum)
+{
+  struct timeval start;
+
+  gettimeofday(&start, NULL);
+  for ( int n = 0; n < rounds; n++ )
+    {
+      LIST grid_List;
+      for ( int i = 0; i < GRIDS; i++ )
+	{
+	  grid grd;
+	  grd.u = 2 * i + 1;
+	  grd.v = 2 * n + 1;
+	  grd.P = 8;
+	  grid_List += grd;
+	}
+      while ( !IsEmpty(grid_List) )
+	{
+	  sum += First(grid_List).u;
+	  --grid_List;
+	}
+    }
+  return seconds_since(start);
+}
+
+////////////////////////////////////////////////////////////////////
+
+static parcel make_parcel()
+{
+  parcel pcl;
+
+  pcl.box = BOX(SYSDIM);
+  for ( short i = 1; i <= SYSDIM; i++ )
+    pcl.box(i) = Hull(i - 1e-3, i + 1e-3);
+  pcl.trvl = 3;
+  pcl.sign = 1;
+  pcl.time = 0.0;
+  pcl.message = 0;
+  return pcl;
+}
+
+////////////////////////////////////////////////////////////////////
+
+static double seconds_since(const struct timeval &start)
+{
+  struct timeval stop;
+
+  gettimeofday(&stop, NULL);
+  return (stop.tv_sec - start.tv_sec) + 1e-6 * (stop.tv_usec - start.tv_usec);
+}
+
+////////////////////////////////////////////////////////////////////
@@ -0,0 +1,204 @@
+/*   File: lohner.cc
+
+     The set of a parcel as a doubleton.
+     See 'lohner.h'.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include "lohner.h"
+
+////////////////////////////////////////////////////////////////////
+
+// Set by 'Set_Lohner'.
+static bool lohner = false;
+
+////////////////////////////////////////////////////////////////////
+
+static bool Same_Box   (const BOX &, const BOX &);
+static bool Orthogonal (IMatrix &, IMatrix &, const IMatrix &,
+			const BOX &, const short &);
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_the_options' (rodes)
+// Calls to : none
+void Set_Lohner(const bool &on)
+{
+  lohner = on;
+}
+
+// Called by: 'Flow' (return_map)
+// Calls to : none
+bool Lohner()
+{
+  return lohner;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by 'Flow' (return_map).
+// Is pcl.set still the set in pcl.box?
+bool Lohner_Kept(const parcel &pcl)
+{
+  return ( pcl.set.trvl == pcl.trvl && pcl.set.sign == pcl.sign &&
+	   Same_Box(pcl.set.hull, pcl.box) );
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by 'Flow' (return_map).
+// Starts the set of pcl from its box: c is the center of
+// the box, C the identity, and r = 0.
+void Lohner_Start(parcel &pcl)
+{
+  doubleton &s = pcl.set;
+
+  s.C.clear();
+  s.B.clear();
+  for ( short i = 1; i <= SYSDIM; i++ )
+    {
+      if ( i == pcl.trvl )
+	{
+	  s.c(i)  = pcl.box(i); // Inf == Sup.
+	  s.r0(i) = 0.0;
+	}
+      else
+	{
+	  s.c(i)  = Mid(pcl.box(i));
+	  s.r0(i) = pcl.box(i) - s.c(i);
+	  s.C(i, i) = 1.0;
+	  s.B(i, i) = 1.0;
+	}
+      s.r(i) = 0.0;
+    }
+  s.hull = pcl.box;
+  s.trvl = pcl.trvl;
+  s.sign = pcl.sign;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by 'Flow' (return_map).
+// Takes result.set (that of the parcel before the step) along the
+// step, given its derivatives DPi over the old box, and the image of
+// the old center. result.box, the image of the old box, is replaced
+// by the hull of the new set within it. Returns false if the set is
+// lost (result.box is then left as it was).
+bool Lohner_Step(parcel &result, const IMatrix &DPi, const BOX &center_image)
+{
+  doubleton &s   = result.set;
+  const short tr = result.trvl;
+  BOX     c(SYSDIM), dc(SYSDIM), r(SYSDIM), hull(SYSDIM), zero(SYSDIM);
+  IMatrix C(SYSDIM, SYSDIM), Q(SYSDIM, SYSDIM), Q_inv(SYSDIM, SYSDIM);
+  IMatrix DC(SYSDIM, SYSDIM), DB(SYSDIM, SYSDIM);
+  IMatrix M(SYSDIM, SYSDIM), N(SYSDIM, SYSDIM);
+  short i, j;
+
+  if ( s.trvl != tr )
+    return false;
+
+  // The new center, and how far the image of the old one is from it.
+  for ( i = 1; i <= SYSDIM; i++ )
+    {
+      c(i)    = ( i == tr ? result.box(i) : interval(Mid(center_image(i))) );
+      dc(i)   = ( i == tr ? interval(0.0) : center_image(i) - c(i) );
+      zero(i) = 0.0;
+    }
+
+  // The image of the set is within
+  //   c + C * r0 + [dc + (DPi * C - C) * r0 + DPi * B * r],
+  // with C = Mid(DPi * C). The bracket is Q * r, with the new r.
+  Mult(DC, DPi, s.C);
+  Mult(DB, DPi, s.B);
+  for ( i = 1; i <= SYSDIM; i++ )
+    for ( j = 1; j <= SYSDIM; j++ )
+      {
+	C(i, j)  = Mid(DC(i, j));
+	DC(i, j) -= C(i, j);
+      }
+  if ( !Orthogonal(Q, Q_inv, DB, s.r, tr) )
+    return false;
+  Mult(M, Q_inv, DC);  // The products of the matrices first:
+  Mult(N, Q_inv, DB);  // Q_inv * DPi * B is nearly diagonal.
+  Mult_Add(r, zero, Q_inv, dc);
+  Mult_Add(r, r, M, s.r0);
+  Mult_Add(r, r, N, s.r);
+
+  // Its hull, within the image of the old box.
+  Mult_Add(hull, c, C, s.r0);
+  Mult_Add(hull, hull, Q, r);
+  hull(tr) = result.box(tr);
+  if ( !Intersection(hull, hull, result.box) || !Subset(c, hull) )
+    return false;
+
+  result.box = hull;
+  s.c    = c;
+  s.C    = C;
+  s.B    = Q;
+  s.r    = r;
+  s.hull = hull;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by 'Lohner_Kept'.
+// Equal to the last bit?
+static bool Same_Box(const BOX &box1, const BOX &box2)
+{
+  for ( short i = 1; i <= SYSDIM; i++ )
+    if ( Inf(box1(i)) != Inf(box2(i)) || Sup(box1(i)) != Sup(box2(i)) )
+      return false;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by 'Lohner_Step'.
+// The Q of the QR decomposition of Mid(DB), with its inverse Q_inv
+// (enclosed; Q is only nearly orthogonal in floating point). The
+// planes are 2-dimensional, so Q is a rotation, which keeps the
+// direction of the column of DB that stretches r the most. Returns
+// false if Q_inv cannot be enclosed.
+static bool Orthogonal(IMatrix &Q, IMatrix &Q_inv, const IMatrix &DB,
+		       const BOX &r, const short &trvl)
+{
+  short  p[2];          // The coordinates in the plane.
+  double col[2][2];     // The columns of Mid(DB) in it,
+  double len[2];        // their lengths,
+  double weight[2];     // and how much they stretch r.
+  short  k = 0;
+
+  for ( short i = 1; i <= SYSDIM; i++ )
+    if ( i != trvl )
+      p[k++] = i;
+  for ( k = 0; k < 2; k++ )
+    {
+      col[k][0] = Mid(DB(p[0], p[k]));
+      col[k][1] = Mid(DB(p[1], p[k]));
+      len[k]    = sqrt(col[k][0] * col[k][0] + col[k][1] * col[k][1]);
+      weight[k] = len[k] * Diam(r(p[k]));
+    }
+  k = ( weight[1] > weight[0] || (weight[1] == weight[0] && len[1] > len[0]) ? 1 : 0 );
+
+  double q0 = 1.0, q1 = 0.0;  // The identity, unless DB has a column.
+  if ( len[k] > 0.0 && len[k] < HUGE_VAL )
+    {
+      q0 = col[k][0] / len[k];
+      q1 = col[k][1] / len[k];
+    }
+  interval det = interval(q0) * q0 + interval(q1) * q1;
+  if ( Subset(0.0, det) )
+    return false;
+
+  Q.clear();
+  Q(p[0], p[0]) = q0;   Q(p[0], p[1]) = - q1;
+  Q(p[1], p[0]) = q1;   Q(p[1], p[1]) = q0;
+  Q_inv.clear();
+  Q_inv(p[0], p[0]) = interval(q0) / det;   Q_inv(p[0], p[1]) = interval(q1) / det;
+  Q_inv(p[1], p[0]) = - interval(q1) / det; Q_inv(p[1], p[1]) = interval(q0) / det;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
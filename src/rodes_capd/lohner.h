@@ -0,0 +1,47 @@
+/*   File: lohner.h
+
+     The set of a parcel as a doubleton, as CAPD's
+     'C0Rect2Set', instead of its box. Selected by
+     'rodes --lohner'.
+
+     Each step wraps the image of a box in a new box, and
+     the boxes grow much faster than the sets in them, so
+     that 'Too_Large' splits them far too often. Within a
+     plane, the set of a parcel is kept as
+
+       c + C * r0 + B * r
+
+     (see 'doubleton' in 'classes.h'). A step (by 'Flow')
+     takes c to the image of c, C to DPi * C, and B to the
+     orthogonal Q of the QR decomposition of DPi * B; what
+     is left over goes into r. The box of the parcel is then
+     the hull of the set, within the image of its old box.
+
+     The set is started again from the box whenever the box
+     changes otherwise: when it is split, switches
+     transversal, leaves the cube at the origin, or is the
+     hull of several parcels.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#ifndef LOHNER_H
+#define LOHNER_H
+
+#include "classes.h"
+
+////////////////////////////////////////////////////////////////////
+
+void Set_Lohner   (const bool &);
+
+bool Lohner       ();
+
+bool Lohner_Kept  (const parcel &);
+
+void Lohner_Start (parcel &);
+
+bool Lohner_Step  (parcel &, const IMatrix &, const BOX &);
+
+////////////////////////////////////////////////////////////////////
+
+#endif // LOHNER_H
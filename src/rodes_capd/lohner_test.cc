@@ -0,0 +1,308 @@
+/*   File: lohner_test.cc
+
+     Checks the sets of '--lohner' (see 'lohner.h') over
+     several steps, by Taylor series and by the corner
+     method (with 'Flow_Point' for the center). A few
+     boxes on the plane z = 27 (flowing down) are flowed
+     LOHNER_STEPS steps of LOHNER_DIST, as 'Flow' does it.
+     Before every step, points of the set c + C * r0 + B * r
+     are taken (r0 and r at their corners, their centers
+     and at random points), and after it
+
+       - those of them that were in the box of the parcel,
+         flowed by 'Point_Flow' (see 'point_flow.h'), must
+         lie in the new box (which is the hull of the new
+         set, within the image of the old box);
+       - so must the corners, the center and random points
+         of the first box, flowed along.
+
+     The others are outside the image of the box, and are
+     only counted. The set may be lost (and started again
+     from the box), but not at every step.
+
+     Usage: lohner_test [order] [points]
+            (default 20 and 100; order 0 is the corner
+            method only)
+
+     Compilation: make lohner_test
+
+     Latest edit: Sat Oct 17 2026
+*/
+
+#include <iostream>
+#include <cstdlib>
+
+#include "classes.h"
+#include "error_handler.h"
+#include "lohner.h"
+#include "point_flow.h"
+#include "return_map.h"
+#include "taylor.h"
+#include "workspace.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+const double LOHNER_LEVEL = 27.0;  // The plane of the boxes.
+const double LOHNER_DIST  = 0.5;   // The distance of each step.
+const int    LOHNER_STEPS = 8;
+
+////////////////////////////////////////////////////////////////////
+
+static int  flow_box     (const double [], const int &);
+static bool step         (parcel &);
+static int  set_points   (long double [][SYSDIM], const parcel &, const int &);
+static int  check_points (long double [][SYSDIM], const int &, const parcel &,
+			  const char *);
+static void set_point    (BOX &, const doubleton &, const short &, const int &);
+static void sample       (long double [], const BOX &, const short &, const int &);
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: none
+// Calls to : 'Set_Lohner', 'Set_Taylor_Order', 'flow_box'
+int main(int argc, char *argv[])
+{
+  int order  = ( argc >= 2 ? atoi(argv[1]) : 20 );
+  int points = ( argc >= 3 ? atoi(argv[2]) : 100 );
+  if ( argc > 3 || order < 0 || order > TAYLOR_MAX_ORDER || points < 0 )
+    {
+      cout << endl << "Usage: " << endl;
+      cout << "\t" << argv[0] << " [order] [points]\n\n"
+	   << "\twhich checks the sets of --lohner over " << LOHNER_STEPS
+	   << " steps by Taylor series\n"
+	   << "\tof [order] (default 20, at most " << TAYLOR_MAX_ORDER
+	   << "; 0 for the corner method)\n"
+	   << "\tand by the corner method, at their corners, centers and\n"
+	   << "\t[points] (default 100) random points.\n" << endl;
+      exit(0);
+    }
+
+  // The centers (x1, x2) and radii of the boxes.
+  const double boxes[][3] = { { 1.0,  1.0, 1e-3 },
+			      { 1.0,  1.0, 1e-2 },
+			      { 3.0, -2.0, 1e-2 } };
+  const int    BOXES = sizeof(boxes) / sizeof(boxes[0]);
+  const int    orders[] = { order, 0 };
+
+  int errors = 0;
+  Set_Lohner(true);
+  srand(1);
+  for ( int m = 0; m < ( order > 0 ? 2 : 1 ); m++ )
+    {
+      Set_Taylor_Order(orders[m]);
+      for ( int b = 0; b < BOXES; b++ )
+	errors += flow_box(boxes[b], points);
+    }
+  cout << "lohner sets: " << ( errors == 0 ? "ok" : "FAILED" ) << endl;
+  return ( errors == 0 ? 0 : 1 );
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main'
+// Calls to : 'Lohner_Start', 'sample', 'set_points', 'step',
+//            'check_points'
+// Flows the box (center (x1, x2), radius) by LOHNER_STEPS steps, and
+// checks the set of the parcel in each. Returns the number of errors
+// found.
+static int flow_box(const double box[], const int &points)
+{
+  const int   n  = CORNERS + 1 + points;
+  const int   m  = CORNERS * CORNERS + 1 + points;
+  const short tr = 2;
+  long double (*x)[SYSDIM] = new long double[n][SYSDIM];
+  long double (*y)[SYSDIM] = new long double[m][SYSDIM];
+  parcel pcl;
+  int kept = 0, outside = 0, errors = 0;
+
+  pcl.box    = BOX(SYSDIM);
+  pcl.box(1) = Hull(box[0] - box[2], box[0] + box[2]);
+  pcl.box(2) = Hull(box[1] - box[2], box[1] + box[2]);
+  pcl.box(3) = LOHNER_LEVEL;
+  pcl.trvl    = tr + 1;
+  pcl.sign    = -1;
+  pcl.time    = 0.0;
+  pcl.message = 0;
+  for ( int k = 0; k < n; k++ )
+    sample(x[k], pcl.box, tr, k);
+
+  cout << ( Taylor_Order() > 0 ? "taylor" : "corner" ) << ", box " << pcl.box << ": ";
+  try
+    {
+      for ( int s = 0; s < LOHNER_STEPS; s++ )
+	{
+	  if ( !Lohner_Kept(pcl) )
+	    Lohner_Start(pcl);
+	  int in = set_points(y, pcl, points);
+	  outside += m - in;
+	  if ( step(pcl) )
+	    kept++;
+	  errors += check_points(y, in, pcl, "of the set");
+	  errors += check_points(x, n, pcl, "of the first box");
+	}
+    }
+  catch( Error_Handler error )
+    {
+      error.Print_Message();
+      cout << "Error: could not flow the box." << endl;
+      errors++;
+    }
+  cout << "the set was kept in " << kept << " of " << LOHNER_STEPS
+       << " steps, to " << pcl.box << " (" << outside << " of "
+       << LOHNER_STEPS * m << " points of the sets outside the boxes)" << endl;
+  if ( kept == 0 )
+    {
+      cout << "Error: the set was lost in every step." << endl;
+      errors++;
+    }
+  delete [] x;
+  delete [] y;
+  return errors;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'flow_box'
+// Calls to : 'Lohner_Kept', 'Lohner_Start', 'Taylor_Step',
+//            'Corner_Step', 'Lohner_Step'
+// A step of 'Flow' (return_map) with '--lohner', by LOHNER_DIST.
+// Returns false if the set was lost in the step.
+static bool step(parcel &pcl)
+{
+  IMatrix  DPi(SYSDIM, SYSDIM);
+  BOX      Tight_Box(SYSDIM), center(SYSDIM), center_image(SYSDIM);
+  interval time;
+  double   achieved;
+
+  if ( !Lohner_Kept(pcl) )
+    Lohner_Start(pcl);
+  center = pcl.set.c;
+  if ( Taylor_Order() == 0 ||
+       !Taylor_Step(Tight_Box, time, DPi, achieved, pcl, LOHNER_DIST,
+		    &center, &center_image) )
+    Corner_Step(Tight_Box, time, DPi, pcl, LOHNER_DIST, &center, &center_image);
+
+  pcl.box = Tight_Box;
+  pcl.time += time;
+  if ( !Lohner_Step(pcl, DPi, center_image) )
+    {
+      pcl.set = doubleton(); // Start again from the box.
+      return false;
+    }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'flow_box'
+// Calls to : 'set_point'
+// Puts the sample points of the set of pcl that lie in pcl.box
+// (their midpoints) into y, and returns how many there are.
+static int set_points(long double y[][SYSDIM], const parcel &pcl, const int &points)
+{
+  const short tr = pcl.trvl - 1;
+  BOX x(SYSDIM);
+  int in = 0;
+
+  for ( int k = 0; k < CORNERS * CORNERS + 1 + points; k++ )
+    {
+      set_point(x, pcl.set, tr, k);
+      bool inside = true;
+      for ( short i = 0; i < SYSDIM; i++ )
+	{
+	  y[in][i] = ( i == tr ? Inf(pcl.box[i]) : Mid(x[i]) );
+	  if ( y[in][i] < Inf(pcl.box[i]) || y[in][i] > Sup(pcl.box[i]) )
+	    inside = false;
+	}
+      if ( inside )
+	in++;
+    }
+  return in;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'flow_box'
+// Calls to : 'Point_Flow', 'Point_Inside'
+// Flows the n points x to the plane of pcl.box, and checks that
+// they land in it. Returns the number of those that do not.
+static int check_points(long double x[][SYSDIM], const int &n, const parcel &pcl,
+			const char *which)
+{
+  const short       tr    = pcl.trvl - 1;
+  const long double level = Inf(pcl.box[tr]);  // Inf == Sup.
+  long double t;
+  int errors = 0;
+
+  for ( int k = 0; k < n; k++ )
+    {
+      Point_Flow(x[k], t, pcl.trvl, level);
+      bool in = true;
+      for ( short i = 0; i < SYSDIM; i++ )
+	if ( i != tr && !Point_Inside(pcl.box[i], x[k][i]) )
+	  in = false;
+      if ( !in && errors++ < 3 )
+	cout << endl << "Error: the image (" << (double) x[k][0] << ", "
+	     << (double) x[k][1] << ", " << (double) x[k][2] << ") of a point "
+	     << which << " is not in " << pcl.box << endl;
+    }
+  return errors;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'set_points'
+// Calls to : 'sample', 'Mult_Add'
+// The k:th sample point c + C * r0 + B * r of the set s (as a box, by
+// interval arithmetic): r0 and r at each pair of their corners first,
+// then both at their centers, then at random points.
+static void set_point(BOX &x, const doubleton &s, const short &tr, const int &k)
+{
+  BOX r0(SYSDIM), r(SYSDIM);
+  long double p0[SYSDIM], p[SYSDIM];
+
+  if ( k < CORNERS * CORNERS )
+    {
+      sample(p0, s.r0, tr, k % CORNERS);
+      sample(p,  s.r,  tr, k / CORNERS);
+    }
+  else
+    {
+      sample(p0, s.r0, tr, k - CORNERS * CORNERS + CORNERS);
+      sample(p,  s.r,  tr, k - CORNERS * CORNERS + CORNERS);
+    }
+  for ( short i = 0; i < SYSDIM; i++ )
+    {
+      r0[i] = (double) p0[i];
+      r[i]  = (double) p[i];
+    }
+  Mult_Add(x, s.c, s.C, r0);
+  Mult_Add(x, x, s.B, r);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'flow_box', 'set_point'
+// The k:th sample point of 'box': its corners (in the coordinates
+// other than tr) first, then its center, then random points.
+static void sample(long double x[], const BOX &box, const short &tr, const int &k)
+{
+  short bit = 0;
+
+  for ( short i = 0; i < SYSDIM; i++ )
+    {
+      const interval &side = box[i];
+      if ( i == tr )
+	x[i] = Mid(side);
+      else if ( k < CORNERS )
+	x[i] = ( (k >> bit++) & 1 ? Sup(side) : Inf(side) );
+      else if ( k == CORNERS )
+	x[i] = Mid(side);
+      else
+	x[i] = Inf(side) + (Sup(side) - Inf(side)) * ((long double) rand() / RAND_MAX);
+    }
+}
+
+////////////////////////////////////////////////////////////////////
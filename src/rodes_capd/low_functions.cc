@@ -7,13 +7,16 @@
 */
 
 #include "low_functions.h"
+#include "vf_batch.h"
+#include "workspace.h"
+#include "trace.h"
 
 ////////////////////////////////////////////////////////////////////
 
-static void LU_Decompose    (IMatrix &, const IMatrix &, int *);
+static void LU_Decompose    (IMatrix &, const IMatrix &, int *, IVector &);
 
-static void LU_Backsub      (IVector &, const IMatrix &, int *,
-			     const IVector &);
+static void LU_Backsub      (BOX &, const IMatrix &, int *,
+			     const BOX &);
 
 static void Invert_And_Mult (IMatrix &, const IMatrix &,
 			     const IMatrix &);
@@ -69,7 +72,9 @@ void Some_May_Vanish(BOX &result, const IMatrix &DPi,
 					    // IVectors below. ? What
 					    // is the scope of this
 					    // declaration ?
-    BOX *Poincare = new ( SYSDIM ) IVector [ 2 ]; // we want two vectors with number of spatial coords = SYSDIM
+    BOX *Poincare = Thread_Workspace().poincare; // we want two vectors with number of spatial coords = SYSDIM
+    Poincare [ 0 ].clear();  // The workspace is reused, so start
+    Poincare [ 1 ].clear();  // from zero as a fresh vector would.
   
     // trvl \in {1,2,...SYSDIM}, so shift trvl by -1
     if ( pcl.sign == - 1 )     // Set the trvl coordinates
@@ -82,18 +87,18 @@ void Some_May_Vanish(BOX &result, const IMatrix &DPi,
     double   start;
     interval local_dist;
     BOX      vf;
-    BOX *Side_Box = new ( SYSDIM )IVector [ 2 ];
+    BOX *Side_Box = Thread_Workspace().side_box;
   
   for (register short i = 1; i <= SYSDIM; i++)  
     if ( i != trvl )         
       { // Loop through i (i is the component-coordinate)
 
 	Side_Box[0] = Outer_Box;	// Make Side_Box (lower)	
-	Side_Box[0][i] = Inf ( Inner_Box [ i ] ) + dx [ i ];
+	Side_Box[0](i) = Inf ( Inner_Box(i) ) + dx(i);
 	
 	Side_Box[1] = Outer_Box;	// Make Side_Box (upper) 
 	// apply necessary distortion to box
-	Side_Box[1] [ i ] = Sup(Inner_Box[i]) + dx[i];	    
+	Side_Box[1](i) = Sup(Inner_Box(i)) + dx(i);	    
 	
 	for (register short j = 1; j <= SYSDIM; j++) 
 	  { // Loop through j (j is the partial derivative-coordinate)
@@ -103,33 +108,34 @@ void Some_May_Vanish(BOX &result, const IMatrix &DPi,
 	      for (register short k = 0; k < 2; k++)
 		{ // Loop through k (k represents upper and lower box)	
 		  if ( k == 0 )	 
-		    start = Inf(Inner_Box[i]); // Get the initial value
+		    start = Inf(Inner_Box(i)); // Get the initial value
 		  else
-		    start = Sup(Inner_Box[i]);
+		    start = Sup(Inner_Box(i));
 		  
 		  if ( Subset(0.0, DPi(i, j)) == true )	
 		    {    // compute min/max P[i] in the side boxes  
 		      Vf_Range(vf, Side_Box[k]);
-		      local_dist = sign_trvl_dist * vf[i] / vf[ trvl ];  // interval
-		      Poincare[k][i] = start + local_dist; // double + interval
+		      local_dist = sign_trvl_dist * vf(i) / vf(trvl);  // interval
+		      Poincare[k](i) = start + local_dist; // double + interval
 		    }   
 		  else   // Compute min/max P[i] at the corners
 		    { // Construct the small corner boxes 
 		      //BOX Corner_Box ( 2 ); 
-		      BOX *Corner_Box = new ( SYSDIM ) IVector [ 2 ];
+		      BOX *Corner_Box = Thread_Workspace().corner_box;
+		      BOX *Corner_Vf  = Thread_Workspace().corner_box_vf;
 		      interval iv[2];
   
 		      Corner_Box[0] = Side_Box[k];
-		      Corner_Box[0][ j ] = Inf(Inner_Box[ j ]) + dx[ j ];    
+		      Corner_Box[0](j) = Inf(Inner_Box(j)) + dx(j);    
 		      Corner_Box[1] = Side_Box[k];
-		      Corner_Box[1][ j ] = Sup(Inner_Box[ j ]) + dx[ j ];	       
+		      Corner_Box[1](j) = Sup(Inner_Box(j)) + dx(j);	       
 
+		      Vf_Range_Batch(Corner_Vf, Corner_Box, 2); // Both at once.
 		      for (register short m = 0; m < 2; m++)
 			{ // m indicates the Corner_Box in use
-			  Vf_Range(vf, Corner_Box[m]);  
-			  iv[m] = vf[i] / vf[ trvl ];	
+			  iv[m] = Corner_Vf[m](i) / Corner_Vf[m](trvl);	
 			}	    
-		      Poincare[k][i] = start + sign_trvl_dist 
+		      Poincare[k](i) = start + sign_trvl_dist 
 			* intervalHull(iv[0], iv[1]);
 		    } // Done with the corners
 		}
@@ -139,8 +145,8 @@ void Some_May_Vanish(BOX &result, const IMatrix &DPi,
   // Instead of adding function, just do the conversion here
     dInf = Inf ( Poincare[0] ); 
     dSup = Sup ( Poincare[1] );
-    IVector pInf ( dInf );
-    IVector pSup ( dSup );
+    BOX pInf ( dInf );
+    BOX pSup ( dSup );
     result = intervalHull ( pInf, pSup );
 }
 
@@ -155,15 +161,16 @@ void None_May_Vanish(BOX &result, const parcel &pcl, const BOX &Outer_Box,
     register short i, j;
     double lo_coord, hi_coord;
     // allotting space for array of DVectors ( n = POWER )
-    DVector *point_in = new ( SYSDIM ) DVector [ POWER ];  // Storage for the corner points -- we need 2^(d-1) corners for the in points
-    DVector *point_out = new ( SYSDIM ) DVector [ POWER ]; // Storage for the corner points 
+    workspace &ws = Thread_Workspace();
+    DVector *point_in = ws.point_in;   // Storage for the corner points -- we need 2^(d-1) corners for the in points
+    DVector *point_out = ws.point_out; // Storage for the corner points 
     DVector current_point ( SYSDIM ); 
     
     // DVector point_in[POWER];  
     // DVector point_out[POWER];   << --- ***** THIS UTILIZES BUILT IN Int_Power() Will have to fils ASAP.
    
-    BOX *corner_in = new ( SYSDIM ) BOX [ POWER ];
-    BOX *corner_out = new ( SYSDIM ) BOX [ POWER ];
+    BOX *corner_in = ws.corner_in;
+    BOX *corner_out = ws.corner_out;
 
     // BOX corner_in[POWER];     // Storage for the corner boxes -- similar number of corner intervals needed as in point_in
     // BOX corner_out[POWER];    // Storage for the corner boxes 
@@ -217,24 +224,25 @@ void None_May_Vanish(BOX &result, const parcel &pcl, const BOX &Outer_Box,
 	  }               // Now the corners are stored in 
       }                   // corner_out[i], i = 0,...,2^(SYSDIM - 1) - 1.
 
+  BOX *vf = ws.corner_out_vf; // The field over all the corners at once.
+  Vf_Range_Batch(vf, corner_out, corner_out_cnt);
+
   i = 0; // Just for symmetric definitions
-  BOX vf(SYSDIM);  Vf_Range(vf, corner_out[i]);
-  interval corner_time = sign_trvl_dist / vf[ trvl-1 ];
+  interval corner_time = sign_trvl_dist / vf[i][ trvl-1 ];
 
   // jjb -- This is odd: DVector + ( interval * IVector )
   // From PROFIL doc: REAL or VECTOR operands may also be used instead
   // of interval operands, as long as one operand is an INTERVAL type.
     
-  // Convert DVector to IVector (singletons)
-    IVector dp ( point_out[i] );  // point_out[0], since i==0
-    result = dp + ( corner_time * vf ); // A bit wasteful seeing that I don't use the trvl coord.
+  // Convert DVector to BOX (singletons)
+    BOX dp ( point_out[i] );  // point_out[0], since i==0
+    result = dp + ( corner_time * vf[i] ); // A bit wasteful seeing that I don't use the trvl coord.
                                             // Probably faster to use add an inner loop:
     // Use dp here, too
   for (i = 1; i < POWER; i++)               // for (k = 1; k <= SYSDIM; k++)
     {                                       //   if ( k != trvl )
-      Vf_Range(vf, corner_out[ i-1 ]);          //     result(k) = point_out[i](k) + corner_time * vf(k);
-      corner_time = sign_trvl_dist / vf[ trvl-1 ];   
-      result = intervalHull(result, point_out[ i-1 ] + corner_time * vf);  // ** this is passing ivec and interval
+      corner_time = sign_trvl_dist / vf[i][ trvl-1 ];   
+      result = intervalHull(result, BOX(point_out[ i ]) + corner_time * vf[i]);  // ** this is passing ivec and interval
     }
 
   if ( pcl.sign == 1 )
@@ -256,8 +264,6 @@ void Flow_By_Corner_Method(BOX &Result_Box, const IMatrix &DPi,
     BOX dx = capd::vectalg::intervalHull ( SubBounds( Inf( Outer_Box ), Inf( pcl.box ) ),
 					   SubBounds( Sup( Outer_Box ), Sup( pcl.box ) ) );
 
-    cout << "    ** FLOW_BY_CORNER_METHOD():dx = " << dx << endl;
-
   bool zero_indicator = false;     // Check for possible zeroes of the
   for (register short i = 1; i <= SYSDIM; i++)    
     {
@@ -284,27 +290,60 @@ void Flow_By_Corner_Method(BOX &Result_Box, const IMatrix &DPi,
     double trvl_dist = Diam( dx[ pcl.trvl - 1] );   // Get the transversal distance
     if ( pcl.sign == -1 )
       trvl_dist = - trvl_dist;
+    TRACE(2, TRACE_CORNER_DX, pcl, dx, trvl_dist, 0.0);
 
-    if ( zero_indicator ) {
+    if ( zero_indicator )
       Some_May_Vanish(Result_Box, DPi, pcl, Outer_Box, dx, trvl_dist);
-      cout << "       ** zero : " << Result_Box << endl;
-    }
-    else {
+    else
       None_May_Vanish(Result_Box, pcl, Outer_Box, dx, trvl_dist);    
-      cout << "       ** non-zero : " << Result_Box << endl;
-      
+    TRACE(2, TRACE_CORNER_BOX, pcl, Result_Box, zero_indicator, 0.0);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by 'Flow' (for 'Lohner_Step').
+// Flows the point 'center' of pcl.box to the opposite transversal
+// side of Outer_Box, as a corner in 'None_May_Vanish': it moves by
+// at most dx, within Outer_Box.
+void Flow_Point(BOX &Result_Box, const BOX &center, const parcel &pcl,
+		const BOX &Outer_Box)
+{
+    short trvl = pcl.trvl;    // Shorthand
+    BOX dx = capd::vectalg::intervalHull ( SubBounds( Inf( Outer_Box ), Inf( pcl.box ) ),
+					   SubBounds( Sup( Outer_Box ), Sup( pcl.box ) ) );
+    BOX Point_Box = Outer_Box;
+    BOX vf(SYSDIM);
+
+  for (register short i = 1; i <= SYSDIM; i++)
+    if ( i != trvl )
+      Point_Box(i) = center(i) + dx(i);
+  if ( !Intersection(Point_Box, Point_Box, Outer_Box) )
+    {
+      char *msg = "Error: 'Flow_Point'. The point is not in the box!";
+      throw Error_Handler(msg);
     }
+  Vf_Range(vf, Point_Box);
+
+  double trvl_dist = Diam( dx[ trvl-1 ] );
+  if ( pcl.sign == -1 )
+    trvl_dist = - trvl_dist;
+  interval point_time = trvl_dist / vf(trvl);
 
+  Result_Box = center + point_time * vf;
+  if ( pcl.sign == 1 )
+    Result_Box[ trvl-1 ] = interval(Sup(Outer_Box[ trvl-1 ]));
+  else
+    Result_Box[ trvl-1 ] = interval(Inf(Outer_Box[ trvl-1] ));
 }
 
 ////////////////////////////////////////////////////////////////////
 
-static void LU_Decompose(IMatrix &R, const IMatrix &A, int *indx)
+// 'vv' is scratch storage for the implicit scaling.
+static void LU_Decompose(IMatrix &R, const IMatrix &A, int *indx, IVector &vv)
 {
   register int i, j, k, imax;
   double big, dummy;
-  static interval temp, sum;
-  static IVector vv ( SYSDIM );
+  interval temp, sum;
 
   R = A; // Copy A into R
 
@@ -374,30 +413,31 @@ static void LU_Decompose(IMatrix &R, const IMatrix &A, int *indx)
 
 ////////////////////////////////////////////////////////////////////
 
-static void LU_Backsub( IVector &r, const IMatrix &A, int *indx,
-			const IVector &b )
+// The vectors are indexed 1,..., SYSDIM, as the matrix is.
+static void LU_Backsub( BOX &r, const IMatrix &A, int *indx,
+			const BOX &b )
 {
   register int i, j, ip;
-  static interval sum;
+  interval sum;
 
   r = b;
   for (i = 1; i <= SYSDIM; i++)  // Start with the forward substitution.
     {
       ip = indx[i];           // We unscramble the permutation  
       sum = r(ip);            // as we go...
-      r(ip) = r [ i ];
+      r(ip) = r(i);
       if ( i != 1 )
 	for (j = 1; j <= i - 1; j++)
-	  sum -= A(i, j) * r[ j ];
-      r[i] = sum;
+	  sum -= A(i, j) * r(j);
+      r(i) = sum;
     }
 
   for (i = SYSDIM; i >= 1; i--) // Now we do the backsubstitution.
     {
-     sum = r[i];  
+     sum = r(i);  
      for (j = i + 1; j <= SYSDIM; j++)
-       sum -= A(i, j) * r[ j ];
-     r[i] = sum / A(i, i);  // Store the component of the solution vector.
+       sum -= A(i, j) * r(j);
+     r(i) = sum / A(i, i);  // Store the component of the solution vector.
     }
 }
 
@@ -407,17 +447,14 @@ static void LU_Backsub( IVector &r, const IMatrix &A, int *indx,
 static void Invert_And_Mult(IMatrix &Result, const IMatrix &A,
 			    const IMatrix &B)
 {
-    static int indx[SYSDIM + 1];
-    static IVector Result_IV;  // jjb -- this holds results in
-			       // LU_Backsub(), so no need to fix a size
-    static IMatrix LU_IM ( SYSDIM, SYSDIM );
+    workspace &ws = Thread_Workspace();
 
-  LU_Decompose(LU_IM, A, indx);
+  LU_Decompose(ws.lu_matrix, A, ws.lu_indx, ws.lu_vv);
   for (register short j = 1; j <= SYSDIM; j++)
     {
       // *** Col ( ) defined in classes.h, wraps IMatrix method. ***
-      LU_Backsub( Result_IV, LU_IM, indx, Col ( B, j ) );
-      SetCol( Result, j, Result_IV );
+      LU_Backsub( ws.lu_result, ws.lu_matrix, ws.lu_indx, Col ( B, j ) );
+      SetCol( Result, j, ws.lu_result );
     }
 }
 
@@ -454,7 +491,9 @@ void Get_DPhi_Matrix(IMatrix &DPhi, const BOX &Outer_Box,
     // jjb -- Delta_Matrix is not sized at this point
     Invert_And_Mult( Delta_Matrix, (ID - tDVf_copy), tDVf );
     IMatrix Exp_M ( ID + Delta_Matrix ); 
-    IMatrix Pic ( ID + time * DVf * Exp_M ); 
+    IMatrix Pic;
+    Mult(Pic, DVf, Exp_M);
+    Pic = ID + time * Pic;
 
   if ( !Intersection(DPhi, Pic,  Exp_M) )
     {
@@ -31,6 +31,9 @@ void None_May_Vanish       (BOX &, const parcel &, const BOX &,
 void Flow_By_Corner_Method (BOX &, const IMatrix &,
 			    const parcel &, const BOX &);
 
+void Flow_Point            (BOX &, const BOX &, const parcel &,
+			    const BOX &);
+
 void Get_DPhi_Matrix       (IMatrix &, const BOX &, const interval &);
 
 ////////////////////////////////////////////////////////////////////
@@ -0,0 +1,91 @@
+/*   File: point_flow.cc
+
+     The flow of a single point. See 'point_flow.h'.
+
+     Latest edit: Sat Oct 17 2026
+*/
+
+#include <cmath>
+
+#include "point_flow.h"
+#include "vector_field.h"
+
+////////////////////////////////////////////////////////////////////
+
+static void field (long double [], const long double []);
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'check_points' (taylor_test, lohner_test)
+// Calls to : 'field'
+// Flows x (on a plane x_trvl = const) to the plane x_trvl = level, by
+// the Runge-Kutta method of order 4 in the transversal coordinate s:
+//   dx_i/ds = f_i / f_trvl,   dt/ds = 1 / f_trvl.
+// The steps are such that x moves by about REF_STEP. Returns the
+// time it took in t.
+void Point_Flow(long double x[], long double &t, const short &trvl,
+		const long double &level)
+{
+  const short tr = trvl - 1;
+  long double k[4][SYSDIM + 1], y[SYSDIM], f[SYSDIM];
+
+  t = 0.0;
+  while ( x[tr] != level )
+    {
+      field(f, x);
+      long double norm = 0.0;
+      for ( short i = 0; i < SYSDIM; i++ )
+	if ( fabsl(f[i]) > norm )
+	  norm = fabsl(f[i]);
+      long double h = REF_STEP * fabsl(f[tr]) / norm;
+      if ( h >= fabsl(level - x[tr]) )
+	h = level - x[tr];
+      else if ( level < x[tr] )
+	h = - h;
+
+      for ( short stage = 0; stage < 4; stage++ )
+	{
+	  long double c = ( stage == 0 ? 0.0 : stage == 3 ? 1.0 : 0.5 );
+	  for ( short i = 0; i < SYSDIM; i++ )
+	    y[i] = x[i] + ( stage == 0 ? 0.0 : c * h * k[stage - 1][i] );
+	  field(f, y);
+	  for ( short i = 0; i < SYSDIM; i++ )
+	    k[stage][i] = f[i] / f[tr];
+	  k[stage][SYSDIM] = 1.0 / f[tr];
+	}
+      for ( short i = 0; i < SYSDIM; i++ )
+	if ( i != tr )
+	  x[i] += h * (k[0][i] + 2.0 * k[1][i] + 2.0 * k[2][i] + k[3][i]) / 6.0;
+      t += h * (k[0][SYSDIM] + 2.0 * k[1][SYSDIM] + 2.0 * k[2][SYSDIM] + k[3][SYSDIM]) / 6.0;
+      x[tr] = ( h == level - x[tr] ? level : x[tr] + h );
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'Point_Flow'
+// The vector field (see 'vector_field.h'), in long double.
+static void field(long double f[], const long double x[])
+{
+  static const long double e1 = Mid(E1_IV), e2 = Mid(E2_IV), e3 = Mid(E3_IV);
+  static const long double k1 = Mid(K1_IV), k2 = Mid(K2_IV), k3 = Mid(K3_IV);
+  long double sum = x[0] + x[1];
+
+  f[0] = e1 * x[0] - k1 * sum * x[2];
+  f[1] = e2 * x[1] + k1 * sum * x[2];
+  f[2] = e3 * x[2] + sum * (k2 * x[0] + k3 * x[1]);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'check_points' (taylor_test, lohner_test)
+// Calls to : none
+// Is x in iv, up to the error of 'Point_Flow'?
+bool Point_Inside(const interval &iv, const long double &x)
+{
+  long double tolerance = REF_TOLERANCE * (1.0 + fabsl(x));
+
+  return ( Inf(iv) - tolerance <= x && x <= Sup(iv) + tolerance );
+}
+
+////////////////////////////////////////////////////////////////////
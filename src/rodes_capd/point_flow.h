@@ -0,0 +1,32 @@
+/*   File: point_flow.h
+
+     The flow of a single point, for 'taylor_test' and
+     'lohner_test': by the Runge-Kutta method of order 4,
+     in long double and with small steps. It is not
+     rigorous, but far more accurate than the enclosures
+     of the integrator are wide, so a point flowed here
+     must land in them (up to REF_TOLERANCE).
+
+     Latest edit: Sat Oct 17 2026
+*/
+
+#ifndef POINT_FLOW_H
+#define POINT_FLOW_H
+
+#include "classes.h"
+
+////////////////////////////////////////////////////////////////////
+
+const double REF_STEP      = 1e-3;  // How far a point moves in a step.
+const double REF_TOLERANCE = 1e-9;  // The (relative) error we allow.
+
+////////////////////////////////////////////////////////////////////
+
+void Point_Flow   (long double [], long double &, const short &,
+		   const long double &);
+
+bool Point_Inside (const interval &, const long double &);
+
+////////////////////////////////////////////////////////////////////
+
+#endif // POINT_FLOW_H
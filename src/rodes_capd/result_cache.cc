@@ -0,0 +1,238 @@
+/*   File: result_cache.cc
+
+     The returns of the grids done, kept on disk.
+     See 'result_cache.h'.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "result_cache.h"
+#include "checkpoint.h"
+#include "lohner.h"
+#include "return_map.h"
+#include "taylor.h"
+#include "zone.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+static std::string cache_dir;    // Empty when there is no cache.
+static std::string config_hash;  // Of what decides the returns.
+
+static unsigned long fnv_hash   (const std::string &, const bool &);
+static std::string   hash_text  (const std::string &);
+static void          put_double (ostream &, const double &);
+static std::string   grid_key   (const iterate &, const int &);
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_the_options' (rodes), once all options are set
+// Calls to : 'hash_text', 'put_double'
+// Keeps the returns in the directory 'dir' (made if need be). The
+// integrator's configuration is hashed here, once and for all.
+void cache_open(const char *dir)
+{
+  if ( mkdir(dir, 0777) != 0 && errno != EEXIST )
+    {
+      cout << "Warning: could not make the cache directory " << dir
+	   << "; running without it." << endl;
+      return;
+    }
+  cache_dir = dir;
+
+  std::ostringstream config;
+  config << "version " << CACHE_VERSION
+	 << " taylor " << Taylor_Order()
+	 << " lohner " << Lohner()
+	 << " fixed " << Fixed_Steps();
+#ifdef COMPUTE_C1
+  config << " C1";
+#endif
+#ifdef HOISTED_ROUNDING
+  config << " up";
+#endif
+  config << " stop " << STOP_TRANSVERSAL << " " << STOP_SIGN;
+  put_double(config, STOP_DIST_LEVEL);
+  put_double(config, Get_Scale_Factor());
+  put_double(config, STEP_GROW);
+  put_double(config, STEP_MARGIN);
+  put_double(config, STEP_MAX_GROWTH);
+  put_double(config, STEP_MAX_TIME);
+  put_double(config, STEP_MIN_SHARE);
+  config << " " << TAYLOR_HALVINGS << " " << TAYLOR_TRIES;
+  put_double(config, TAYLOR_INFLATE);
+  for ( int zone = 1; zone <= ZONES; zone++ )
+    {
+      put_double(config, Get_Zone_Parameters(zone).max_size);
+      put_double(config, Get_Zone_Parameters(zone).more_than_one);
+    }
+  config_hash = hash_text(config.str());
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'work_on_grid' (rodes)
+// Calls to : 'grid_key', 'hash_text', 'read_parcels'
+// Returns true if the grid of 'it' was done before, with the hull
+// of its returns in 'hull', and its image iterates (grids of 2^-power)
+// in it_List (as made by 'pcl_List_to_it_List').
+bool cache_lookup(const iterate &it, const int &power, parcel &hull,
+		  List<iterate> &it_List)
+{
+  if ( cache_dir.empty() )
+    return false;
+
+  std::string key  = grid_key(it, power);
+  std::string name = cache_dir + "/" + hash_text(key);
+  std::ifstream InFile(name.c_str(), ios::in);
+  std::string tag, line;
+  int version = 0, count = -1;
+
+  if ( !(InFile >> tag >> version) || tag != "RODES-CACHE" ||
+       version != CACHE_VERSION || !(InFile >> tag) || tag != "key" ||
+       !getline(InFile, line) || line != " " + key )
+    return false; // Not there (or another key of the same hash).
+
+  List<parcel>  hull_List;
+  List<iterate> temp_List;
+  if ( !read_parcels(InFile, "hull", hull_List) || Length(hull_List) != 1 ||
+       !(InFile >> tag >> count) || tag != "images" || count < 0 )
+    {
+      cout << "Warning: ignored the damaged cache file " << name << endl;
+      return false;
+    }
+  for ( int n = 0; n < count; n++ )
+    {
+      iterate image;
+      if ( !(InFile >> image) )
+	{
+	  cout << "Warning: ignored the damaged cache file " << name << endl;
+	  return false;
+	}
+      temp_List += image;
+    }
+  if ( !(InFile >> tag) || tag != "end" )
+    {
+      cout << "Warning: ignored the damaged cache file " << name << endl;
+      return false;
+    }
+
+  hull = First(hull_List);
+  Append(it_List, temp_List);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'work_on_grid' (rodes)
+// Calls to : 'grid_key', 'hash_text', 'write_parcels'
+// Keeps the returns of the grid of 'it': the hull of its returns,
+// and its image iterates (grids of 2^-power) in it_List.
+void cache_store(const iterate &it, const int &power, const parcel &hull,
+		 List<iterate> &it_List)
+{
+  if ( cache_dir.empty() )
+    return;
+
+  std::string key  = grid_key(it, power);
+  std::string name = cache_dir + "/" + hash_text(key);
+  std::ostringstream temp_name;
+  temp_name << name << "_new." << getpid() << "." << (unsigned long) pthread_self();
+
+  std::ofstream OutFile(temp_name.str().c_str(), ios::out);
+  List<parcel> hull_List;
+  hull_List += hull;
+
+  OutFile << "RODES-CACHE " << CACHE_VERSION << "\n"
+	  << "key " << key << "\n";
+  write_parcels(OutFile, "hull", hull_List);
+  OutFile << "images " << Length(it_List) << "\n";
+  if ( !IsEmpty(it_List) )
+    {
+      First(it_List);
+      while ( !Finished(it_List) )
+	{
+	  OutFile << Current(it_List) << "\n";
+	  Next(it_List);
+	}
+    }
+  OutFile << "end" << endl;
+  OutFile.close();
+
+  if ( !OutFile || rename(temp_name.str().c_str(), name.c_str()) != 0 )
+    {
+      cout << "Warning: could not write the cache file " << name << endl;
+      unlink(temp_name.str().c_str());
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// The key of the grid of 'it': "<u> <v> <P> <config_hash>", the
+// power of the images if it is not P (see '--refine' in 'rodes'),
+// and in C1 mode the angles of its cone.
+static std::string grid_key(const iterate &it, const int &power)
+{
+  std::ostringstream key;
+
+  key << it.ndl.grd.u << " " << it.ndl.grd.v << " " << it.ndl.grd.P
+      << " " << config_hash;
+  if ( power != it.ndl.grd.P )
+    key << " images " << power;
+#ifdef COMPUTE_C1
+  put_double(key, Inf(it.ndl.ang));
+  put_double(key, Sup(it.ndl.ang));
+#endif
+  return key.str();
+}
+
+////////////////////////////////////////////////////////////////////
+
+// FNV-1a (32 bits) of the text, read forwards or backwards.
+static unsigned long fnv_hash(const std::string &text, const bool &backwards)
+{
+  unsigned long hash = 2166136261UL;
+  const unsigned n = text.size();
+
+  for ( unsigned i = 0; i < n; i++ )
+    {
+      hash ^= (unsigned char) text[backwards ? n - 1 - i : i];
+      hash = (hash * 16777619UL) & 0xffffffffUL;
+    }
+  return hash;
+}
+
+// Both hashes in hexadecimal: enough to spread the keys over the
+// file names (the key itself is checked by 'cache_lookup').
+static std::string hash_text(const std::string &text)
+{
+  char hex[40];
+
+  snprintf(hex, sizeof(hex), "%08lx%08lx",
+	   fnv_hash(text, false), fnv_hash(text, true));
+  return hex;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// " <x>", exactly (in hexadecimal, as in 'checkpoint.cc').
+static void put_double(ostream &out, const double &x)
+{
+  char text[40];
+
+  snprintf(text, sizeof(text), " %a", x);
+  out << text;
+}
+
+////////////////////////////////////////////////////////////////////
@@ -0,0 +1,54 @@
+/*   File: result_cache.h
+
+     The returns of the grids done, kept on disk across runs
+     (with 'rodes --cache <dir>'). A rerun (from another
+     seed rectangle, or with another ANG_FACTOR in C0 mode)
+     mostly asks for the same grids again; 'work_on_grid'
+     then takes their images from the cache instead of
+     calling 'Compute_the_return'.
+
+     Each grid done has a file <dir>/<key hash>, named by
+     the FNV-1a hash of its key: the grid (u, v, P), the
+     power of its images (if not P), in C1 mode its cone
+     of angles, and a hash of everything that decides what
+     the integrator returns (the options, the zone table,
+     and the constants of the integrator). The file holds
+
+       RODES-CACHE <version>
+       key <key>
+       hull 1                  followed by the hull of the
+                               returns (as in 'checkpoint.h'),
+       images <n>              followed by n image iterates,
+       end
+
+     Files are written next to their place and renamed into
+     it, so any number of processes may share the directory.
+     Grids that failed are not kept. After a change to the
+     integrator that changes its results, bump CACHE_VERSION
+     (or start a new directory).
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include "2d_classes.h"
+#include "classes.h"
+#include "list.h"
+
+////////////////////////////////////////////////////////////////////
+
+const int CACHE_VERSION = 1;
+
+////////////////////////////////////////////////////////////////////
+
+void cache_open   (const char *);
+
+bool cache_lookup (const iterate &, const int &, parcel &, List<iterate> &);
+
+void cache_store  (const iterate &, const int &, const parcel &, List<iterate> &);
+
+////////////////////////////////////////////////////////////////////
+
+#endif // RESULT_CACHE_H
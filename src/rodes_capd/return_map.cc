@@ -6,7 +6,60 @@
      Latest edit: Mon Apr 10 2000 
 */
 
+#include <algorithm>
+#include <vector>
+
 #include "return_map.h"
+#include "flow_pool.h"
+#include "lohner.h"
+#include "taylor.h"
+#include "trace.h"
+#include "workspace.h"
+#include "zone.h"
+
+////////////////////////////////////////////////////////////////////
+
+// What 'Flow_One_Parcel' needs besides the parcel.
+typedef struct
+{
+  const stop_parameters *sp;
+  double max_size;
+  double more_than_one;
+  double max_size_over_three;
+  double max_size_over_ten;
+} flow_context;
+
+// Set by 'Set_Flow_Threads': the threads flowing the parcels of a grid.
+static int flow_threads = 1;
+
+// Set by 'Set_Fixed_Steps': no step size control.
+static bool fixed_steps = false;
+
+// Predicts the trvl_dist of the next step of a parcel from its last
+// one. A step clipped by 'Get_Flow_Time' (Outer_Box was too thin for
+// it) tells where the next one would be clipped: about as far, times
+// the widening of the box. We try a little less, which spares
+// 'Get_Flow_Time' a second range of the vector field. After a full
+// step we try STEP_GROW times further, up to that clip, unless the
+// step widened the box by more than STEP_MAX_GROWTH, or its time has
+// a relative diameter over STEP_MAX_TIME. The steps stay within
+// [STEP_MIN_SHARE, 1] * max_d_step, and whatever cannot be measured
+// sends us back to max_d_step. With 'fixed_steps', a step is as long
+// as the last one (max_d_step, until decreased), as it used to be.
+class step_control
+{
+ public:
+  step_control(const double &max_d_step)
+    : ceiling(max_d_step), dist(max_d_step), clip(0.0) {}
+
+  double next  () const { return dist; }
+  void   taken (const double &, const double &, const double &, const double &);
+
+ private:
+  double ceiling;  // max_d_step
+  double dist;     // The next step.
+  double clip;     // Where it would be clipped (0 if not known).
+};
 
 ////////////////////////////////////////////////////////////////////
 
@@ -15,11 +68,15 @@ static bool   Switching         (const parcel &,       short  &, const double &)
 static void   Build_Switch_Box  (const parcel &, const short  &,       BOX    &, const double &);
 static bool   Switch_Box_True   (const parcel &,       short  &, const BOX    &);
 static bool   Stop              (const parcel &, const double &, const stop_parameters &);
-static void   Flow              (      parcel &, const double &);
+static void   Flow              (      parcel &, const double &, step_control &);
 static void   Update_Transversal(      parcel &, const short  &, const double &,
 				 const double &, const double &, const double &);
-static void   Flow_The_Parcel   (const parcel &, List<parcel> &,
-				 const stop_parameters &, const double &, const double &);
+static void   Flow_One_Parcel   (      parcel &, List<parcel> &, List<parcel> &, void *);
+static void   Flow_The_Parcel   (List<parcel> &, List<parcel> &,
+				 const stop_parameters &, const double &, const double &,
+				 checkpoint *);
+static bool   Parcel_Before     (const parcel &, const parcel &);
+static void   Sort_Parcels      (List<parcel> &);
 static void   Set_Max_Size      (      double &,       double &, const parcel &);
 
 ////////////////////////////////////////////////////////////////////
@@ -38,35 +95,82 @@ static bool Too_Large(const parcel &pcl, const double &size)
 
 ////////////////////////////////////////////////////////////////////
 
-// Called by 'Flow_The_Parcel'.
-// Splits the box of pcl into
-// pieces of side length in [0.5, 1] * size
+// Called by 'Multiple_Partition'.
+// The j-th of the n cuts of [lo, hi] into pieces of equal length
+// (up to rounding): lo for j = 0, and hi exactly for j = n.
+static inline double Cut(const double &lo, const double &hi,
+			 const int &j, const int &n)
+{
+  return ( j == n ? hi : lo + j * ((hi - lo) / n) );
+}
+
+// Called by 'Multiple_Partition'.
+// Checks that none of the n pieces of [lo, hi] is too large, as
+// 'Too_Large' will see them.
+static bool Pieces_Fit(const double &lo, const double &hi,
+		       const int &n, const double &size)
+{
+  for (register int j = 0; j < n; j++)
+    if ( Cut(lo, hi, j + 1, n) - Cut(lo, hi, j, n) > size )
+      return false;
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by 'Flow_The_Parcel', 'Update_Transversal' and 'Divide'.
+// Splits the box of pcl into pieces of side length in [0.5, 1] * size,
+// which are added to the end of PSinit. The number of pieces along
+// each side is worked out first (the fewest that are not too large),
+// and the pieces are made in one go.
 void Multiple_Partition(const parcel &pcl, List<parcel> &PSinit,
 			const double &size)
 {
-  bool no_split = false;    // true when no BOX was split
-  int  n_in;                // Number of elements of PSinit
-  parcel tmp_pcl;           // Temporary storage 
-#if defined(__sparc)
-  List<parcel> DummyList;
-#endif
+  double lo[SYSDIM], hi[SYSDIM]; // The sides of the box,...
+  int    pieces[SYSDIM];         // ...the pieces along each of them,
+  int    at[SYSDIM];             // and the piece being made.
+  long   count = 1;              // The number of pieces.
 
-  PSinit += pcl;
-  while ( !no_split )
-    { // At least one BOX was split
-      n_in = Length(PSinit);
-      no_split = true;
-      for(register int i = 0; i < n_in; i++)
-	{ // Loop through PSinit
-	  tmp_pcl = First(PSinit);
-	  RemoveCurrent(PSinit);
-	  if ( Too_Large(tmp_pcl, size) )
-	    {
-	      Single_Partition(tmp_pcl, PSinit, size);
-	      no_split = false;
-	    }
-	  else // put it back at the end
-	    PSinit += tmp_pcl;
+  for (register short i = 0; i < SYSDIM; i++)
+    {
+      lo[i] = Inf(pcl.box[i]);
+      hi[i] = Sup(pcl.box[i]);
+      pieces[i] = 1;
+      at[i] = 0;
+      if ( i + 1 == pcl.trvl || !(hi[i] - lo[i] > size) ) // As 'Too_Large'.
+	continue;
+
+      double n = ceil((hi[i] - lo[i]) / size);
+      if ( !(n * count <= MAX_PIECES) ) // Also for an unbounded box.
+	{
+	  char *msg = "Error: 'Multiple_Partition'. Too many pieces!";
+	  throw Error_Handler(msg);
+	}
+      pieces[i] = (int) n;
+      while ( !Pieces_Fit(lo[i], hi[i], pieces[i], size) ) // Rounding.
+	pieces[i]++;
+      count *= pieces[i];
+    }
+
+  workspace &ws = Thread_Workspace();
+  ws.stats.multiple_partitions++;
+  ws.stats.pieces += count;
+
+  parcel piece = pcl;
+  for (long k = 0; k < count; k++)
+    {
+      for (register short i = 0; i < SYSDIM; i++)
+	if ( pieces[i] > 1 )
+	  piece.box[i] = interval(Cut(lo[i], hi[i], at[i], pieces[i]),
+				  Cut(lo[i], hi[i], at[i] + 1, pieces[i]));
+      PSinit += piece;
+
+      for (register short i = SYSDIM - 1; i >= 0; i--) // The next piece.
+	{
+	  if ( ++at[i] < pieces[i] )
+	    break;
+	  at[i] = 0;
 	}
     }
 }
@@ -157,19 +261,53 @@ static bool Stop(const parcel &pcl, const double &dist, const stop_parameters &s
 
 ////////////////////////////////////////////////////////////////////
 
-// Called by 'Flow_The_Parcel'.
-// Flows the parcel as far as possible, but
-// not by more than 'trvl_dist' at a time.
-static void Flow(parcel &pcl, const double &trvl_dist)
+// Called by 'Flow'.
+// 'requested' is the trvl_dist of the step, 'achieved' how far it
+// went, 'growth' the widening of the box, and 'time_width' the
+// relative diameter of its time.
+void step_control::taken(const double &requested, const double &achieved,
+			 const double &growth, const double &time_width)
+{
+  if ( fixed_steps )
+    {
+      dist = requested;
+      return;
+    }
+  if ( !(achieved > 0.0 && achieved < HUGE_VAL) ||  // Also false for NaN.
+       !(growth > 0.0 && growth < HUGE_VAL) ||
+       !(time_width >= 0.0 && time_width < HUGE_VAL) )
+    {
+      dist = ceiling; // The fixed step.
+      clip = 0.0;
+      return;
+    }
+
+  if ( achieved < requested )
+    clip = achieved * growth;
+  else
+    clip *= growth;
+  if ( growth > STEP_MAX_GROWTH || time_width > STEP_MAX_TIME )
+    dist = achieved;
+  else
+    dist = achieved * STEP_GROW;
+  if ( clip > 0.0 )
+    dist = Min(dist, clip * STEP_MARGIN);
+  dist = Min(dist, ceiling);
+  if ( dist < ceiling * STEP_MIN_SHARE )
+    dist = ceiling * STEP_MIN_SHARE;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by 'Flow', and by 'taylor_test'.
+// The step by 'Flow_By_Corner_Method', in an Outer_Box trimmed by
+// 'Get_Flow_Time' (which may change pcl.message, and nothing else of
+// pcl). Returns how far it went; the rest is returned by reference,
+// as by 'Taylor_Step'.
+double Corner_Step(BOX &Tight_Box, interval &time, IMatrix &DPi,
+		   parcel &pcl, const double &trvl_dist,
+		   const BOX *center, BOX *center_image)
 {
-  static parcel result = pcl;  // Pass on the unchanged pieces by copying.
-
-    #ifdef DEBUG
-    cout << endl;
-    cout << "IN FLOW()" << endl;
-    cout << "result = " << result.box << endl;
-    #endif
-    
   BOX Outer_Box(SYSDIM);
 
   double mid, rad;   
@@ -185,24 +323,14 @@ static void Flow(parcel &pcl, const double &trvl_dist)
       {
 	rad = (Sup(pcl.box[i-1]) - Inf(pcl.box[i-1])) / 2.0;
 	mid = Inf(pcl.box[i-1]) + rad;
-	rad *= SCALE_FACTOR;
+	rad *= Get_Scale_Factor(); // SCALE_FACTOR, or see 'Read_Zones'.
 	Outer_Box[ i-1 ] = Hull(mid - rad, mid + rad);
       }
 
-    interval time;
-
-    cout << "  Flow():OB = " << Outer_Box << endl;
-
-    Get_Flow_Time(time, result, trvl_dist, Outer_Box);
-
-    #ifdef DEBUG
-    cout << "Flow():time = " << time << endl;
-    #endif
+  double achieved = Get_Flow_Time(time, pcl, trvl_dist, Outer_Box);
+  TRACE(2, TRACE_FLOW_TIME, pcl, Outer_Box, Inf(time), Sup(time));
 
   // Now, we tighten the enclosure...
-  IMatrix DPi( SYSDIM, SYSDIM );
-  BOX Tight_Box;
-
   BOX Image = pcl.box + time * Vf_Range(Outer_Box);
   if ( pcl.sign == 1 )
     Image [ pcl.trvl-1 ] = Hull(Sup( Outer_Box[ pcl.trvl-1 ] ));
@@ -212,22 +340,70 @@ static void Flow(parcel &pcl, const double &trvl_dist)
   Get_DPi_Matrix(DPi, Outer_Box, pcl.trvl, time, Image);
 
   Flow_By_Corner_Method(Tight_Box, DPi, pcl, Outer_Box);
+  if ( center != NULL )
+    Flow_Point(*center_image, *center, pcl, Outer_Box);
+  return achieved;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by 'Flow_The_Parcel'.
+// Flows the parcel as far as possible, but
+// not by more than 'trvl_dist' at a time:
+// by Taylor series when selected (see 'taylor.h'),
+// and otherwise by the corner method. With '--lohner'
+// the set of the parcel is flowed as well (see 'lohner.h').
+// Tells 'ctl' how it went.
+static void Flow(parcel &pcl, const double &trvl_dist, step_control &ctl)
+{
+  IMatrix DPi( SYSDIM, SYSDIM );
+  BOX Tight_Box( SYSDIM );
+  BOX center( SYSDIM ), center_image( SYSDIM );
+  const BOX *set_center = NULL;
+  interval time;
+  double achieved;
 
-    cout << "  after flow by corner Flow():OB = " << Outer_Box << endl;
-    cout << "  -->Flow():TB = " << Tight_Box << endl;
+  Thread_Workspace().stats.flow_steps++;
+  TRACE(1, TRACE_FLOW, pcl, pcl.box, trvl_dist, 0.0);
+
+  if ( Lohner() )
+    {
+      if ( !Lohner_Kept(pcl) ) // The box was changed since.
+	Lohner_Start(pcl);
+      center = pcl.set.c;
+      set_center = &center;
+    }
+  // The parcel is updated in place: only its box (kept here for the
+  // growth), time, message and set change.
+  BOX Start_Box = pcl.box;
+
+  if ( Taylor_Order() > 0 &&
+       Taylor_Step(Tight_Box, time, DPi, achieved, pcl, trvl_dist,
+		   set_center, &center_image) )
+    {
+      if ( achieved == trvl_dist && pcl.message == CLOSE_STOP )
+	pcl.message = STOP; // As in 'Get_Flow_Time'.
+    }
+  else
+    achieved = Corner_Step(Tight_Box, time, DPi, pcl, trvl_dist,
+			   set_center, &center_image);
 
 #ifdef COMPUTE_C1  // ...and flow the tangent vectors
-  Flow_Tangent_Vectors(result, pcl.sign*pcl.trvl, pcl.sign*pcl.trvl, DPi);
+  Flow_Tangent_Vectors(pcl, pcl.sign*pcl.trvl, pcl.sign*pcl.trvl, DPi);
 #endif
 
-  result.box = Tight_Box;  // Update the outgoing result
-  result.time += time;
-  pcl = result;
+  pcl.box = Tight_Box;  // Update the outgoing parcel
+  if ( set_center != NULL && !Lohner_Step(pcl, DPi, center_image) )
+    pcl.set = doubleton(); // Start again from the box.
 
-    #ifdef DEBUG
-    cout << "pcl.box = " << pcl.box << endl;
-    #endif
+  double growth = 0.0;     // The widening of the box.
+  for ( register short i = 1; i <= SYSDIM; i++ )
+    if ( i != pcl.trvl && Diam(pcl.box[i-1]) > growth * Diam(Start_Box[i-1]) )
+      growth = Diam(pcl.box[i-1]) / Diam(Start_Box[i-1]);
+  ctl.taken(trvl_dist, achieved, growth, Diam(time) / Mig(time));
 
+  pcl.time += time;
+  TRACE(1, TRACE_STEP, pcl, pcl.box, Inf(pcl.time), Sup(pcl.time));
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -239,140 +415,150 @@ static void Update_Transversal(parcel &pcl, const short &trvl, const double &max
 			       const double &max_size_over_three, 
 			       const double &max_size_over_ten, const double &more_than_one)
 {
-  parcel result  = pcl;
   short new_trvl = abs(trvl);  
   short new_sign = Sign(trvl);
   stop_parameters stop_pmtr;
 
+  Thread_Workspace().stats.switches++;
+
   stop_pmtr.max_d_step = max_size_over_ten; // Set the stop parameters
   stop_pmtr.trvl  = new_trvl;
   stop_pmtr.sign  = new_sign;             
   if ( new_sign == 1 )
-    stop_pmtr.level = Sup(pcl.box[ new_trvl ]);
+    stop_pmtr.level = Sup(pcl.box( new_trvl ));
   else
-    stop_pmtr.level = Inf(pcl.box[ new_trvl ]);
+    stop_pmtr.level = Inf(pcl.box( new_trvl ));
 
   // Split pcl into several small pieces -> Start_List, 
   // whose elements are flowed separately to the plane.
   List<parcel> Start_List, Stop_List, Image_List;
-  parcel current_pcl;
   BOX Temp_Switch_Box(SYSDIM);
 
   Multiple_Partition(pcl, Start_List, max_size_over_three);
-  First(Start_List);
-  while ( !Finished(Start_List) )
-    { // Work through Start_List
-      current_pcl = Current(Start_List);
+  while ( !IsEmpty(Start_List) )
+    { // Work through Start_List, and empty it.
+      parcel &current_pcl = First(Start_List);
       Build_Switch_Box(current_pcl, new_trvl, Temp_Switch_Box, more_than_one);	
       Switch_Transversal(current_pcl, trvl, Temp_Switch_Box);
 
-      if ( stop_pmtr.level == Sup(current_pcl.box[ new_trvl ]) ) // Sup = Inf
-	Stop_List += current_pcl; //No need to flow
+      if ( stop_pmtr.level == Sup(current_pcl.box( new_trvl )) ) // Sup = Inf
+	MoveFirst(Start_List, Stop_List); //No need to flow
       else   // Here we make a call to 'Local_Flow_The_Parcel', which flows
 	{    // the parcel straight to the new trvl plane.  
 	  Local_Flow_The_Parcel(current_pcl, Image_List, stop_pmtr, max_size); 
-	  while ( !IsEmpty(Image_List) )                       
-	    { // Work through Image_List, and delete it.    
-	      Stop_List += First(Image_List);
-	      RemoveCurrent(Image_List);
-	    }
+	  Append(Stop_List, Image_List);
+	  --Start_List;
 	}
-      Next(Start_List);
     }
-  Get_Hull(result, Stop_List);
-  result.message = 0;
+  Get_Hull(pcl, Stop_List);
+  pcl.message = 0;
+}
+
+////////////////////////////////////////////////////////////////////
 
-  pcl = result;
+// Called by 'Flow_The_Parcel' (and, with several threads, 'flow_pool').
+// Flows pcl until it returns, which puts it in Return_List, or until
+// it is split, switches transversal, or enters the cube at the origin,
+// which puts the pieces still to flow at the end of More_List.
+// pcl is flowed in place (what is left of it is of no further use).
+static void Flow_One_Parcel(parcel &pcl, List<parcel> &More_List,
+			    List<parcel> &Return_List, void *context)
+{
+  const flow_context &fc = *(const flow_context *) context;
+  short        trvl;     // The new direction when switching.
+  double       dist;     // The trvl distance we attempt to flow
+  BOX          sw_box;   // The box used for switching transversals
+  step_control ctl(fc.sp->max_d_step);
+
+  while (1) // Enter the flow loop
+    { 
+      if ( Too_Large(pcl, fc.max_size) ) // If the box is too large, we 
+	{                                // partition it sufficiently.
+	  Multiple_Partition(pcl, More_List, fc.max_size);
+	  break;
+	}
+      if ( Switching(pcl, trvl, fc.more_than_one) ) // If we have a possible switching
+	{                                           // situation, we attempt to switch.
+	  Build_Switch_Box(pcl, trvl, sw_box, fc.more_than_one);
+	  if ( Switch_Box_True(pcl, trvl, sw_box) )	
+	    {
+	      Update_Transversal(pcl, trvl, fc.max_size, fc.max_size_over_three,
+				 fc.max_size_over_ten, fc.more_than_one);
+	      More_List += pcl; 
+	    }
+	  else 
+	    // jjb -- Need Max of { [a,a], [b,b], [c,c] } to get max radius
+	    Multiple_Partition ( pcl, More_List, Max ( diam ( pcl.box ) ) / 2.0 );
+	  break;                             
+	}
+      if ( pcl.message == STOP ) // If we we have completed a full
+	{                        // return, we store the parcel.
+	  TRACE(1, TRACE_STOP, pcl, pcl.box, Inf(pcl.time), Sup(pcl.time));
+	  Thread_Workspace().stats.returns++;
+	  Return_List += pcl;
+	  break;
+	}
+      dist = ctl.next();
+      if ( Stop(pcl, fc.sp->max_d_step, *fc.sp) ) // If we are close to a return
+	{                                         // we decrease the trvl_dist.
+	  dist = fabs(Sup(pcl.box(pcl.trvl) - fc.sp->level));
+	  pcl.message = CLOSE_STOP;
+	}
+      if ( Inf(Norm2(pcl.box)) < 1.0 ) // Improves accuracy near the fixed point.       
+	dist = Min(( fixed_steps ? fc.sp->max_d_step : dist ), Inf(Norm2(pcl.box)) / 10.0);
+      if ( Cube_Entry(pcl) ) // If we enter the cube containing the origin
+	{                    // we explicitly compute the outgoing image(s).
+	  TRACE(1, TRACE_CUBE_ENTRY, pcl, pcl.box, 0.0, 0.0);
+	  Cube_Exit(pcl, More_List, fc.max_size);
+	  break;
+	}
+      Flow(pcl, dist, ctl); // If none of the situations        
+    }                       // above occured, we flow along.
 }
 
 ////////////////////////////////////////////////////////////////////
 
 // Called by 'Compute_the_return'.
-// Flows in_pcl until the stopping condition is met.
+// Flows the parcels of In_List until the stopping condition is met.
 // All parcels constituting the pseudo-image are returned by reference
 // in Return_List. Any error in a lower function is handled
 // by catching (in 'rodes') the thrown exception.
-static void Flow_The_Parcel(const parcel &in_pcl, List<parcel> &Return_List,
+// Now and then the state is saved in 'ckpt' (unless NULL).
+// With 'flow_threads' > 1 the parcels are flowed by a 'flow_pool'.
+// With HOISTED_ROUNDING, the rounding must still be upward.
+static void Flow_The_Parcel(List<parcel> &In_List, List<parcel> &Return_List,
 			    const stop_parameters &sp, const double &max_size,
-			    const double &more_than_one)
+			    const double &more_than_one, checkpoint *ckpt)
 {
-  short        trvl;     // The new direction when switching.
-  double       dist;     // The trvl distance we attempt to flow
-  BOX          sw_box;   // The box used for switching transversals
-  parcel       pcl;      // The parcel from In_List under computation
-  List<parcel> In_List;  // All intermediate images of in_pcl
+  flow_context fc;
 
+#ifdef HOISTED_ROUNDING
+  Check_Rounding(); // The pool's threads inherit it.
+#endif
+  fc.sp            = &sp;
+  fc.max_size      = max_size;
+  fc.more_than_one = more_than_one;
   // Special constants used in 'Update_Transversal'.
-  double max_size_over_three = max_size / 3.00;
-  double max_size_over_ten   = max_size / 10.0;
+  fc.max_size_over_three = max_size / 3.00;
+  fc.max_size_over_ten   = max_size / 10.0;
 
-  In_List += in_pcl; 
-  
+  if ( flow_threads > 1 )
+    {
+      flow_pool pool(flow_threads, Flow_One_Parcel, &fc);
+      pool.run(In_List, Return_List, sp, ckpt);
+      return;
+    }
+
+  List<parcel> Work_List; // The parcel being flowed, out of In_List.
   while( !IsEmpty(In_List) )
     {  // Loop through all of In_List  
-      pcl = First(In_List);
-      RemoveCurrent(In_List);
-      dist = sp.max_d_step;
-
-      while (1) // Enter the flow loop
-	{ 
-	  if ( Too_Large(pcl, max_size) ) // If the box is too large, we 
-	    {                             // partition it sufficiently.
-	      Multiple_Partition(pcl, In_List, max_size);
-	      break;
-	    }
-	  if ( Switching(pcl, trvl, more_than_one) ) // If we have a possible switching
-	    {                                        // situation, we attempt to switch.
-	      Build_Switch_Box(pcl, trvl, sw_box, more_than_one);
-	      if ( Switch_Box_True(pcl, trvl, sw_box) )	
-		{
-		  Update_Transversal(pcl, trvl, max_size, max_size_over_three,
-				     max_size_over_ten, more_than_one);
-		  In_List += pcl; 
-		}
-	      else 
-		// jjb -- Need Max of { [a,a], [b,b], [c,c] } to get max radius
-		Multiple_Partition ( pcl, In_List, Max ( diam ( pcl.box ) ) / 2.0 );
-	      break;                             
-	    }
-	  if ( pcl.message == STOP ) // If we we have completed a full
-	    {                        // return, we store the parcel.
-               #ifdef DEBUG
-	      cout << "STOP" << endl;
-	      #endif
-
-	      Return_List += pcl;
-	      break;
-	    }
-	  if ( Stop(pcl, sp.max_d_step, sp) ) // If we are close to a return
-	    {                                 // we decrease the trvl_dist.
-	      dist = fabs(Sup(pcl.box(pcl.trvl) - sp.level));
-	      pcl.message = CLOSE_STOP;
-	    }
-	  if ( Inf(Norm2(pcl.box)) < 1.0 ) // Improves accuracy near the fixed point.       
-	    dist = Min(sp.max_d_step, Inf(Norm2(pcl.box)) / 10.0);
-	  if ( Cube_Entry(pcl) ) // If we enter the cube containing the origin
-	    {                    // we explicitly compute the outgoing image(s).
-	      #ifdef DEBUG
-	      cout << "cube_Entry()" << endl;
-	      #endif
-
-	      Cube_Exit(pcl, In_List, max_size);
-	      break;
-	    }
-
-	  #ifdef DEBUG
-	  cout << endl;
-	  cout << "before flow(): pcl.box = " << pcl.box << endl;
-	  #endif
-
-	  Flow(pcl, dist); // If none of the situations        
-	  
-	  #ifdef DEBUG
-	  cout << "pcl.box = " << pcl.box << endl;
-	  #endif
-	}                  // above occured, we flow along.
+      if ( ckpt != NULL && ckpt->due() ) // Between two parcels, all
+	ckpt->write(sp, In_List, Return_List); // of the state is here.
+      MoveFirst(In_List, Work_List);
+      Flow_One_Parcel(First(Work_List), In_List, Return_List, &fc);
+      --Work_List;
     }
+  Thread_Workspace().stats.note_peak(MaxLength(In_List));
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -388,36 +574,38 @@ void Local_Flow_The_Parcel(const parcel &in_pcl, List<parcel> &Return_List,
 {
   double       dist;     // The trvl distance we attempt to flow
   BOX          sw_box;   // The box used for switching transversals
-  parcel       pcl;      // The parcel from In_List under computation
   List<parcel> In_List;  // All intermediate images of in_pcl
+  List<parcel> Work_List; // The parcel under computation, out of In_List
 
   In_List += in_pcl; 
   
   while( !IsEmpty(In_List) )
     {  // Loop through all of In_List  
-      pcl = First(In_List);
-      RemoveCurrent(In_List);
-      dist = sp.max_d_step;
+      MoveFirst(In_List, Work_List);
+      parcel &pcl = First(Work_List);
+      step_control ctl(sp.max_d_step);
 
       while (1) // Enter the flow loop
 	{ 
 	  if ( Too_Large(pcl, max_size) ) // If the box is too large, we 
 	    {                             // partition it sufficiently.
 	      Multiple_Partition(pcl, In_List, max_size);
+	      --Work_List;
 	      break;
 	    }
 	  if ( pcl.message == STOP ) // If we we have completed a full
 	    {                        // return, we store the parcel.
-	      Return_List += pcl;
+	      MoveFirst(Work_List, Return_List);
 	      break;
 	    }
+	  dist = ctl.next();
 	  if ( Stop(pcl, sp.max_d_step, sp) ) // If we are close to a return
 	    {                                 // we decrease the trvl_dist.
 	      dist = fabs(Sup(pcl.box(pcl.trvl) - sp.level));
 	      pcl.message = CLOSE_STOP;
 	    }
-	  Flow(pcl, dist); // If none of the situations        
-	}                  // above occured, we flow along.
+	  Flow(pcl, dist, ctl); // If none of the situations        
+	}                       // above occured, we flow along.
     }
 }
 
@@ -428,59 +616,12 @@ void Local_Flow_The_Parcel(const parcel &in_pcl, List<parcel> &Return_List,
 // Also sets the variable 'more_than_one'.
 static void Set_Max_Size(double &max_size, double &more_than_one, const parcel &pcl)
 {
-  double x = Mid(pcl.box(1));
-  double y = Mid(pcl.box(2));
-
-  more_than_one = 1.1; // The default value used almost everywhere,
-
-  if ( 5 * y < 2 * x ) // Reflect onto upper branch.
-    x = - x;
-
-  if ( x > + 4.5 )        // Zone #1  [+4.5, +inf]
-    max_size = 0.010; 
-  else if ( x > + 4.0 )   // Zone #2  [+4.0, +4.5]
-    max_size = 0.012;
-  else if ( x > + 3.5 )   // Zone #3  [+3.5, +4.0]
-    max_size = 0.015;
-  else if ( x > + 3.0 )   // Zone #4  [+3.0, +3.5]
-    max_size = 0.019; 
-  else if ( x > + 2.5 )   // Zone #5  [+2.5, +3.0]
-    max_size = 0.024; 
-  else if ( x > + 2.0 )   // Zone #6  [+2.0, +2.5]
-    max_size = 0.030; 
-  else if ( x > + 1.5 )   // Zone #7  [+1.5, +2.0]
-    max_size = 0.032; 
-  else if ( x > + 1.0 )   // Zone #8  [+1.0, +1.5]
-    max_size = 0.035; 
-  else if ( x > + 0.5 )   // Zone #9  [+0.5, +1.0] - contains W^s(0).
-    max_size = 0.040; 
-  else if ( x > + 0.0 )   // Zone #10 [+0.0, +0.5]
-    max_size = 0.035; 
-  else if ( x > - 1.0 )   // Zone #11 [-1.0, +0.0]
-    max_size = 0.032; 
-  else if ( x > - 2.0 )   // Zone #12 [-2.0, -1.0]
-    max_size = 0.029; 
-  else if ( x > - 3.0 )   // Zone #13 [-3.0, -2.0]
-    max_size = 0.026; 
-  else if ( x > - 4.0 )   // Zone #14 [-4.0, -3.0]
-    max_size = 0.023;    
-  else                    // Zone #15 [-4.296875, -4.0]
-    max_size = 0.020;  
-
-  if ( x < - 1100 / 256.0 )   // Zone #16 [-4.36328125, -4.296875]     
-    {
-      more_than_one = 1.2; // Here we use a slightly larger value.
-      max_size = 0.015; 
-    }
-  if ( x < - 1118 / 256.0 )   // Zone #17 [-inf, -4.36328125]   
-    {
-      more_than_one = 1.3; // Here we use a slightly larger value.
-      max_size = 0.012; 
-    } 
+  const zone_parameters &zone = Get_Zone_Parameters(Get_Zone(Mid(pcl.box(1)),
+							     Mid(pcl.box(2))));
 
-  cout << "max_size = " << max_size << "; "; 
-  cout << "more_than_one = " << more_than_one << "; "; 
-  cout.flush();
+  max_size      = zone.max_size;      // See 'zone.cc' for the table.
+  more_than_one = zone.more_than_one; // 1.1 almost everywhere.
+  TRACE(1, TRACE_RESOLUTION, pcl, pcl.box, max_size, more_than_one);
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -490,11 +631,14 @@ static void Set_Max_Size(double &max_size, double &more_than_one, const parcel &
 // Computes the image set of the parcel w.r.t. the global stopping 
 // parameters, "glob_stop_param". The image set is returned by reference
 // via Return_List. If any error occurs, an exception is thrown to be 
-// caught in the calling function.
-void Compute_the_return(const parcel &current_pcl, List<parcel> &Return_List)
+// caught in the calling function. With a checkpoint 'ckpt' of this
+// parcel, we carry on from where it was written.
+void Compute_the_return(const parcel &current_pcl, List<parcel> &Return_List,
+			checkpoint *ckpt)
 {
   stop_parameters glob_stop_param;
   double max_size, max_dist_step, more_than_one;
+  List<parcel> In_List; // All intermediate images of current_pcl
 
   // Set the resolution depending on where we are.
   Set_Max_Size(max_size, more_than_one, current_pcl);
@@ -506,7 +650,80 @@ void Compute_the_return(const parcel &current_pcl, List<parcel> &Return_List)
   glob_stop_param.sign       = STOP_SIGN;
   glob_stop_param.max_d_step = max_dist_step;
 
-  Flow_The_Parcel(current_pcl, Return_List, glob_stop_param, max_size, more_than_one);
+  if ( ckpt == NULL || !ckpt->resume(glob_stop_param, In_List, Return_List) )
+    In_List += current_pcl;
+  Flow_The_Parcel(In_List, Return_List, glob_stop_param, max_size, more_than_one, ckpt);
+  Sort_Parcels(Return_List);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_the_options' (rodes)
+// Calls to : none
+// Sets the number of threads flowing the parcels of one grid.
+void Set_Flow_Threads(const int &nr_threads)
+{
+  flow_threads = ( nr_threads > 1 ? nr_threads : 1 );
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_the_options' (rodes)
+// Calls to : none
+// With 'fixed', the steps are not controlled (see 'step_control').
+void Set_Fixed_Steps(const bool &fixed)
+{
+  fixed_steps = fixed;
+}
+
+// Called by: 'cache_open' (result_cache)
+// Calls to : none
+bool Fixed_Steps()
+{
+  return fixed_steps;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by 'Sort_Parcels'.
+// The order of the returns: by the transversal, the box, and then
+// the time. Parcels equal in all of these are the same.
+static bool Parcel_Before(const parcel &a, const parcel &b)
+{
+  if ( a.trvl != b.trvl )
+    return ( a.trvl < b.trvl );
+  if ( a.sign != b.sign )
+    return ( a.sign < b.sign );
+  for ( short i = 1; i <= SYSDIM; i++ )
+    {
+      if ( Inf(a.box(i)) != Inf(b.box(i)) )
+	return ( Inf(a.box(i)) < Inf(b.box(i)) );
+      if ( Sup(a.box(i)) != Sup(b.box(i)) )
+	return ( Sup(a.box(i)) < Sup(b.box(i)) );
+    }
+  if ( Inf(a.time) != Inf(b.time) )
+    return ( Inf(a.time) < Inf(b.time) );
+  return ( Sup(a.time) < Sup(b.time) );
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by 'Compute_the_return'.
+// Each parcel is flowed the same way whatever the order (or thread)
+// it is flowed in, so once they are sorted the returns are the same
+// for any number of threads, and with or without a checkpoint.
+static void Sort_Parcels(List<parcel> &pcl_List)
+{
+  std::vector<parcel> sorted;
+
+  while ( !IsEmpty(pcl_List) )
+    {
+      sorted.push_back(First(pcl_List));
+      RemoveCurrent(pcl_List);
+    }
+  std::stable_sort(sorted.begin(), sorted.end(), Parcel_Before);
+  for ( unsigned k = 0; k < sorted.size(); k++ )
+    pcl_List += sorted[k];
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -9,6 +9,7 @@
 #ifndef RETURN_MAP_H
 #define RETURN_MAP_H
 
+#include "checkpoint.h"
 #include "classes.h"
 #include "error_handler.h"
 #include "fixed_point.h"
@@ -18,8 +19,15 @@
 
 ////////////////////////////////////////////////////////////////////
 
-// Integrator parameters
-const double SCALE_FACTOR  = 1.1;          // Used in "Flow' for the coarse enclosure.
+// The step size control (see 'step_control' in return_map.cc)
+const double STEP_GROW       = 2.0;        // After a good step, try this much further.
+const double STEP_MARGIN     = 0.95;       // The share of a predicted clip we try.
+const double STEP_MAX_GROWTH = 1.1;        // A poor step widens the box more than this,
+const double STEP_MAX_TIME   = 0.1;        // or has a time of a wider relative diameter.
+const double STEP_MIN_SHARE  = 1.0 / 64.0; // Of 'max_d_step': the shortest step tried.
+
+// The most pieces 'Multiple_Partition' cuts a box into.
+const long   MAX_PIECES      = 1L << 20;
 
 // Stopping parameters
 const double STOP_DIST_LEVEL  =  27.0;
@@ -28,13 +36,22 @@ const short  STOP_TRANSVERSAL =  3;
 
 ////////////////////////////////////////////////////////////////////
 
-void Compute_the_return   (const parcel &, List<parcel> &);
+void Compute_the_return   (const parcel &, List<parcel> &, checkpoint * = NULL);
 
 void Local_Flow_The_Parcel(const parcel &, List<parcel> &,
 			   const stop_parameters &, const double &);
 
 void Multiple_Partition   (const parcel &, List<parcel> &, const double &);
 
+double Corner_Step        (BOX &, interval &, IMatrix &, parcel &, const double &,
+			   const BOX * = NULL, BOX * = NULL);
+
+void Set_Flow_Threads     (const int &);
+
+void Set_Fixed_Steps      (const bool &);
+
+bool Fixed_Steps          ();
+
 ////////////////////////////////////////////////////////////////////
 
 #endif // RETURN_MAP_H
@@ -14,29 +14,42 @@
 #include <iostream>
 #include <fstream>
 #include <cstdlib>
+#include <sstream>
 #include <string>
+#include <vector>
 #include <ctime>
 
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/time.h>
+
 #include "2d_classes.h"
+#include "checkpoint.h"
 #include "classes.h"
 #include "convert.h"
+#include "cost.h"
 #include "error_handler.h"
 #include "list.h"
 #include "return_map.h"
 #include "request.h"
-
-// The factor by which we widen the cone openings.
-static const double ANG_FACTOR = 1.5;
-
-// The minimal cone opening allowed.
-static const double MIN_CONE_OPENING = 5.0 * Sup(DEG_TO_RAD);
- 
-// Wait one minute for a fresh grid.
+#include "result_cache.h"
+#include "share_table.h"
+#include "grid_hash.h"
+#include "telemetry.h"
+#include "lohner.h"
+#include "taylor.h"
+#include "trace.h"
+#include "workspace.h"
+#include "zone.h"
+#include "share_map.h"
+#include "share_journal.h"
+#include "coordinator.h"
+#include "wakeup.h"
+#include "lease.h"
+
+// Wait at most one minute for a fresh grid (see 'wakeup.h').
 static const unsigned WAIT_FOR_GRID = 60;
 
-// Enumerations used for search for grid.
-enum find {NONE_LEFT, WAITING_FOR_ONE, GOT_ONE};
-
 enum command {START_TIMING, SHOW_TIMING, STOP_TIMING};
 
 ////////////////////////////////////////////////////////////////////
@@ -46,24 +59,113 @@ extern "C"
   unsigned int sleep             (unsigned);
 }
 
+static void   get_the_options   (int &, char *argv[]);
 static void   print_info        (const char *);
 static void   clock             (const command &);
 static void   get_the_flags     (iterate &, const int &,
 				 char *argv[], char *, char *);
+static void   run_threads       (const char *, const char *);
+static void * work_in_thread    (void *);
 static bool   get_a_grid        (iterate &, const char *, const char *);
-static find   find_fresh_grid   (iterate &, const char *);
+static bool   get_a_table_grid  (iterate &);
+static void   leave_the_coordinator (const char *);
+static void   release_own_grids (List<grid> &, const char *, const char *);
+static void   resumed_grids     (const char *, List<grid> &);
+static find_result find_fresh_grids (List<iterate> &, const char *,
+				     const char *);
 static void   terminate_process (const char *);                   
-static void   work_on_grid      (iterate &, const char *, const char *);
+static void   work_on_grid      (iterate &, const char *, const char *,
+				 const std::string &);
+static std::string checkpoint_name (const char *, const int &);
 static void   insert_it_List    (List<iterate> &, const char *,
 				 const char *, const bool &); 
-static void   update            (iterate &, const iterate &);
+static void   add_the_image     (iterate &, const parcel &, List<iterate> &);
+static void   refine_the_grid   (iterate &, List<iterate> &);
+
+// Set by '--coordinator <socket>': the grids are then
+// requested from 'rodes_coord' rather than the shared file
+// (until the coordinator is lost, see 'coordinator.h').
+static bool            use_coordinator = false;
+static const char     *coord_socket    = NULL;
+static pthread_mutex_t coord_mutex     = PTHREAD_MUTEX_INITIALIZER;
+
+// Set if <shared_file> is in the binary format of 'share_map.h'
+// (see 'rodes_convert'). The grids are then claimed in place.
+static bool use_map = false;
+
+// Set by '--journal', or if <shared_file>.journal exists: the changes
+// are then appended to the journal rather than rewriting the file.
+static bool use_journal = false;
+
+// Set by '--threads N': N integrator threads in this process.
+static int threads = 1;
+
+// Set by '--flow-threads F': F threads flowing the parcels of a grid.
+static int flow_threads = 1;
+
+// Set by '--trace L': what the integrator records (see 'trace.h').
+static int trace = 0;
+
+// Set by '--fixed-steps': every step tries max_d_step (see 'return_map').
+static bool fixed_steps = false;
+
+// Set by '--taylor N': the order of the Taylor step (see 'taylor.h'),
+// or 0 for the corner method.
+static int taylor = 0;
+
+// Set by '--lohner': keep the sets of the parcels (see 'lohner.h').
+static bool lohner = false;
+
+// Set by '--cache <dir>': the returns done before (see 'result_cache.h').
+static const char *cache_dir = NULL;
+
+// Set by '--zones <file>': the zone table (see 'zone.h').
+static const char *zone_file = NULL;
+
+// Set by '--symmetric': only the grids in 'canonical_grid' form are
+// integrated; the returns of (-u, -v) are those of (u, v), reflected.
+static bool symmetric = false;
+
+// Set by '--refine <P0> <P1>': the images are grids of 2^-P0, and a
+// grid of P < P1 that fails, or whose images are more than
+// REFINE_IMAGES grids, is done as its four grids of P + 1.
+static int refine_from = 0;
+static int refine_to   = 0; // 0: no refinement.
+static const int REFINE_IMAGES = 16;
+
+// Set by '--batch K': take K grids at a time from the shared file.
+// The ones not yet worked on wait here, leased to us (see 'lease.h').
+static int             batch = 1;
+static List<iterate>   Leased;
+static pthread_mutex_t leased_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Write the shared table back to the file at most this often (seconds).
+static const int SNAPSHOT_INTERVAL = 60;
+
+// With several threads (and no coordinator) we take the shared file
+// for ourselves, and the threads share its table in memory.
+static bool            table_loaded = false;
+static List<iterate>   Table;
+static List<lease>     Table_Leases;  // (the leases of Table)
+static time_t          last_snapshot;
+static pthread_mutex_t table_mutex   = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  table_changed = PTHREAD_COND_INITIALIZER;
+
+// The file names passed on to each thread.
+typedef struct
+{
+  const char *mult_name;
+  const char *proc_name;
+  int         index;      // 0,..., threads - 1; for 'checkpoint_name'.
+} thread_args;
 
 ////////////////////////////////////////////////////////////////////
 
 //using namespace std;
 
 // Called by: none 
-// Calls to : 'Take_care_of_the_flags', 'get_a_grid', 
+// Calls to : 'Take_care_of_the_flags', 'get_a_grid', 'resumed_grids',
+//            'release_own_grids', 'checkpoint_pending',
 //            'terminate_process', and 'work_on_grid'
 int main(int argc, char *argv[])
 { 
@@ -72,17 +174,33 @@ int main(int argc, char *argv[])
   char proc_file[99] = ""; // Name of the file owned by this process.
   iterate it;
 
+  get_the_options(argc, argv);
   get_the_flags(it, argc, argv, mult_file, proc_file);
  
   print_info(proc_file);  
   clock(START_TIMING);  
 
-  while ( get_a_grid(it, mult_file, proc_file) )
+  if ( threads > 1 )
+    run_threads(mult_file, proc_file);
+  else
     {
-      counter++;
+      std::string ckpt_name = checkpoint_name(proc_file, 0);
+      List<grid> resumed;
+
+      resumed_grids(proc_file, resumed);
+      release_own_grids(resumed, mult_file, proc_file);
+      if ( checkpoint_pending(ckpt_name, it) ) // We were killed while
+	{                                       // doing this grid.
+	  work_on_grid(it, mult_file, proc_file, ckpt_name);
+	  clock(SHOW_TIMING);
+	}
+      while ( get_a_grid(it, mult_file, proc_file) )
+	{
+	  counter++;
 
-      work_on_grid(it, mult_file, proc_file);
-      clock(SHOW_TIMING);
+	  work_on_grid(it, mult_file, proc_file, ckpt_name);
+	  clock(SHOW_TIMING);
+	}
     }
   clock(STOP_TIMING); 
   terminate_process(proc_file);
@@ -92,6 +210,121 @@ int main(int argc, char *argv[])
 
 ////////////////////////////////////////////////////////////////////
 
+// Called by: 'main'
+// Calls to : 'checkpoint_every', 'Set_Flow_Threads',
+//            'Set_Trace_Level', 'Set_Fixed_Steps', 'Set_Taylor_Order',
+//            'Set_Lohner', 'Read_Zones', 'cache_open'
+// Strips the leading '--' options from argv, so that
+// 'get_the_flags' only sees the positional arguments.
+static void get_the_options(int &argc, char *argv[])
+{
+  int i = 1;
+
+  while ( i < argc && strncmp(argv[i], "--", 2) == 0 )
+    {
+      if ( strcmp(argv[i], "--coordinator") == 0 && i + 1 < argc )
+	{
+	  coord_socket = argv[i + 1]; // Connected in 'get_the_flags'.
+	  use_coordinator = true;
+	  i += 2;
+	}
+      else if ( strcmp(argv[i], "--journal") == 0 )
+	{
+	  use_journal = true;
+	  i++;
+	}
+      else if ( strcmp(argv[i], "--threads") == 0 && i + 1 < argc &&
+		atoi(argv[i + 1]) > 0 )
+	{
+	  threads = atoi(argv[i + 1]);
+	  i += 2;
+	}
+      else if ( strcmp(argv[i], "--flow-threads") == 0 && i + 1 < argc &&
+		atoi(argv[i + 1]) > 0 )
+	{
+	  flow_threads = atoi(argv[i + 1]);
+	  Set_Flow_Threads(flow_threads);
+	  i += 2;
+	}
+      else if ( strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc &&
+		atoi(argv[i + 1]) >= 0 )
+	{
+	  checkpoint_every(60 * atoi(argv[i + 1]));
+	  i += 2;
+	}
+      else if ( strcmp(argv[i], "--batch") == 0 && i + 1 < argc &&
+		atoi(argv[i + 1]) > 0 )
+	{
+	  batch = atoi(argv[i + 1]);
+	  i += 2;
+	}
+      else if ( strcmp(argv[i], "--trace") == 0 && i + 1 < argc &&
+		atoi(argv[i + 1]) >= 0 )
+	{
+	  trace = atoi(argv[i + 1]);
+	  Set_Trace_Level(trace);
+	  i += 2;
+	}
+      else if ( strcmp(argv[i], "--taylor") == 0 && i + 1 < argc &&
+		atoi(argv[i + 1]) >= 0 )
+	{
+	  Set_Taylor_Order(atoi(argv[i + 1]));
+	  taylor = Taylor_Order();
+	  i += 2;
+	}
+      else if ( strcmp(argv[i], "--lohner") == 0 )
+	{
+	  lohner = true;
+	  Set_Lohner(lohner);
+	  i++;
+	}
+      else if ( strcmp(argv[i], "--cache") == 0 && i + 1 < argc )
+	{
+	  cache_dir = argv[i + 1];
+	  i += 2;
+	}
+      else if ( strcmp(argv[i], "--zones") == 0 && i + 1 < argc )
+	{
+	  zone_file = argv[i + 1];
+	  if ( !Read_Zones(zone_file) )
+	    exit(1);
+	  i += 2;
+	}
+      else if ( strcmp(argv[i], "--symmetric") == 0 )
+	{
+	  symmetric = true;
+	  i++;
+	}
+      else if ( strcmp(argv[i], "--refine") == 0 && i + 2 < argc &&
+		atoi(argv[i + 1]) >= 0 && atoi(argv[i + 2]) > atoi(argv[i + 1]) )
+	{
+	  refine_from = atoi(argv[i + 1]);
+	  refine_to   = atoi(argv[i + 2]);
+	  i += 3;
+	}
+      else if ( strcmp(argv[i], "--fixed-steps") == 0 )
+	{
+	  fixed_steps = true;
+	  Set_Fixed_Steps(fixed_steps);
+	  i++;
+	}
+      else
+	{
+	  cout << "Unknown option: " << argv[i] << endl;
+	  exit(1);
+	}
+    }
+
+  if ( cache_dir != NULL ) // Now that the integrator is set up.
+    cache_open(cache_dir);
+
+  for ( int j = i; j <= argc; j++ ) // Also moves argv[argc] == NULL.
+    argv[j - i + 1] = argv[j];
+  argc -= i - 1;
+}
+
+////////////////////////////////////////////////////////////////////
+
 // Called by: 'main'
 // Calls to : none
 static void print_info(const char *proc_file)
@@ -122,6 +355,26 @@ static void print_info(const char *proc_file)
   cout.unsetf(ios::showpos);
   cout.unsetf(ios::scientific);
   cout << "proc_file = " << proc_file << endl;
+  if ( threads > 1 )
+    cout << "threads = " << threads << endl;
+  if ( flow_threads > 1 )
+    cout << "flow_threads = " << flow_threads << endl;
+  if ( trace > 0 )
+    cout << "trace = " << trace << endl;
+  if ( fixed_steps )
+    cout << "fixed_steps" << endl;
+  if ( taylor > 0 )
+    cout << "taylor = " << taylor << endl;
+  if ( lohner )
+    cout << "lohner" << endl;
+  if ( cache_dir != NULL )
+    cout << "cache = " << cache_dir << endl;
+  if ( zone_file != NULL )
+    cout << "zones = " << zone_file << endl;
+  if ( symmetric )
+    cout << "symmetric" << endl;
+  if ( refine_to > 0 )
+    cout << "refine = " << refine_from << " " << refine_to << endl;
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -219,6 +472,44 @@ static void get_the_flags(iterate &it, const int &argc, char *argv[],
       cout << "When computing in C0/C1-mode:\n";
       cout << "In case (2) and (3) one must also give the angles (in degrees)\n"
 	   << "for the cone boundary: [ang.lo] [ang.hi]" << endl << endl;
+      cout << "Options (given before [proc_nr]):\n";
+      cout << "  --coordinator <socket>  get the grids from 'rodes_coord'\n"
+	   << "                          instead of from <shared_file>.\n";
+      cout << "  --threads <N>           work on N grids at once. Without a\n"
+	   << "                          coordinator, <shared_file> is then\n"
+	   << "                          kept by this process until it quits.\n";
+      cout << "  --flow-threads <F>      flow the parcels of each grid on F\n"
+	   << "                          threads (so N * F threads in all).\n";
+      cout << "  --batch <K>             take K grids at a time from <shared_file>\n"
+	   << "                          (not with a coordinator).\n";
+      cout << "  --checkpoint <M>        save the grid being done every M minutes\n"
+	   << "                          (default 10; 0 for never), to resume it\n"
+	   << "                          when restarted after being killed.\n";
+      cout << "  --journal               append the changes to <shared_file>.journal\n"
+	   << "                          (used by all processes, once it exists).\n";
+      cout << "  --trace <L>             record the steps of the integrator (L = 1),\n"
+	   << "                          and the boxes within them (L = 2), in\n"
+	   << "                          <shared_file>_[proc_nr].trace (see 'rodes_trace').\n";
+      cout << "  --taylor <N>            flow by Taylor series of order N (e.g. 20)\n"
+	   << "                          instead of by the corner method.\n";
+      cout << "  --lohner                keep the sets of the parcels, not just\n"
+	   << "                          their boxes, between the planes.\n";
+      cout << "  --cache <dir>           take the returns of grids done before (with\n"
+	   << "                          the same integrator) from <dir>, and keep\n"
+	   << "                          the new ones there.\n";
+      cout << "  --zones <file>          read the zone table (resolution by zone)\n"
+	   << "                          from <file>, e.g. as made by 'rodes_tune'.\n";
+      cout << "  --symmetric             integrate only one grid of each pair\n"
+	   << "                          (u, v), (-u, -v); reflect the returns\n"
+	   << "                          for the other.\n";
+      cout << "  --refine <P0> <P1>      give the images as grids of 2^-P0 (the\n"
+	   << "                          seed should be of P0 too); a grid that\n"
+	   << "                          fails, or has too many images, is done\n"
+	   << "                          as its four grids of P + 1, up to P1.\n";
+      cout << "  --fixed-steps           do not adapt the steps of the integrator\n"
+	   << "                          (to compare: see 'rodes_report').\n";
+      cout << "A binary <shared_file> (see 'rodes_convert') is recognized\n"
+	   << "and shared in place; it is never taken by a single process." << endl << endl;
       exit(0);
     }
 
@@ -229,6 +520,36 @@ static void get_the_flags(iterate &it, const int &argc, char *argv[],
   strcat(proc_name, "_");
   strcat(proc_name, argv[1]);
 
+  if ( !use_coordinator && access(mult_name, F_OK) != 0 &&
+       access(proc_name, F_OK) == 0 )
+    { // Taken by our last run, killed before giving it back.
+      release_file(mult_name, proc_name);
+      cout << "Gave back " << mult_name << ", taken by our last run." << endl;
+    }
+  lease_start(mult_name, argv[1]); // Also for the coordinator (see 'lease.h').
+  if ( !use_coordinator && map_is_binary(mult_name) )
+    {
+      map_open(mult_name); // After 'lease_start': it checks [proc_nr].
+      use_map = true;
+    }
+  else if ( !use_coordinator && (use_journal || journal_exists(mult_name)) )
+    {
+      journal_open(mult_name);
+      use_journal = true;
+    }
+  cost_open(mult_name);   // We all learn how long the grids take.
+  stats_open(mult_name);
+  if ( trace > 0 )
+    trace_open((std::string(proc_name) + TRACE_SUFFIX).c_str());
+  if ( use_coordinator ) // It answers when it knows.
+    {
+      List<grid> resumed;
+      resumed_grids(proc_name, resumed);
+      coord_connect(coord_socket, argv[1], resumed);
+    }
+  else
+    wakeup_open(mult_name);
+
   List<iterate> it_List;
 
   if ( argc == 6 + add ) // Load a single iterate.
@@ -255,7 +576,7 @@ static void get_the_flags(iterate &it, const int &argc, char *argv[],
     } 
   else if ( argc == 8 + add ) // Load a rectangle -> several iterates.
     {
-      BOX rect ( 2 ); 
+      IVector rect ( 2 ); 
       //Resize(rect, 2);
       double dbl[4];
       int power;
@@ -297,76 +618,327 @@ static void get_the_flags(iterate &it, const int &argc, char *argv[],
 ////////////////////////////////////////////////////////////////////
 
 // Called by: 'main'
-// Calls to : 'get_file', 'find_fresh_grid', 'make_file_available', and 'rest'
+// Calls to : 'resumed_grids', 'get_file', 'read_it_List',
+//            'read_lease_List', 'release_own_grids', 'work_in_thread',
+//            'write_it_List', 'write_lease_List', 'release_file'
+// Runs 'threads' threads, each working on its own grid. Unless we use
+// a coordinator, a binary file or a journal, the shared file is taken
+// for the whole run, and the threads share its table in memory.
+static void run_threads(const char *mult_name, const char *proc_name)
+{
+  std::string lease_name = std::string(mult_name) + LEASE_SUFFIX;
+  List<grid> resumed;
+
+  std::vector<thread_args> args(threads);
+  for ( int i = 0; i < threads; i++ )
+    {
+      args[i].mult_name = mult_name;
+      args[i].proc_name = proc_name;
+      args[i].index     = i;
+    }
+  resumed_grids(proc_name, resumed);
+
+  if ( !use_coordinator && !use_map && !use_journal )
+    {
+      get_file(mult_name, proc_name);
+      read_it_List(proc_name, Table);
+      read_lease_List(lease_name.c_str(), Table_Leases);
+      last_snapshot = time(NULL);
+      table_loaded = true;
+    }
+  release_own_grids(resumed, mult_name, proc_name);
+
+  std::vector<pthread_t> ids(threads);
+  for ( int i = 0; i < threads; i++ )
+    if ( pthread_create(&ids[i], NULL, work_in_thread, &args[i]) != 0 )
+      {
+	cout << "Error: could not start thread " << i << endl;
+	exit(1);
+      }
+  for ( int i = 0; i < threads; i++ )
+    pthread_join(ids[i], NULL);
+
+  if ( table_loaded )
+    {
+      table_loaded = false;
+      write_it_List(proc_name, Table);
+      write_lease_List(lease_name.c_str(), Table_Leases);
+      release_file(mult_name, proc_name);
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'run_threads' (via 'pthread_create')
+// Calls to : 'checkpoint_pending', 'get_a_grid', 'work_on_grid'
+// The main loop of each thread. A thread first resumes the grid it
+// was doing when the process was killed (if started with the same
+// number of threads).
+static void * work_in_thread(void *arg)
+{
+  thread_args *args = (thread_args *) arg;
+  std::string ckpt_name = checkpoint_name(args->proc_name, args->index);
+  iterate it;
+
+  if ( checkpoint_pending(ckpt_name, it) )
+    {
+      work_on_grid(it, args->mult_name, args->proc_name, ckpt_name);
+      clock(SHOW_TIMING);
+    }
+  while ( get_a_grid(it, args->mult_name, args->proc_name) )
+    {
+      work_on_grid(it, args->mult_name, args->proc_name, ckpt_name);
+      clock(SHOW_TIMING);
+    }
+  return NULL;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main', 'work_in_thread'
+// Calls to : 'get_a_table_grid', 'coord_up', 'leave_the_coordinator',
+//            'coord_get_grid', 'map_take_fresh_grids',
+//            'journal_take_fresh_grids', 'get_file', 'find_fresh_grids',
+//            'release_file', 'wakeup_arm', 'wakeup_cancel' and 'wakeup_wait'
+// Gives the next grid leased to us, or else takes (up to 'batch')
+// new ones. The coordinator holds our request itself; if it is lost,
+// we go on with the shared file.
 static bool get_a_grid(iterate &it, const char *mult_name, const char *proc_name)
 {
-  find result;
+  find_result result;
+  List<iterate> taken;
+
+  if ( table_loaded )
+    return get_a_table_grid(it);
+
+  pthread_mutex_lock(&leased_mutex);
+  if ( !IsEmpty(Leased) )
+    {
+      First(Leased);
+      it = Current(Leased);
+      --Leased;
+      pthread_mutex_unlock(&leased_mutex);
+      return true;
+    }
+  pthread_mutex_unlock(&leased_mutex);
 
   while (1)
     { 
-      get_file(mult_name, proc_name);
-      result = find_fresh_grid(it, proc_name);
+      int bell = wakeup_arm(); // Before looking, not to miss a ring.
 
-      #ifdef DEBUG
-      cout << "  get_a_grid : result = " << result << endl;
-      #endif
+      if ( use_coordinator && !coord_up() )
+	leave_the_coordinator(mult_name);
+      if ( use_coordinator )
+	{
+	  result = coord_get_grid(it);
+	  if ( result == WAITING_FOR_ONE ) // It has waited already.
+	    {
+	      wakeup_cancel(bell);
+	      continue;
+	    }
+	}
+      else if ( use_map )
+	result = map_take_fresh_grids(taken, batch);
+      else if ( use_journal )
+	result = journal_take_fresh_grids(taken, batch);
+      else
+	{
+	  get_file(mult_name, proc_name);
+	  result = find_fresh_grids(taken, mult_name, proc_name);
+	  release_file(mult_name, proc_name);
+	}
 
-      release_file(mult_name, proc_name);
-      if ( result == NONE_LEFT )
-	return false;
-      else if ( result == GOT_ONE )
-	return true;
-      else if ( result == WAITING_FOR_ONE )
-	sleep(WAIT_FOR_GRID);
+      if ( result == WAITING_FOR_ONE )
+	wakeup_wait(bell, WAIT_FOR_GRID);
+      else
+	{
+	  wakeup_cancel(bell);
+	  break;
+	}
+    }
+
+  if ( result == GOT_ONE && !IsEmpty(taken) )
+    {
+      First(taken);
+      it = Current(taken);
+      --taken;
+      pthread_mutex_lock(&leased_mutex);
+      while ( !IsEmpty(taken) )
+	{
+	  First(taken);
+	  Leased += Current(taken);
+	  --taken;
+	}
+      pthread_mutex_unlock(&leased_mutex);
     }
+  return ( result == GOT_ONE );
 }
 
 ////////////////////////////////////////////////////////////////////
 
 // Called by: 'get_a_grid'
-// Calls to : none
-static find find_fresh_grid(iterate &it, const char *proc_name)
-{ 
-    find result = NONE_LEFT;
- 
-    std::ifstream InFile(proc_name, ios::in);
-    iterate temp_it;
-    List<iterate> File_List;
-    while ( InFile >> temp_it )
-    {    
-      if ( result != GOT_ONE )
+// Calls to : 'take_fresh_grid', 'expired_leases', 'release_grids'
+// Takes a grid from the table shared by the threads. While the other
+// threads are still working, we wait for them to insert their images.
+// Before we wait, the grids of the processes whose leases have
+// expired (taken before we took the file) are given back; as we
+// wait, this is done again every WAIT_FOR_GRID seconds. The grid
+// is leased to us, as in 'find_fresh_grids', so that it is given
+// back if we are killed.
+static bool get_a_table_grid(iterate &it)
+{
+  find_result result;
+
+  pthread_mutex_lock(&table_mutex);
+  while ( (result = take_fresh_grid(Table, it)) == WAITING_FOR_ONE )
+    {
+      List<grid> expired;
+
+      expired_leases(Table_Leases, expired);
+      if ( !IsEmpty(expired) )
 	{
-	  if ( temp_it.ndl.c_stat == NOT_DONE ) 
-	    {
-	      temp_it.ndl.c_stat = BEING_DONE;
-	      it = temp_it;
-	      result = GOT_ONE;
-	    }
-	  else if ( temp_it.ndl.c_stat == BEING_DONE )
-	    result = WAITING_FOR_ONE;
+	  release_grids(Table, expired);
+	  continue;
 	}
-      File_List += temp_it;  
+
+      struct timespec until;
+      until.tv_sec  = time(NULL) + WAIT_FOR_GRID;
+      until.tv_nsec = 0;
+      pthread_cond_timedwait(&table_changed, &table_mutex, &until);
     }
-  InFile.close();
-
-    std::ofstream OutFile(proc_name, ios::out);
-    First(File_List);
-    while( !Finished(File_List) ) 
-      {     
-	OutFile << Current(File_List) << endl;
-	Next(File_List);
-      }
-    OutFile.close();
+  if ( result == GOT_ONE )
+    {
+      lease l;
+      l.grd   = it.ndl.grd;
+      l.owner = lease_owner();
+      Table_Leases += l;
+    }
+  pthread_mutex_unlock(&table_mutex);
+
+  return ( result == GOT_ONE );
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_a_grid', 'insert_it_List'
+// Calls to : 'wakeup_open', 'coord_take_back'
+// The coordinator is lost: from now on, all threads use the shared
+// file. If the coordinator was killed, we give the file back for it.
+// The grids it gave us stay leased to us there.
+static void leave_the_coordinator(const char *mult_name)
+{
+  pthread_mutex_lock(&coord_mutex);
+  if ( use_coordinator )
+    {
+      wakeup_open(mult_name);
+      if ( !coord_take_back(mult_name) )
+	cout << "Waiting for the coordinator to give back "
+	     << mult_name << "." << endl;
+      use_coordinator = false;
+    }
+  pthread_mutex_unlock(&coord_mutex);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main', 'run_threads'
+// Calls to : 'own_leases', 'release_grids', 'map_release_own',
+//            'journal_release_own', 'get_file', 'read_it_List',
+//            'read_lease_List', 'write_it_List', 'write_lease_List',
+//            'release_file', 'wakeup_ring'
+// Before we take a grid: gives back the grids an earlier run under
+// our [proc_nr] was killed before doing, except the ones 'resumed'
+// from its checkpoints. (Our own leases never expire, see 'lease.h'.)
+static void release_own_grids(List<grid> &resumed, const char *mult_name,
+			      const char *proc_name)
+{
+  List<grid> own;
+
+  if ( use_coordinator ) // The coordinator did, when we said HELLO.
+    return;
+  if ( table_loaded )
+    {
+      own_leases(Table_Leases, lease_owner(), resumed, own);
+      release_grids(Table, own);
+      return;
+    }
+
+  if ( use_map )
+    map_release_own(resumed);
+  else if ( use_journal )
+    journal_release_own(resumed);
+  else
+    {
+      List<iterate> File_List;
+      List<lease> Lease_List;
+      std::string lease_name = std::string(mult_name) + LEASE_SUFFIX;
+
+      get_file(mult_name, proc_name);
+      read_it_List(proc_name, File_List);
+      read_lease_List(lease_name.c_str(), Lease_List);
+      own_leases(Lease_List, lease_owner(), resumed, own);
+      release_grids(File_List, own);
+      write_it_List(proc_name, File_List);
+      write_lease_List(lease_name.c_str(), Lease_List);
+      release_file(mult_name, proc_name);
+    }
+  wakeup_ring();
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main', 'run_threads', 'get_the_flags'
+// Calls to : 'checkpoint_name', 'checkpoint_pending'
+// The grids our threads will resume from their checkpoints.
+static void resumed_grids(const char *proc_name, List<grid> &resumed)
+{
+  iterate it;
+
+  for ( int i = 0; i < threads; i++ )
+    if ( checkpoint_pending(checkpoint_name(proc_name, i), it) )
+      resumed += it.ndl.grd;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_a_grid'
+// Calls to : 'read_it_List', 'read_lease_List', 'expired_leases',
+//            'release_grids', 'take_fresh_grids', 'add_leases',
+//            'write_it_List', 'write_lease_List'
+// Takes (up to 'batch') grids from the shared file, which we hold.
+// The grids of the processes whose leases have expired are given
+// back first.
+static find_result find_fresh_grids(List<iterate> &taken,
+				    const char *mult_name, const char *proc_name)
+{ 
+  List<iterate> File_List;
+  List<lease> Lease_List;
+  List<grid> expired;
+  std::string lease_name = std::string(mult_name) + LEASE_SUFFIX;
+
+  read_it_List(proc_name, File_List);
+  read_lease_List(lease_name.c_str(), Lease_List);
+  expired_leases(Lease_List, expired);
+  release_grids(File_List, expired);
+  find_result result = take_fresh_grids(File_List, taken, batch);
+  add_leases(Lease_List, taken, lease_owner());
+  write_it_List(proc_name, File_List);
+  write_lease_List(lease_name.c_str(), Lease_List);
 
   return result;
-};
+}
 
 ////////////////////////////////////////////////////////////////////
 
 // Called by: 'main'
-// Calls to : none - 'exit(0)'
+// Calls to : 'map_close', 'journal_close', 'lease_stop', 'exit(0)'
 static void terminate_process(const char *proc_name)
 {
+  lease_stop();
+  if ( use_map )
+    map_close();
+  if ( use_journal )
+    journal_close();
   cout << "terminate_process(" << proc_name << ")" << endl;
   exit(0);
 }
@@ -376,8 +948,19 @@ static void terminate_process(const char *proc_name)
 // Called by: 'main' and 'Take_care_of_the_flags' 
 // Calls to : 'Compute_the_return'(extern), 'insert_it_List',
 //            'iterate_to_parcel', 'Get_Hull', 'pcl_List_to_it_List',
-//            'Get_Image_Hull',  
-static void work_on_grid(iterate &it, const char *mult_name, const char *proc_name)
+//            'add_the_image', 'stats_write', 'cost_observe',
+//            'checkpoint::remove', 'Trace_Flush', 'cache_lookup',
+//            'cache_store', 'canonical_grid', 'Reflect_pcl_List',
+//            'refine_the_grid'
+// The state of the integrator is saved in the file 'ckpt_name' now
+// and then, and resumed from it if it is there for this grid. What
+// it took is added to <shared_file>.stats. A grid found in the
+// cache is not computed again. With '--symmetric', the integrator
+// is given the 'canonical_grid' of the grid, and its returns are
+// reflected if that is the other grid of the pair. With '--refine',
+// the grid may be REFINED instead of DONE (or FAILED).
+static void work_on_grid(iterate &it, const char *mult_name, const char *proc_name,
+			 const std::string &ckpt_name)
 {
     parcel pcl; //Resize(pcl.box, SYSDIM);
     //pcl.box
@@ -385,17 +968,47 @@ static void work_on_grid(iterate &it, const char *mult_name, const char *proc_na
     List<iterate> it_List;
     List<parcel> pcl_List;
 
-  iterate_to_parcel(it, pcl);
+  iterate source = it; // The grid given to the integrator.
+  bool mirrored = false;
+  if ( symmetric )
+    {
+      source.ndl.grd = canonical_grid(it.ndl.grd);
+      mirrored = ( source.ndl.grd.u != it.ndl.grd.u ||
+		   source.ndl.grd.v != it.ndl.grd.v );
+    }
+
+  iterate_to_parcel(source, pcl);
+  TRACE(1, TRACE_GRID, pcl, pcl.box, source.ndl.grd.u, source.ndl.grd.v);
 
+  checkpoint ckpt(ckpt_name, it);
+  parcel pcl_hull; 
+  const int power = ( refine_to > 0 ? refine_from : it.ndl.grd.P ); // Of the images.
+
+  if ( it.ndl.c_stat != RESERVED && cache_lookup(it, power, pcl_hull, it_List) )
+    {
+      cout << "Taken from the cache: " << it.ndl.grd << endl;
+      add_the_image(it, pcl_hull, it_List);
+      refine_the_grid(it, it_List);
+      insert_it_List(it_List, mult_name, proc_name, false);
+      ckpt.remove();
+      return;
+    }
+
+  grid_stats &stats = Thread_Workspace().stats; // Counted by the integrator.
+  struct timeval start, stop;
+  struct timespec cpu_start, cpu_stop;
+
+  stats.clear();
+  stats.grd = it.ndl.grd;
+  gettimeofday(&start, NULL);
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_start);
   try
     {
   /***************************************************************/
   /*        HERE WE MAKE THE ONLY CALL TO THE INTEGRATOR         */
   /*                                                             */
       if ( it.ndl.c_stat != RESERVED )
-	Compute_the_return(pcl, pcl_List);
-
-      cout << "HERE in rodes.cc" << endl;
+	Compute_the_return(pcl, pcl_List, &ckpt);
   /*                                                             */
   /*                                                             */
   /***************************************************************/
@@ -407,185 +1020,170 @@ static void work_on_grid(iterate &it, const char *mult_name, const char *proc_na
 	   << it << endl;
       it.ndl.c_stat = FAILED; 
     }
+  Trace_Flush();
+
+  gettimeofday(&stop, NULL);
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_stop);
+  stats.wall = (stop.tv_sec - start.tv_sec) + 1e-6 * (stop.tv_usec - start.tv_usec);
+  stats.cpu += ( (cpu_stop.tv_sec - cpu_start.tv_sec) + // The threads of
+		 1e-9 * (cpu_stop.tv_nsec - cpu_start.tv_nsec) ); // 'flow_pool' too.
+  if ( it.ndl.c_stat != RESERVED )
+    {
+      stats.c_stat = ( it.ndl.c_stat == FAILED ? FAILED : DONE );
+      stats_write(stats);
+    }
+  if ( it.ndl.c_stat != FAILED && it.ndl.c_stat != RESERVED )
+    cost_observe(it.ndl.grd, stats.wall);
 
   if ( it.ndl.c_stat == FAILED || it.ndl.c_stat == RESERVED )
     it_List += it; // it_List contains it only.
   else
     { // Store the returns in the list
-      parcel pcl_hull; 
+      if ( mirrored )
+	Reflect_pcl_List(pcl_List); // The returns of 'it'.
       Get_Hull(pcl_hull, pcl_List);
-      it.ndl.c_stat = DONE; 
-#ifdef COMPUTE_C1
-      it.ndl.min_exp = Inf(pcl_hull.expansion); // Inf(E_i), E_i = Hull(E_{i,j}).
-#endif
   /***************************************************************/
   /*        HERE WE GENERATE THE PRE-EXPANSION ESTIMATES         */
   /*                                                             */
-      pcl_List_to_it_List(pcl_List, it.ndl.grd.P, it_List);
+      pcl_List_to_it_List(pcl_List, power, it_List);
 
   /*  AFTER: it.ndl.h_stat == HIT, it.ndl.c_stat == NOT_DONE,    */
   /*         it.ndl.min_exp == LARGE_NUMBER.                     */
   /***************************************************************/
 
-      New_Get_Image_Hull(it, it_List); // Gets 'inf_grd' and 'sup_grd'.
-      it_List += it;                   // Add the initial it to the end of the List.
+      cache_store(it, power, pcl_hull, it_List);
+      add_the_image(it, pcl_hull, it_List);
     }
+  refine_the_grid(it, it_List);
 
   insert_it_List(it_List, mult_name, proc_name, false);
+  ckpt.remove(); // Only now: the images are in.
 }
 
 ////////////////////////////////////////////////////////////////////
 
-// Called by: 'work_on_grid' 
-// Calls to : 'update'
-static void insert_it_List(List<iterate> &Add_List, const char *mult_name,
-			   const char *proc_name, const bool &external_input)
+// Called by: 'work_on_grid'
+// Calls to : 'New_Get_Image_Hull'
+// Marks 'it' done, its image iterates being in it_List (and the hull
+// of its returns in pcl_hull), and adds it to the end of it_List.
+static void add_the_image(iterate &it, const parcel &pcl_hull, List<iterate> &it_List)
 {
-    iterate temp_it;
-    List<iterate> Old_List;
-
-    get_file(mult_name, proc_name);
-    std::ifstream InFile(proc_name, ios::in);
-
-    while ( InFile >> temp_it )
-      Old_List += temp_it;  
-    InFile.close();
-
-    iterate old_it;
-    iterate add_it;
-    List<iterate> New_List;
-    
-    if ( Length(Old_List) > 0 )
-      { // Length(Old_List) > 0
-	First(Old_List);
-	while( !Finished(Old_List) ) 
-	  { // !Finished(Old_List)                       
-	    old_it = Current(Old_List);	  
-	    if ( !IsEmpty(Add_List) )
-	      {
-		First(Add_List);
-		while( !Finished(Add_List) ) 
-		  {     
-		    add_it = Current(Add_List);
-		    if ( old_it.ndl.grd == add_it.ndl.grd )
-		      {
-			/********************************************************/
-			/*        HERE WE UPDATE THE STATUS OF 'old.it'         */
-			/*                                                      */
-			update(old_it, add_it);
-			/*                                                      */
-			/*                                                      */ 
-			/********************************************************/
-			RemoveCurrent(Add_List);
-			if ( IsEmpty(Add_List) ) 
-			  break;
-		      }
-		    else                        
-		      Next(Add_List);
-		  }
-	      }
-	    New_List += old_it;  
-	    Next(Old_List);
-	  }
-      }
-    
-    if ( Length(Add_List) > 0 )
-      { // Append the remains of Add_List to New_List.
-	First(Add_List);
-	while( !Finished(Add_List) ) 
-	  { 
-	    add_it = Current(Add_List);
-	    if ( !external_input ) // Only widen cone openings if they
-	      {                    // come from internal computations.
-		/********************************************************/
-		/*    Widen the cone opening to minimize the risk of    */
-		/*    having to recompute due to cone leakage.          */
-		/*                                                      */
-#ifdef COMPUTE_C1                             
-		add_it.ndl.ang = Rescale(add_it.ndl.ang, ANG_FACTOR); 
-		if ( diam(add_it.ndl.ang) < MIN_CONE_OPENING )
-		  {
-		    double mid = Mid(add_it.ndl.ang);
-		    add_it.ndl.ang = mid + SymHull(MIN_CONE_OPENING / 2.0);
-		  }
-#endif                  
-		/*   Now the cone opening is at least MIN_CONE_OPENING. */
-		/*                                                      */ 
-		/********************************************************/    
-	      }
-	    New_List += add_it;                     
-	    Next(Add_List);                     
-	  }                                     
-      }
-    std::ofstream OutFile(proc_name, ios::out);
-    First(New_List);
-    while( !Finished(New_List) ) 
-      { // Write New_List to owned file.    
-	OutFile << Current(New_List) << endl;;
-	Next(New_List);
-      }
-    OutFile.close();
-    release_file(mult_name, proc_name);
-} 
+  it.ndl.c_stat = DONE; 
+#ifdef COMPUTE_C1
+  it.ndl.min_exp = Inf(pcl_hull.expansion); // Inf(E_i), E_i = Hull(E_{i,j}).
+#endif
+  New_Get_Image_Hull(it, it_List); // Gets 'inf_grd' and 'sup_grd'.
+  it_List += it;                   // Add the initial it to the end of the List.
+}
 
 ////////////////////////////////////////////////////////////////////
 
-// Called by: 'insert_it_List' 
-// Calls to : none
-static void update(iterate &old_it, const iterate &new_it)
+// Called by: 'work_on_grid'
+// Calls to : 'child_iterates'
+// With '--refine': if 'it' (of P < P1) FAILED, or its images (in
+// it_List, followed by 'it') are more than REFINE_IMAGES grids, it
+// is REFINED instead. Its images are dropped (those of its children
+// are within them), and it_List holds its four children, NOT_DONE,
+// and 'it'. Images that hit 'it' are passed on to the children by
+// 'merge_it_List'.
+static void refine_the_grid(iterate &it, List<iterate> &it_List)
 {
-  iterate result = old_it;
+  if ( refine_to == 0 || it.ndl.grd.P >= refine_to || it.ndl.c_stat == RESERVED )
+    return;
+  if ( it.ndl.c_stat != FAILED && Length(it_List) - 1 <= REFINE_IMAGES )
+    return;
 
-  if ( new_it.ndl.c_stat == NOT_DONE ) // 'new_it' is an image...
-    { // 'new_it' is not the source it.
-      result.ndl.h_stat = new_it.ndl.h_stat;// ...and so it is HIT.
+  iterate parent = it;
+  parent.ndl.c_stat = NOT_DONE;
 #ifdef COMPUTE_C1
-      // 'old_it' has already been updated, or is now
-      // under computation by a different process.
-      result.ndl.pre_exp = Min(old_it.ndl.pre_exp, new_it.ndl.pre_exp);
-      if ( Subset(new_it.ndl.ang, old_it.ndl.ang) )
-	{ /* No need to widen the cone */ }
-      else
-	{ // We have to recompute with a wider cone.
-	  interval dummy;
-	  if ( Intersection(dummy, new_it.ndl.ang, old_it.ndl.ang) )
-	    { // Double the angular differences.
-	      double upper_ang_diff = Sup(new_it.ndl.ang) - Sup(old_it.ndl.ang);
-	      if ( upper_ang_diff < 0.0 )
-		upper_ang_diff = 0.0;
-	      double lower_ang_diff = Inf(new_it.ndl.ang) - Inf(old_it.ndl.ang);
-	      if ( lower_ang_diff > 0.0 )
-		lower_ang_diff = 0.0;
-	      result.ndl.ang = old_it.ndl.ang + 
-		ANG_FACTOR * Hull(lower_ang_diff, upper_ang_diff);
-	    }
-	  else // The cones don't even intersect.
-	    result.ndl.ang = Rescale(Hull(new_it.ndl.ang, old_it.ndl.ang), ANG_FACTOR);
-	  if ( old_it.ndl.c_stat == BEING_DONE )
-	    result.ndl.c_stat = DO_AGAIN; 
-	  if ( old_it.ndl.c_stat == DONE )
-	    result.ndl.c_stat = NOT_DONE; 
-	  // We do not alter c_stat == FAILED or RESERVED.
-	}
-#endif // COMPUTE_C1
-    }
-  else // 'new_it' is the source, i.e., 'old_it' is
-    {  // now under computation by this process.
-      if ( old_it.ndl.c_stat == DO_AGAIN ) // The cone has been widened
-	{                                  // during this computation.
-	  result.ndl.c_stat = NOT_DONE;    // Only this process may release 
-	}                                  // the 'it' for re-computation. 
-      else // An uninterrupted computation.
+  parent.ndl.min_exp = LARGE_NUMBER; // The children are not computed yet.
+#endif
+  while ( !IsEmpty(it_List) )
+    --it_List;
+  child_iterates(parent, it_List);
+
+  cout << "Refined " << it.ndl.grd << ( it.ndl.c_stat == FAILED ? " (failed)" : "" )
+       << endl;
+  it.ndl.c_stat = REFINED;
+  it_List += it;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main', 'work_in_thread'
+// Calls to : none
+// The checkpoint file of thread 'index': <proc_file>.ckpt for the
+// first (or only) thread, <proc_file>.<index>.ckpt for the others.
+static std::string checkpoint_name(const char *proc_name, const int &index)
+{
+  std::ostringstream name;
+
+  name << proc_name;
+  if ( index > 0 )
+    name << "." << index;
+  name << CHECKPOINT_SUFFIX;
+  return name.str();
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'work_on_grid' and 'get_the_flags'
+// Calls to : 'merge_it_List', 'coord_insert', 'leave_the_coordinator',
+//            'map_merge_it_List',
+//            'journal_merge_it_List', 'read_it_List', 'read_lease_List',
+//            'drop_leases', 'merge_it_List', 'write_it_List',
+//            'write_lease_List', 'wakeup_ring'
+static void insert_it_List(List<iterate> &Add_List, const char *mult_name,
+			   const char *proc_name, const bool &external_input)
+{
+  if ( table_loaded )
+    {
+      pthread_mutex_lock(&table_mutex);
+      drop_leases(Table_Leases, Add_List);
+      merge_it_List(Table, Add_List, external_input);
+      if ( difftime(time(NULL), last_snapshot) >= SNAPSHOT_INTERVAL )
 	{
-	  result.ndl.c_stat = new_it.ndl.c_stat; // DONE, FAILED or RESERVED.
-	  result.inf_grd = new_it.inf_grd;       // Save the hull of
-	  result.sup_grd = new_it.sup_grd;       // the images.
-#ifdef COMPUTE_C1
-	  result.ndl.min_exp = new_it.ndl.min_exp; // Save the minimal expansion.
-#endif // COMPUTE_C1
+	  std::string lease_name = std::string(mult_name) + LEASE_SUFFIX;
+
+	  write_it_List(proc_name, Table);
+	  write_lease_List(lease_name.c_str(), Table_Leases);
+	  last_snapshot = time(NULL);
 	}
+      pthread_cond_broadcast(&table_changed);
+      pthread_mutex_unlock(&table_mutex);
+      return;
     }
-  old_it = result; // Pass the result by reference.
-}
+
+  if ( use_coordinator )
+    {
+      if ( coord_insert(Add_List, external_input) )
+	return;
+      leave_the_coordinator(mult_name);
+    }
+
+  if ( use_map )
+    map_merge_it_List(Add_List, external_input);
+  else if ( use_journal )
+    journal_merge_it_List(Add_List, external_input);
+  else
+    {
+      List<iterate> Table;
+      List<lease> Lease_List;
+      std::string lease_name = std::string(mult_name) + LEASE_SUFFIX;
+
+      get_file(mult_name, proc_name);
+      read_it_List(proc_name, Table);
+      read_lease_List(lease_name.c_str(), Lease_List);
+      drop_leases(Lease_List, Add_List);
+      merge_it_List(Table, Add_List, external_input);
+      write_it_List(proc_name, Table);
+      write_lease_List(lease_name.c_str(), Lease_List);
+      release_file(mult_name, proc_name);
+    }
+
+  // There may be new grids, a DO_AGAIN released, or the last grid
+  // done: the waiting processes must look again.
+  wakeup_ring();
+} 
 
 ////////////////////////////////////////////////////////////////////
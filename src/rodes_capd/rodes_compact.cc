@@ -0,0 +1,62 @@
+/*   File: rodes_compact.cc
+
+     Folds the journal <shared_file>.journal into
+     <shared_file> (see 'share_journal.h'). Given an
+     interval, it keeps doing so every <minutes> minutes,
+     until killed. The 'rodes' processes also fold the
+     journal themselves, once it is larger than
+     JOURNAL_COMPACT_SIZE.
+
+     Usage: rodes_compact <shared_file> [minutes]
+
+     Compilation: make rodes_compact
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <iostream>
+#include <cstdlib>
+
+#include <unistd.h>
+
+#include "share_journal.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: none
+// Calls to : 'journal_exists', 'journal_open', 'journal_compact',
+//            'journal_close'
+int main(int argc, char *argv[])
+{
+  if ( argc != 2 && argc != 3 )
+    {
+      cout << endl << "Usage: " << endl;
+      cout << "\t" << argv[0] << " <shared_file> [minutes]\n\n"
+	   << "\twhich folds <shared_file>" << JOURNAL_SUFFIX
+	   << " into <shared_file>,\n"
+	   << "\tonce, or every [minutes] minutes.\n" << endl;
+      exit(0);
+    }
+  if ( !journal_exists(argv[1]) )
+    {
+      cout << "Error: " << argv[1] << " has no journal." << endl;
+      exit(1);
+    }
+
+  int minutes = ( argc == 3 ? atoi(argv[2]) : 0 );
+
+  journal_open(argv[1]);
+  journal_compact();
+  while ( minutes > 0 )
+    {
+      sleep(60 * minutes);
+      journal_compact();
+    }
+  journal_close();
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////
@@ -0,0 +1,86 @@
+/*   File: rodes_convert.cc
+
+     Converts a shared file between the text format
+     (read and written by 'read_it_List' and
+     'write_it_List') and the binary format of
+     'share_map.h'. The order of the iterates is kept.
+
+     Usage: rodes_convert -b <text_file> <binary_file>
+            rodes_convert -t <binary_file> <text_file>
+
+     Compilation: make rodes_convert
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+
+#include "2d_classes.h"
+#include "list.h"
+#include "request.h"
+#include "share_journal.h"
+#include "share_map.h"
+#include "share_table.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: none
+// Calls to : 'journal_exists', 'get_file', 'read_it_List', 'release_file',
+//            'map_write_it_List', 'map_read_it_List', 'write_it_List'
+int main(int argc, char *argv[])
+{
+  if ( argc != 4 || (strcmp(argv[1], "-b") != 0 && strcmp(argv[1], "-t") != 0) )
+    {
+      cout << endl << "Usage: " << endl;
+      cout << "\t" << argv[0] << " -b <text_file> <binary_file>\n"
+	   << "\t" << argv[0] << " -t <binary_file> <text_file>\n\n"
+	   << "\twhich converts a shared file to (-b) or from (-t)\n"
+	   << "\tthe binary format.\n" << endl;
+      exit(0);
+    }
+
+  List<iterate> it_List;
+
+  if ( strcmp(argv[1], "-b") == 0 )
+    {
+      if ( map_is_binary(argv[2]) )
+	{
+	  cout << "Error: " << argv[2] << " is already binary." << endl;
+	  exit(1);
+	}
+      if ( journal_exists(argv[2]) )
+	{
+	  cout << "Error: " << argv[2] << " has a journal; fold it in with"
+	       << " 'rodes_compact' and remove it first." << endl;
+	  exit(1);
+	}
+      // Take the text file, in case some process is still using it.
+      std::string proc_name = std::string(argv[2]) + "_convert";
+      get_file(argv[2], proc_name.c_str());
+      read_it_List(proc_name.c_str(), it_List);
+      release_file(argv[2], proc_name.c_str());
+
+      map_write_it_List(argv[3], it_List);
+    }
+  else
+    {
+      if ( !map_is_binary(argv[2]) )
+	{
+	  cout << "Error: " << argv[2] << " is not binary." << endl;
+	  exit(1);
+	}
+      map_read_it_List(argv[2], it_List);
+      write_it_List(argv[3], it_List);
+    }
+  cout << "rodes_convert: " << Length(it_List) << " iterates written to "
+       << argv[3] << endl;
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////
@@ -0,0 +1,488 @@
+/*   File: rodes_coord.cc
+
+     The coordinator for processes sharing a data file
+     <shared_file>. It takes the file (just as a 'rodes'
+     process would, via 'get_file'), keeps the table of
+     iterates in memory, and serves the grids to 'rodes'
+     processes started with '--coordinator <socket>'.
+     A process asking for a grid while there are none
+     (but other grids are being done) gets its answer
+     as soon as some process has inserted its images.
+     The table is written back to the file every
+     SNAPSHOT_INTERVAL seconds, and when we quit,
+     together with the leases (<shared_file>.leases).
+     The grids taken by a process that disconnects
+     before it has inserted their images are given
+     back to the others, once its heartbeat has stopped
+     (it was killed; see 'lease.h'). Until then, they
+     stay leased to it, as do the grids of the leases
+     found in <shared_file>.leases: we look at the
+     start, and every LEASE_BEAT seconds. A process
+     restarted under the same [proc_nr] gets its grids
+     back at once (see 'coordinator.h').
+
+     The file is held as <shared_file>_coord; if it is
+     left there by a coordinator that was killed (whose
+     pid in <shared_file>_coord.pid is gone), we take it
+     back (see 'coord_take_back').
+
+     Usage: rodes_coord <shared_file> [socket]
+
+     Compilation: make rodes_coord
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <cerrno>
+#include <ctime>
+
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+
+#include "2d_classes.h"
+#include "coordinator.h"
+#include "cost.h"
+#include "lease.h"
+#include "list.h"
+#include "request.h"
+#include "share_journal.h"
+#include "share_map.h"
+#include "share_table.h"
+
+using namespace std;
+
+// Write the table back to the file at most this often (seconds).
+static const int SNAPSHOT_INTERVAL = 60;
+
+////////////////////////////////////////////////////////////////////
+
+class client
+{
+ public:
+  int fd;
+  std::string owner;  // Its [proc_nr], from HELLO; "-" if not known.
+  std::string buffer; // Received, but not yet served.
+  bool waiting;       // Its GET is held until there is a grid...
+  time_t since;       // ...(held since then).
+  std::vector<grid> taken; // The grids it is working on.
+};
+
+static volatile sig_atomic_t quitting = 0;
+static bool table_changed = false;  // By a PUT, since we last looked.
+
+// The leases of the grids taken by processes not connected to us:
+// read from <shared_file>.leases (see 'lease.h'), or left by a
+// client that disconnected while its heartbeat was alive.
+static List<lease> Leases;
+
+// The pid of the last HELLO of each [proc_nr].
+static std::map<std::string, long> runs;
+
+static void on_signal       (int);
+static void serve_client    (client &, List<iterate> &, bool &);
+static bool serve_request   (client &, List<iterate> &, bool &);
+static void serve_get       (client &, List<iterate> &, bool &);
+static bool reclaim_leases  (List<iterate> &);
+static void write_leases    (const std::string &, std::vector<client> &);
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: none
+// Calls to : 'map_is_binary', 'journal_exists', 'cost_open',
+//            'coord_take_back', 'lease_start', 'get_file', 'read_it_List',
+//            'read_lease_List', 'reclaim_leases', 'serve_client',
+//            'serve_get', 'coord_write_all', 'write_it_List',
+//            'write_leases', 'release_file', 'lease_stop'
+int main(int argc, char *argv[])
+{
+  if ( argc != 2 && argc != 3 )
+    {
+      cout << endl << "Usage: " << endl;
+      cout << "\t" << argv[0] << " <shared_file> [socket]\n\n"
+	   << "\twhich serves the grids of <shared_file> to processes\n"
+	   << "\tstarted as 'rodes --coordinator <socket> [proc_nr] <shared_file>'.\n"
+	   << "\tThe default socket is <shared_file>" << COORD_SOCKET_SUFFIX
+	   << ".\n" << endl;
+      exit(0);
+    }
+
+  std::string mult_name  = argv[1];
+  std::string proc_name  = mult_name + COORD_FILE_SUFFIX;
+  std::string pid_name   = mult_name + COORD_PID_SUFFIX;
+  std::string lease_name = mult_name + LEASE_SUFFIX;
+  std::string sock_name  = (argc == 3 ? std::string(argv[2])
+			    : mult_name + COORD_SOCKET_SUFFIX);
+
+  if ( map_is_binary(mult_name.c_str()) )
+    { // Already shared in place; there is nothing to coordinate.
+      cout << "Error: " << mult_name << " is a binary shared file;"
+	   << " run 'rodes' on it directly." << endl;
+      exit(1);
+    }
+  if ( journal_exists(mult_name.c_str()) )
+    { // The journal would be lost.
+      cout << "Error: " << mult_name << " has a journal; fold it in with"
+	   << " 'rodes_compact' and remove it first." << endl;
+      exit(1);
+    }
+
+  cost_open(mult_name.c_str()); // Written by the processes.
+
+  if ( !coord_take_back(mult_name.c_str()) )
+    { // Before we take over its socket.
+      cout << "Error: " << mult_name << " is held by another coordinator"
+	   << " (see " << pid_name << ")." << endl;
+      exit(1);
+    }
+
+  int listen_fd = coord_open_socket(sock_name.c_str(), true);
+  if ( listen_fd < 0 )
+    {
+      cout << "Error: cannot listen on " << sock_name << ": "
+	   << strerror(errno) << endl;
+      exit(1);
+    }
+
+  signal(SIGINT,  on_signal);
+  signal(SIGTERM, on_signal);
+  signal(SIGPIPE, SIG_IGN);   // A dead client must not kill us.
+
+  // From here on, nobody else may touch the file.
+  List<iterate> Table;
+  lease_start(mult_name.c_str(), "coord"); // To look at the leases.
+  get_file(mult_name.c_str(), proc_name.c_str());
+  {
+    std::ofstream PidFile(pid_name.c_str(), ios::out);
+    PidFile << getpid() << "\n";
+  }
+  read_it_List(proc_name.c_str(), Table);
+  read_lease_List(lease_name.c_str(), Leases);
+  cout << "rodes_coord: " << Length(Table) << " iterates from "
+       << mult_name << "; listening on " << sock_name << endl;
+
+  std::vector<client> clients;
+  bool   dirty = reclaim_leases(Table);
+  time_t last_snapshot = time(NULL);
+  time_t last_reclaim  = time(NULL);
+
+  while ( !quitting )
+    {
+      std::vector<struct pollfd> fds(clients.size() + 1);
+      fds[0].fd = listen_fd;
+      fds[0].events = POLLIN;
+      for ( unsigned i = 0; i < clients.size(); i++ )
+	{
+	  fds[i + 1].fd = clients[i].fd;
+	  fds[i + 1].events = POLLIN;
+	}
+
+      int ready = poll(&fds[0], fds.size(), 1000 * COORD_HOLD / 2);
+      if ( ready < 0 && errno != EINTR )
+	break;
+
+      if ( ready > 0 )
+	{ // Serve the clients first; they may be closed below.
+	  for ( unsigned i = clients.size(); i > 0; i-- )
+	    if ( fds[i].revents & (POLLIN | POLLHUP | POLLERR) )
+	      {
+		serve_client(clients[i - 1], Table, dirty);
+		if ( clients[i - 1].fd < 0 )
+		  clients.erase(clients.begin() + (i - 1));
+	      }
+	  if ( fds[0].revents & POLLIN )
+	    {
+	      client c;
+	      c.fd = accept(listen_fd, NULL, NULL);
+	      c.owner = "-";
+	      c.waiting = false;
+	      if ( c.fd >= 0 )
+		clients.push_back(c);
+	    }
+	}
+
+      if ( difftime(time(NULL), last_reclaim) >= LEASE_BEAT )
+	{
+	  last_reclaim = time(NULL);
+	  if ( reclaim_leases(Table) )
+	    dirty = table_changed = true;
+	}
+
+      if ( table_changed )
+	{ // Try again to serve the held GETs.
+	  table_changed = false;
+	  for ( unsigned i = 0; i < clients.size(); i++ )
+	    if ( clients[i].waiting )
+	      serve_get(clients[i], Table, dirty);
+	}
+
+      // A GET held too long is answered WAIT, and asked again: the
+      // client then knows that we are still there.
+      for ( unsigned i = 0; i < clients.size(); i++ )
+	if ( clients[i].waiting &&
+	     difftime(time(NULL), clients[i].since) >= COORD_HOLD )
+	  {
+	    clients[i].waiting = false;
+	    coord_write_all(clients[i].fd, "WAIT\n");
+	  }
+
+      if ( dirty && difftime(time(NULL), last_snapshot) >= SNAPSHOT_INTERVAL )
+	{
+	  write_it_List(proc_name.c_str(), Table);
+	  write_leases(lease_name, clients);
+	  last_snapshot = time(NULL);
+	  dirty = false;
+	}
+    }
+
+  for ( unsigned i = 0; i < clients.size(); i++ )
+    close(clients[i].fd);
+  close(listen_fd);
+  unlink(sock_name.c_str());
+
+  write_it_List(proc_name.c_str(), Table);
+  write_leases(lease_name, clients); // They go on with the file.
+  release_file(mult_name.c_str(), proc_name.c_str());
+  unlink(pid_name.c_str());
+  lease_stop();
+  cout << "rodes_coord: released " << mult_name << endl;
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: the system (SIGINT, SIGTERM)
+// Calls to : none
+static void on_signal(int)
+{
+  quitting = 1;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main'
+// Calls to : 'serve_request', 'lease_expired', 'release_grids'
+// Reads what is available from the client, and serves all
+// complete requests. Sets c.fd = -1 if the client has gone. The
+// grids it was working on are given back if its heartbeat has
+// stopped (or it never said who it is). Else it may only have lost
+// us, and go on with the shared file: they stay leased to it, and
+// 'reclaim_leases' gives them back when its lease expires.
+static void serve_client(client &c, List<iterate> &Table, bool &dirty)
+{
+  char chunk[4096];
+  ssize_t n = read(c.fd, chunk, sizeof(chunk));
+
+  if ( n < 0 && errno == EINTR )
+    return;
+  if ( n <= 0 )
+    {
+      close(c.fd);
+      c.fd = -1;
+      if ( !c.taken.empty() )
+	{
+	  List<grid> lost;
+	  lease temp;
+	  bool alive = ( c.owner != "-" && !lease_expired(c.owner) );
+
+	  temp.owner = c.owner;
+	  for ( unsigned i = 0; i < c.taken.size(); i++ )
+	    {
+	      temp.grd = c.taken[i];
+	      if ( alive )
+		Leases += temp;
+	      else
+		lost += c.taken[i];
+	    }
+	  release_grids(Table, lost);
+	  c.taken.clear();
+	  dirty = true;
+	  table_changed = true;
+	}
+      return;
+    }
+  c.buffer.append(chunk, n);
+
+  while ( serve_request(c, Table, dirty) )
+    { /* Serve the next request, if it has arrived. */ }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'serve_client'
+// Calls to : 'own_leases', 'release_grids', 'serve_get', 'drop_leases',
+//            'merge_it_List', 'coord_write_all'
+// Serves the first request in c.buffer, if it is complete.
+// Returns false if there is nothing (complete) left to serve.
+static bool serve_request(client &c, List<iterate> &Table, bool &dirty)
+{
+  if ( c.waiting ) // Its GET must be answered first.
+    return false;
+
+  std::string::size_type end = c.buffer.find('\n');
+  if ( end == std::string::npos )
+    return false;
+
+  std::string line = c.buffer.substr(0, end);
+
+  if ( line.compare(0, 6, "HELLO ") == 0 )
+    {
+      std::istringstream in(line.substr(6));
+      List<grid> resumed, own;
+      long pid = 0;
+      int count = 0;
+      grid g;
+
+      c.buffer.erase(0, end + 1);
+      if ( !(in >> c.owner) )
+	c.owner = "-";
+      in >> pid >> count;
+      for ( int i = 0; i < count && in >> g; i++ )
+	resumed += g;
+      if ( c.owner != "-" && pid > 0 && runs[c.owner] != pid )
+	{ // A new run: the grids of the last one are not being done.
+	  runs[c.owner] = pid;
+	  own_leases(Leases, c.owner, resumed, own);
+	  if ( !IsEmpty(own) )
+	    {
+	      release_grids(Table, own);
+	      dirty = true;
+	      table_changed = true;
+	    }
+	}
+      return true;
+    }
+
+  if ( line == "GET" )
+    {
+      c.buffer.erase(0, end + 1);
+      c.waiting = true;
+      c.since = time(NULL);
+      serve_get(c, Table, dirty);
+      return true;
+    }
+
+  if ( line.compare(0, 4, "PUT ") == 0 )
+    {
+      int count = 0, external = 0;
+      std::istringstream head(line.substr(4));
+      head >> count >> external;
+
+      // Wait until all 'count' iterates have arrived.
+      std::string::size_type pos = end + 1;
+      for ( int i = 0; i < count; i++ )
+	{
+	  pos = c.buffer.find('\n', pos);
+	  if ( pos == std::string::npos )
+	    return false;
+	  pos++;
+	}
+
+      List<iterate> Add_List;
+      iterate it;
+      std::istringstream body(c.buffer.substr(end + 1, pos - end - 1));
+      while ( body >> it )
+	Add_List += it;
+      c.buffer.erase(0, pos);
+
+      // The source iterates (not NOT_DONE) are the grids it has done.
+      if ( !IsEmpty(Add_List) )
+	for ( First(Add_List); !Finished(Add_List); Next(Add_List) )
+	  {
+	    const new_data_line &ndl = Current(Add_List).ndl;
+	    for ( unsigned i = 0; i < c.taken.size(); i++ )
+	      if ( ndl.c_stat != NOT_DONE && c.taken[i] == ndl.grd )
+		{
+		  c.taken.erase(c.taken.begin() + i);
+		  break;
+		}
+	  }
+      drop_leases(Leases, Add_List); // Done by a process that was not ours.
+      merge_it_List(Table, Add_List, external != 0);
+      dirty = true;
+      table_changed = true;
+      coord_write_all(c.fd, "OK\n");
+      return true;
+    }
+
+  cout << "rodes_coord: unknown request '" << line << "'" << endl;
+  c.buffer.erase(0, end + 1);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'serve_request', 'main'
+// Calls to : 'take_fresh_grid', 'coord_write_all'
+// Answers the held GET of c, unless we have to wait for
+// the grids being done by others.
+static void serve_get(client &c, List<iterate> &Table, bool &dirty)
+{
+  iterate it;
+  find_result result = take_fresh_grid(Table, it);
+  std::ostringstream out;
+
+  if ( result == WAITING_FOR_ONE )
+    return;
+  if ( result == GOT_ONE )
+    {
+      out << "GOT " << it << endl;
+      c.taken.push_back(it.ndl.grd);
+      dirty = true;
+    }
+  else
+    out << "NONE" << endl;
+  c.waiting = false;
+  coord_write_all(c.fd, out.str());
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main'
+// Calls to : 'expired_leases', 'release_grids'
+// Gives back the grids of the expired leases in Leases. Returns true
+// if there were any.
+static bool reclaim_leases(List<iterate> &Table)
+{
+  List<grid> expired;
+
+  expired_leases(Leases, expired);
+  release_grids(Table, expired);
+  return !IsEmpty(expired);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main'
+// Calls to : 'write_lease_List'
+// Writes Leases, and the grids taken by our clients, to 'lease_name'.
+static void write_leases(const std::string &lease_name,
+			 std::vector<client> &clients)
+{
+  List<lease> lease_List;
+  lease temp;
+
+  if ( !IsEmpty(Leases) )
+    for ( First(Leases); !Finished(Leases); Next(Leases) )
+      lease_List += Current(Leases);
+  for ( unsigned i = 0; i < clients.size(); i++ )
+    for ( unsigned j = 0; j < clients[i].taken.size(); j++ )
+      {
+	temp.owner = clients[i].owner;
+	temp.grd   = clients[i].taken[j];
+	lease_List += temp;
+      }
+  write_lease_List(lease_name.c_str(), lease_List);
+}
+
+////////////////////////////////////////////////////////////////////
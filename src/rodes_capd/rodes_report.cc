@@ -0,0 +1,181 @@
+/*   File: rodes_report.cc
+
+     Sums up the records of <shared_file>.stats (see
+     'telemetry.h') by zone (see 'zone.h'): the number
+     of grids done (and failed), the wall and CPU times,
+     the mean counts of the integrator per grid, the
+     steps ('Flow') per return and the share of them that
+     were clipped (see 'step_control' in return_map.cc).
+     Then lists the [n] slowest grids (default 10).
+
+     Usage: rodes_report <shared_file> [n]
+
+     Compilation: make rodes_report
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include "telemetry.h"
+#include "zone.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+class zone_sum
+{
+ public:
+  zone_sum() : grids(0), failed(0), wall(0.0), max_wall(0.0), cpu(0.0),
+	       flow_steps(0.0), multiple_partitions(0.0),
+	       pieces(0.0), switches(0.0), cube_exits(0.0),
+	       peak_parcels(0), returns(0.0), clipped_steps(0.0) {}
+
+  void add (const grid_stats &);
+
+  int    grids, failed;
+  double wall, max_wall, cpu;
+  double flow_steps, multiple_partitions, pieces;
+  double switches, cube_exits;
+  int    peak_parcels;
+  double returns, clipped_steps;
+};
+
+static bool slower      (const grid_stats &, const grid_stats &);
+static void print_sums  (const char *, const zone_sum &);
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: none
+// Calls to : 'Get_Grid_Zone', 'zone_sum::add', 'print_sums'
+int main(int argc, char *argv[])
+{
+  if ( argc != 2 && argc != 3 )
+    {
+      cout << endl << "Usage: " << endl;
+      cout << "\t" << argv[0] << " <shared_file> [n]\n\n"
+	   << "\twhich sums up <shared_file>" << STATS_SUFFIX
+	   << " by zone, and lists\n"
+	   << "\tthe [n] (default 10) slowest grids.\n" << endl;
+      exit(0);
+    }
+
+  std::string stats_name = std::string(argv[1]) + STATS_SUFFIX;
+  std::ifstream InFile(stats_name.c_str(), ios::in);
+  if ( !InFile )
+    {
+      cout << "Error: cannot read " << stats_name << endl;
+      exit(1);
+    }
+
+  unsigned slowest = ( argc == 3 ? atoi(argv[2]) : 10 );
+  std::vector<zone_sum> zones(ZONES + 1);
+  std::vector<grid_stats> slow;
+  zone_sum total;
+  grid_stats st;
+
+  while ( InFile >> st )
+    {
+      zones[Get_Grid_Zone(st.grd)].add(st);
+      total.add(st);
+      if ( slowest > 0 )
+	{ // Keep the slowest, in decreasing order of wall time.
+	  slow.insert(upper_bound(slow.begin(), slow.end(), st, slower), st);
+	  if ( slow.size() > slowest )
+	    slow.pop_back();
+	}
+    }
+
+  cout << "zone   grids failed    wall(h)  mean(s)   max(s)  cpu(s)"
+       << "    flows  m.part  pieces  switch  cube  peak  f/ret clip%" << endl;
+  for ( int zone = 1; zone <= ZONES; zone++ )
+    if ( zones[zone].grids > 0 )
+      {
+	char name[8];
+	snprintf(name, sizeof(name), "#%d", zone);
+	print_sums(name, zones[zone]);
+      }
+  print_sums("all", total);
+
+  if ( !slow.empty() )
+    {
+      cout << endl << "The slowest grids:" << endl;
+      for ( unsigned i = 0; i < slow.size(); i++ )
+	cout << "  " << slow[i].grd << "   zone #" << Get_Grid_Zone(slow[i].grd)
+	     << "   " << fixed << setprecision(1) << slow[i].wall << " s"
+	     << ( slow[i].c_stat == FAILED ? "   (failed)" : "" ) << endl;
+    }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////
+
+void zone_sum::add(const grid_stats &st)
+{
+  grids++;
+  if ( st.c_stat == FAILED )
+    failed++;
+  wall                += st.wall;
+  cpu                 += st.cpu;
+  flow_steps          += st.flow_steps;
+  multiple_partitions += st.multiple_partitions;
+  pieces              += st.pieces;
+  switches            += st.switches;
+  cube_exits          += st.cube_exits;
+  returns             += st.returns;
+  clipped_steps       += st.clipped_steps;
+  if ( st.wall > max_wall )
+    max_wall = st.wall;
+  if ( st.peak_parcels > peak_parcels )
+    peak_parcels = st.peak_parcels;
+}
+
+////////////////////////////////////////////////////////////////////
+
+static bool slower(const grid_stats &a, const grid_stats &b)
+{
+  return ( a.wall > b.wall );
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Prints one line of the table: the totals of the times, the means
+// of the counts (per grid), the largest peak, and the steps per return.
+static void print_sums(const char *name, const zone_sum &sum)
+{
+  double n = ( sum.grids > 0 ? sum.grids : 1 );
+  double f = ( sum.flow_steps > 0 ? sum.flow_steps : 1 );
+
+  cout << setw(4) << name << " " << setw(7) << sum.grids << " "
+       << setw(6) << sum.failed << " "
+       << fixed << setprecision(2)
+       << setw(10) << sum.wall / 3600 << " "
+       << setprecision(1)
+       << setw(8) << sum.wall / n << " " << setw(8) << sum.max_wall << " "
+       << setw(7) << sum.cpu / n << " "
+       << setprecision(0)
+       << setw(8) << sum.flow_steps / n << " "
+       << setw(7) << sum.multiple_partitions / n << " "
+       << setw(7) << sum.pieces / n << " "
+       << setw(7) << sum.switches / n << " "
+       << setprecision(1)
+       << setw(5) << sum.cube_exits / n << " "
+       << setw(5) << sum.peak_parcels << " ";
+  if ( sum.returns > 0 )     // Not in older records.
+    cout << setw(6) << sum.flow_steps / sum.returns << " "
+	 << setw(5) << 100.0 * sum.clipped_steps / f << endl;
+  else
+    cout << setw(6) << "-" << " " << setw(5) << "-" << endl;
+  cout.unsetf(ios::fixed);
+}
+
+////////////////////////////////////////////////////////////////////
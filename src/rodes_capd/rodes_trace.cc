@@ -0,0 +1,103 @@
+/*   File: rodes_trace.cc
+
+     Prints the records of a trace (see 'trace.h'), one
+     per line:
+
+       <thread>:<seq> <kind> trvl=<+-trvl> <box> <a> <b>
+
+     Only those up to [level] (default: all), and, given
+     [thread], only those of that thread.
+
+     Usage: rodes_trace <trace_file> [level] [thread]
+
+     Compilation: make rodes_trace
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+
+#include "trace.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+static void print_record (const trace_record &);
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: none
+// Calls to : 'print_record'
+int main(int argc, char *argv[])
+{
+  if ( argc < 2 || argc > 4 )
+    {
+      cout << endl << "Usage: " << endl;
+      cout << "\t" << argv[0] << " <trace_file> [level] [thread]\n\n"
+	   << "\twhich prints the records of <trace_file> (written by\n"
+	   << "\t'rodes --trace L'), up to [level], of [thread] only.\n" << endl;
+      exit(0);
+    }
+
+  std::ifstream InFile(argv[1], ios::in | ios::binary);
+  char magic[sizeof(TRACE_MAGIC)];
+  int size;
+  if ( !InFile.read(magic, sizeof(magic)) ||
+       memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0 ||
+       !InFile.read((char *) &size, sizeof(size)) )
+    {
+      cout << "Error: " << argv[1] << " is not a trace." << endl;
+      exit(1);
+    }
+  if ( size != (int) sizeof(trace_record) )
+    {
+      cout << "Error: " << argv[1] << " was written by another build"
+	   << " (records of " << size << " bytes, not "
+	   << sizeof(trace_record) << ")." << endl;
+      exit(1);
+    }
+
+  int level  = ( argc >= 3 ? atoi(argv[2]) : 99 );
+  int thread = ( argc == 4 ? atoi(argv[3]) : -1 );
+  trace_record rec;
+  long shown = 0, total = 0;
+
+  cout.precision(NUMBER_OF_DIGITS);
+  cout.setf(ios::scientific);
+  while ( InFile.read((char *) &rec, sizeof(rec)) )
+    {
+      total++;
+      if ( rec.level <= level && ( thread < 0 || rec.thread == thread ) )
+	{
+	  print_record(rec);
+	  shown++;
+	}
+    }
+  cout.unsetf(ios::scientific);
+  cout << shown << " of " << total << " records." << endl;
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main'
+// Calls to : none
+static void print_record(const trace_record &rec)
+{
+  cout << rec.thread << ":" << rec.seq << " "
+       << setw(11) << left
+       << ( rec.kind < TRACE_KINDS ? TRACE_KIND_NAMES[rec.kind] : "?" )
+       << right << " trvl=" << ( rec.sign < 0 ? "-" : "+" ) << rec.trvl << " ";
+  for ( short i = 0; i < SYSDIM; i++ )
+    cout << ( i == 0 ? "" : "x" )
+	 << "[" << rec.box[2 * i] << "," << rec.box[2 * i + 1] << "]";
+  cout << " " << rec.a << " " << rec.b << endl;
+}
+
+////////////////////////////////////////////////////////////////////
@@ -0,0 +1,341 @@
+/*   File: rodes_tune.cc
+
+     Tunes the zone table (see 'zone.h') on sample grids
+     of <shared_file>. For each zone, [n] of its grids
+     (default 3, spread over the file) are flowed with each
+     'max_size' and 'more_than_one' of a sweep around the
+     table, for each 'scale_factor' of a sweep. A setting
+     succeeds for a zone if all of its samples are done
+     (no 'Error_Handler' thrown); the fastest one is kept.
+     The fastest 'scale_factor' for which every zone has a
+     setting that succeeds is written, with those settings,
+     to <shared_file>.zones, to be read by 'rodes --zones'.
+
+     Every run of a sample is added to <shared_file>.tune:
+     "<zone> <scale_factor> <max_size> <more_than_one>
+     <grid> <wall> <1 if done>". A setting is dropped as
+     soon as its samples take longer than the best one so
+     far.
+
+     The 'cost' of the zones is set to their mean time per
+     sample, relative to the cheapest zone, if all zones
+     have samples; else it is left as it is.
+
+     Usage: rodes_tune [--zones <file>] [--taylor N] [--lohner]
+                       <shared_file> [n] [zone]
+
+     With [zone], only that zone is tuned (the others are
+     written as they are). The options are those of 'rodes',
+     and should be the ones the table is tuned for.
+
+     Compilation: make rodes_tune
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/time.h>
+
+#include "2d_classes.h"
+#include "classes.h"
+#include "convert.h"
+#include "error_handler.h"
+#include "list.h"
+#include "lohner.h"
+#include "return_map.h"
+#include "share_table.h"
+#include "taylor.h"
+#include "workspace.h"
+#include "zone.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+const char TUNE_SUFFIX[]  = ".tune";
+const char ZONES_SUFFIX[] = ".zones";
+
+// The sweep: 'max_size' is that of the table times SIZE_STEPS.
+static const double SIZE_STEPS[]    = { 0.5, 0.7, 1.0, 1.4, 2.0 };
+static const double MORE_THAN_ONE[] = { 1.1, 1.2, 1.3 };
+static const double SCALES[]        = { 1.05, 1.1, 1.2 };
+
+static const int SIZE_COUNT  = sizeof(SIZE_STEPS) / sizeof(double);
+static const int MORE_COUNT  = sizeof(MORE_THAN_ONE) / sizeof(double);
+static const int SCALE_COUNT = sizeof(SCALES) / sizeof(double);
+
+static void   get_the_options (int &, char *[]);
+static void   pick_samples    (List<iterate> &, const int &,
+			       std::vector<std::vector<iterate> > &);
+static double tune_zone       (const int &, const std::vector<iterate> &,
+			       zone_parameters &, ostream &);
+static bool   run_sample      (const iterate &, double &);
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: none
+// Calls to : 'get_the_options', 'read_it_List', 'pick_samples',
+//            'tune_zone', 'Set_Scale_Factor', 'Set_Zone_Parameters',
+//            'Write_Zones'
+int main(int argc, char *argv[])
+{
+  get_the_options(argc, argv);
+  if ( argc < 2 || argc > 4 )
+    {
+      cout << endl << "Usage: " << endl;
+      cout << "\t" << argv[0] << " [--zones <file>] [--taylor N] [--lohner]\n"
+	   << "\t\t<shared_file> [n] [zone]\n\n"
+	   << "\twhich flows [n] (default 3) grids of <shared_file> from each\n"
+	   << "\tzone (or from [zone] only) over a sweep of the zone table,\n"
+	   << "\tand writes the fastest table that does them all to\n"
+	   << "\t<shared_file>" << ZONES_SUFFIX << " (each run is added to <shared_file>"
+	   << TUNE_SUFFIX << ").\n" << endl;
+      exit(0);
+    }
+
+  std::string mult_name = argv[1];
+  int samples = ( argc >= 3 ? atoi(argv[2]) : 3 );
+  int only    = ( argc == 4 ? atoi(argv[3]) : 0 );
+  if ( samples < 1 || only < 0 || only > ZONES )
+    {
+      cout << "Error: bad [n] or [zone]." << endl;
+      exit(1);
+    }
+
+  List<iterate> it_List;
+  std::vector<std::vector<iterate> > sample(ZONES + 1);
+  read_it_List(mult_name.c_str(), it_List);
+  if ( IsEmpty(it_List) )
+    {
+      cout << "Error: no grids in " << mult_name << endl;
+      exit(1);
+    }
+  pick_samples(it_List, samples, sample);
+
+  std::string tune_name = mult_name + TUNE_SUFFIX;
+  std::ofstream TuneFile(tune_name.c_str(), ios::out | ios::app);
+
+  std::vector<zone_parameters> base(ZONES + 1), best(ZONES + 1), trial(ZONES + 1);
+  std::vector<double> best_mean(ZONES + 1, 0.0), trial_mean(ZONES + 1, 0.0);
+  double best_total = HUGE_VAL;
+  double best_scale = Get_Scale_Factor();
+  for ( int zone = 1; zone <= ZONES; zone++ )
+    base[zone] = best[zone] = Get_Zone_Parameters(zone);
+
+  for ( int k = 0; k < SCALE_COUNT; k++ )
+    {
+      double total = 0.0;
+      bool all_done = true;
+
+      Set_Scale_Factor(SCALES[k]);
+      for ( int zone = 1; zone <= ZONES && all_done; zone++ )
+	{
+	  trial[zone] = base[zone];
+	  trial_mean[zone] = 0.0;
+	  if ( (only > 0 && zone != only) || sample[zone].empty() )
+	    continue;
+	  double time = tune_zone(zone, sample[zone], trial[zone], TuneFile);
+	  Set_Zone_Parameters(zone, base[zone]);
+	  if ( time == HUGE_VAL )
+	    {
+	      cout << "scale_factor " << SCALES[k] << ": no setting does zone #"
+		   << zone << endl;
+	      all_done = false;
+	    }
+	  total += time;
+	  trial_mean[zone] = time / sample[zone].size();
+	}
+      if ( !all_done )
+	continue;
+      cout << "scale_factor " << SCALES[k] << ": " << total << " seconds in all." << endl;
+      if ( total < best_total )
+	{
+	  best_total = total;
+	  best_scale = SCALES[k];
+	  best = trial;
+	  best_mean = trial_mean;
+	}
+    }
+
+  if ( best_total == HUGE_VAL )
+    {
+      cout << "Error: no scale_factor does all the samples." << endl;
+      exit(1);
+    }
+
+  // The costs, relative to the cheapest zone.
+  double cheapest = HUGE_VAL;
+  bool all_zones = ( only == 0 );
+  for ( int zone = 1; zone <= ZONES; zone++ )
+    {
+      if ( best_mean[zone] <= 0.0 )
+	all_zones = false;
+      else if ( best_mean[zone] < cheapest )
+	cheapest = best_mean[zone];
+    }
+  for ( int zone = 1; zone <= ZONES; zone++ )
+    {
+      if ( all_zones )
+	best[zone].cost = best_mean[zone] / cheapest;
+      Set_Zone_Parameters(zone, best[zone]);
+    }
+  Set_Scale_Factor(best_scale);
+
+  std::string zones_name = mult_name + ZONES_SUFFIX;
+  std::ofstream ZoneFile(zones_name.c_str(), ios::out);
+  Write_Zones(ZoneFile);
+  ZoneFile.close();
+  Write_Zones(cout);
+  cout << "Written to " << zones_name << endl;
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main'
+// Calls to : 'Read_Zones', 'Set_Taylor_Order', 'Set_Lohner'
+// Strips the leading '--' options from argv (as 'rodes' does).
+static void get_the_options(int &argc, char *argv[])
+{
+  int i = 1;
+
+  while ( i < argc && strncmp(argv[i], "--", 2) == 0 )
+    {
+      if ( strcmp(argv[i], "--zones") == 0 && i + 1 < argc )
+	{
+	  if ( !Read_Zones(argv[i + 1]) )
+	    exit(1);
+	  i += 2;
+	}
+      else if ( strcmp(argv[i], "--taylor") == 0 && i + 1 < argc &&
+		atoi(argv[i + 1]) >= 0 )
+	{
+	  Set_Taylor_Order(atoi(argv[i + 1]));
+	  i += 2;
+	}
+      else if ( strcmp(argv[i], "--lohner") == 0 )
+	{
+	  Set_Lohner(true);
+	  i++;
+	}
+      else
+	{
+	  cout << "Unknown option: " << argv[i] << endl;
+	  exit(1);
+	}
+    }
+
+  for ( int j = i; j <= argc; j++ ) // Also moves argv[argc] == NULL.
+    argv[j - i + 1] = argv[j];
+  argc -= i - 1;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main'
+// Calls to : 'Get_Grid_Zone'
+// Picks (at most) n iterates of each zone from it_List, evenly
+// spread over those of the zone.
+static void pick_samples(List<iterate> &it_List, const int &n,
+			 std::vector<std::vector<iterate> > &sample)
+{
+  std::vector<std::vector<iterate> > all(ZONES + 1);
+
+  First(it_List);
+  while ( !Finished(it_List) )
+    {
+      iterate it = Current(it_List);
+      it.ndl.c_stat = NOT_DONE;
+      all[Get_Grid_Zone(it.ndl.grd)].push_back(it);
+      Next(it_List);
+    }
+  for ( int zone = 1; zone <= ZONES; zone++ )
+    {
+      int count = all[zone].size();
+      int take  = ( count < n ? count : n );
+      for ( int i = 0; i < take; i++ )
+	sample[zone].push_back(all[zone][(2 * i + 1) * count / (2 * take)]);
+      cout << "Zone #" << zone << ": " << take << " of " << count << " grids." << endl;
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main'
+// Calls to : 'Set_Zone_Parameters', 'run_sample'
+// Flows the samples of 'zone' with each setting of the sweep around
+// 'param', and returns the time of the fastest setting that does them
+// all, which is returned in 'param'. Returns HUGE_VAL (and leaves
+// 'param') if there is none.
+static double tune_zone(const int &zone, const std::vector<iterate> &sample,
+			zone_parameters &param, ostream &log)
+{
+  const zone_parameters base = param;
+  double best_time = HUGE_VAL;
+
+  for ( int i = 0; i < SIZE_COUNT; i++ )
+    for ( int j = 0; j < MORE_COUNT; j++ )
+      {
+	zone_parameters trial = base;
+	trial.max_size      = base.max_size * SIZE_STEPS[i];
+	trial.more_than_one = MORE_THAN_ONE[j];
+	Set_Zone_Parameters(zone, trial);
+
+	double time = 0.0;
+	bool done = true;
+	for ( unsigned s = 0; s < sample.size() && done && time < best_time; s++ )
+	  {
+	    double wall;
+	    done = run_sample(sample[s], wall);
+	    time += wall;
+	    log << zone << " " << Get_Scale_Factor() << " " << trial.max_size << " "
+		<< trial.more_than_one << " " << sample[s].ndl.grd << " "
+		<< wall << " " << ( done ? 1 : 0 ) << endl;
+	  }
+	if ( done && time < best_time )
+	  {
+	    best_time = time;
+	    param = trial;
+	  }
+      }
+  return best_time;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'tune_zone'
+// Calls to : 'iterate_to_parcel', 'Compute_the_return'
+// Flows the grid of 'it' (as 'work_on_grid' in rodes does), and gives
+// the wall time it took. Returns false if the integrator gave up.
+static bool run_sample(const iterate &it, double &wall)
+{
+  parcel pcl;
+  List<parcel> pcl_List;
+  struct timeval start, stop;
+  bool done = true;
+
+  iterate_to_parcel(it, pcl);
+  Thread_Workspace().stats.clear();
+  gettimeofday(&start, NULL);
+  try
+    {
+      Compute_the_return(pcl, pcl_List);
+    }
+  catch( Error_Handler error )
+    {
+      done = false;
+    }
+  gettimeofday(&stop, NULL);
+  wall = (stop.tv_sec - start.tv_sec) + 1e-6 * (stop.tv_usec - start.tv_usec);
+  return done;
+}
+
+////////////////////////////////////////////////////////////////////
@@ -0,0 +1,554 @@
+/*   File: share_journal.cc
+
+     The journal of a shared (text) file.
+     See 'share_journal.h' for the format.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "grid_hash.h"
+#include "lease.h"
+#include "share_journal.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+static std::string     shared_name;         // The snapshot, <shared_file>.
+static std::string     journal_name;        // <shared_file>.journal
+static int             journal_fd = -1;
+static List<iterate>   Table;               // The snapshot, replayed up to...
+static List<lease>     Leases;              // (the leases of Table)
+static off_t           journal_offset = 0;  // ...here in the journal...
+static int             table_gen = -1;      // ...of this generation.
+static pthread_mutex_t journal_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void journal_error    (const char *);
+static void journal_lock     ();
+static void journal_unlock   ();
+static void journal_catch_up ();
+static void journal_restart  (const int &);
+static void journal_append   (const std::string &);
+static void compact_table    ();
+static int  read_generation  ();
+static int  read_snapshot    (List<iterate> &);
+static void replay_line      (const std::string &);
+static void take_grids       (List<iterate> &, List<grid> &);
+static void clear_table      ();
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_the_flags' (rodes), 'main' (rodes_coord, rodes_convert)
+// Calls to : none
+bool journal_exists(const char *shared_file)
+{
+  std::string name = std::string(shared_file) + JOURNAL_SUFFIX;
+  return ( access(name.c_str(), F_OK) == 0 );
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_the_flags' (rodes), 'main' (rodes_compact)
+// Calls to : 'journal_error'
+// Opens the journal of 'shared_file', creating it if needed.
+void journal_open(const char *shared_file)
+{
+  shared_name  = shared_file;
+  journal_name = shared_name + JOURNAL_SUFFIX;
+
+  journal_fd = open(journal_name.c_str(), O_RDWR | O_CREAT | O_APPEND, 0666);
+  if ( journal_fd < 0 )
+    journal_error(journal_name.c_str());
+  table_gen = -1; // Nothing read yet.
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'terminate_process' (rodes), 'main' (rodes_compact)
+// Calls to : none
+void journal_close()
+{
+  if ( journal_fd >= 0 )
+    close(journal_fd);
+  journal_fd = -1;
+  clear_table();
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_a_grid' (rodes)
+// Calls to : 'journal_lock', 'expired_leases', 'release_grids',
+//            'take_fresh_grids', 'add_leases', 'journal_append',
+//            'journal_unlock'
+// The journal version of 'find_fresh_grids'.
+find_result journal_take_fresh_grids(List<iterate> &taken, const int &max)
+{
+  List<grid> expired;
+
+  journal_lock();
+  expired_leases(Leases, expired);
+  if ( !IsEmpty(expired) )
+    {
+      std::ostringstream line;
+      line << "R " << Length(expired);
+      for ( First(expired); !Finished(expired); Next(expired) )
+	line << "   " << Current(expired);
+      line << "\n";
+      journal_append(line.str());
+      release_grids(Table, expired);
+    }
+
+  find_result result = take_fresh_grids(Table, taken, max);
+  if ( result == GOT_ONE )
+    {
+      std::ostringstream line;
+      line << "C " << (lease_owner().empty() ? "-" : lease_owner())
+	   << " " << Length(taken);
+      for ( First(taken); !Finished(taken); Next(taken) )
+	line << "   " << Current(taken);
+      line << "\n";
+      journal_append(line.str());
+      add_leases(Leases, taken, lease_owner());
+    }
+  journal_unlock();
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'release_own_grids' (rodes)
+// Calls to : 'journal_lock', 'own_leases', 'journal_append',
+//            'release_grids', 'journal_unlock'
+// Gives back the grids an earlier run under our [proc_nr] left
+// leased to us, except those in 'resumed'.
+void journal_release_own(List<grid> &resumed)
+{
+  List<grid> own;
+
+  journal_lock();
+  own_leases(Leases, lease_owner(), resumed, own);
+  if ( !IsEmpty(own) )
+    {
+      std::ostringstream line;
+      line << "R " << Length(own);
+      for ( First(own); !Finished(own); Next(own) )
+	line << "   " << Current(own);
+      line << "\n";
+      journal_append(line.str());
+      release_grids(Table, own);
+    }
+  journal_unlock();
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'insert_it_List' (rodes)
+// Calls to : 'journal_lock', 'journal_append', 'drop_leases',
+//            'merge_it_List', 'compact_table', 'journal_unlock'
+// The journal version of 'insert_it_List'. Add_List is emptied.
+void journal_merge_it_List(List<iterate> &Add_List, const bool &external_input)
+{
+  std::ostringstream line;
+
+  line << "M " << (external_input ? 1 : 0) << " " << Length(Add_List);
+  if ( !IsEmpty(Add_List) )
+    {
+      First(Add_List);
+      while( !Finished(Add_List) )
+	{
+	  line << "   " << Current(Add_List);
+	  Next(Add_List);
+	}
+    }
+  line << "\n";
+
+  journal_lock();
+  journal_append(line.str());
+  drop_leases(Leases, Add_List);
+  merge_it_List(Table, Add_List, external_input);
+  if ( journal_offset > JOURNAL_COMPACT_SIZE )
+    compact_table();
+  journal_unlock();
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main' (rodes_compact)
+// Calls to : 'journal_lock', 'compact_table', 'journal_unlock'
+// Folds the journal into the shared file now.
+void journal_compact()
+{
+  journal_lock();
+  compact_table();
+  journal_unlock();
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: most functions in this file.
+// Calls to : 'exit(1)'
+static void journal_error(const char *what)
+{
+  cout << "Error: share_journal: " << what << ": " << strerror(errno) << endl;
+  exit(1);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'journal_take_fresh_grids', 'journal_merge_it_List',
+//            'journal_compact'
+// Calls to : 'journal_error', 'journal_catch_up'
+// Locks out the other threads (mutex) and processes (fcntl), and
+// brings Table up to date.
+static void journal_lock()
+{
+  struct flock fl;
+
+  pthread_mutex_lock(&journal_mutex);
+
+  memset(&fl, 0, sizeof(fl));
+  fl.l_type   = F_WRLCK;
+  fl.l_whence = SEEK_SET;
+  fl.l_start  = 0;
+  fl.l_len    = 0; // All of the file.
+  while ( fcntl(journal_fd, F_SETLKW, &fl) != 0 )
+    if ( errno != EINTR )
+      journal_error("fcntl");
+
+  journal_catch_up();
+}
+
+////////////////////////////////////////////////////////////////////
+
+static void journal_unlock()
+{
+  struct flock fl;
+
+  memset(&fl, 0, sizeof(fl));
+  fl.l_type   = F_UNLCK;
+  fl.l_whence = SEEK_SET;
+  fl.l_start  = 0;
+  fl.l_len    = 0;
+  fcntl(journal_fd, F_SETLK, &fl);
+
+  pthread_mutex_unlock(&journal_mutex);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'journal_lock'
+// Calls to : 'read_generation', 'read_snapshot', 'journal_restart',
+//            'replay_line', 'journal_error'
+// Replays the lines appended since we last looked. If the journal
+// has been folded into the shared file meanwhile, we start over
+// from the new shared file.
+static void journal_catch_up()
+{
+  int gen = read_generation();
+
+  if ( gen < 0 || gen != table_gen )
+    {
+      clear_table();
+      int snapshot_gen = read_snapshot(Table);
+      if ( gen > snapshot_gen )
+	{
+	  cout << "Error: " << journal_name << " is newer than "
+	       << shared_name << "!" << endl;
+	  exit(1);
+	}
+      if ( gen < snapshot_gen ) // Missing, or already folded in.
+	journal_restart(snapshot_gen);
+      else
+	{
+	  table_gen = gen;
+	  std::ostringstream head;
+	  head << "J " << gen << "\n";
+	  journal_offset = head.str().size();
+	}
+    }
+
+  struct stat st;
+  if ( fstat(journal_fd, &st) != 0 )
+    journal_error("fstat");
+  if ( st.st_size <= journal_offset )
+    return;
+
+  std::string tail(st.st_size - journal_offset, '\0');
+  if ( pread(journal_fd, &tail[0], tail.size(), journal_offset)
+       != (ssize_t) tail.size() )
+    journal_error("pread");
+
+  std::string::size_type begin = 0, end;
+  while ( (end = tail.find('\n', begin)) != std::string::npos )
+    {
+      replay_line(tail.substr(begin, end - begin));
+      begin = end + 1;
+    }
+  journal_offset += begin;
+
+  if ( begin < tail.size() ) // Cut short by a crash: drop it.
+    if ( ftruncate(journal_fd, journal_offset) != 0 )
+      journal_error("ftruncate");
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'journal_catch_up', 'compact_table'
+// Calls to : 'journal_error'
+// Empties the journal, and starts generation 'gen'.
+static void journal_restart(const int &gen)
+{
+  std::ostringstream head;
+  head << "J " << gen << "\n";
+
+  if ( ftruncate(journal_fd, 0) != 0 )
+    journal_error("ftruncate");
+  if ( write(journal_fd, head.str().data(), head.str().size())
+       != (ssize_t) head.str().size() )
+    journal_error("write");
+  table_gen = gen;
+  journal_offset = head.str().size();
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'journal_take_fresh_grids', 'journal_merge_it_List'
+// Calls to : 'journal_error'
+// Appends 'line' in a single write; we are at the end of the journal.
+static void journal_append(const std::string &line)
+{
+  ssize_t n;
+
+  while ( (n = write(journal_fd, line.data(), line.size())) < 0 && errno == EINTR )
+    { /* Try again. */ }
+  if ( n != (ssize_t) line.size() )
+    journal_error("write");
+  journal_offset += n;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'journal_merge_it_List', 'journal_compact'
+// Calls to : 'journal_error', 'journal_restart'
+// Writes Table to a new shared file, renames it into place, and
+// starts the next generation of the journal. A crash before the
+// rename leaves the old shared file and journal; a crash after it
+// leaves a journal older than the shared file, which is ignored.
+static void compact_table()
+{
+  std::string temp_name = shared_name + "_compact";
+  std::ofstream OutFile(temp_name.c_str(), ios::out);
+
+  if ( !IsEmpty(Table) )
+    {
+      First(Table);
+      while( !Finished(Table) )
+	{
+	  OutFile << Current(Table) << "\n";
+	  Next(Table);
+	}
+    }
+  if ( !IsEmpty(Leases) )
+    for ( First(Leases); !Finished(Leases); Next(Leases) )
+      OutFile << "# lease " << Current(Leases) << "\n";
+  OutFile << "# journal " << table_gen + 1 << endl;
+  OutFile.close();
+  if ( OutFile.fail() )
+    journal_error(temp_name.c_str());
+
+  if ( rename(temp_name.c_str(), shared_name.c_str()) != 0 )
+    journal_error(shared_name.c_str());
+  journal_restart(table_gen + 1);
+
+  cout << "Compacted " << journal_name << " into " << shared_name
+       << " (" << Length(Table) << " iterates)." << endl;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'journal_catch_up'
+// Calls to : 'journal_error'
+// Returns the generation on the first line of the journal,
+// or -1 if there is no (complete) first line.
+static int read_generation()
+{
+  char head[32];
+  ssize_t n = pread(journal_fd, head, sizeof(head) - 1, 0);
+
+  if ( n < 0 )
+    journal_error("pread");
+  head[n] = '\0';
+
+  int gen;
+  if ( strchr(head, '\n') == NULL || sscanf(head, "J %d", &gen) != 1 )
+    return -1;
+  return gen;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'journal_catch_up'
+// Calls to : 'exit(1)'
+// Reads the shared file into it_List (and its leases into Leases),
+// and returns the generation of the journal it starts (0 unless
+// written by 'compact_table').
+static int read_snapshot(List<iterate> &it_List)
+{
+  std::ifstream InFile(shared_name.c_str(), ios::in);
+  if ( !InFile )
+    { // Only the processes not using the journal rename it.
+      cout << "Error: " << shared_name << " is missing!" << endl;
+      exit(1);
+    }
+
+  iterate temp_it;
+  while ( InFile >> temp_it )
+    it_List += temp_it;
+
+  int gen = 0;
+  std::string line;
+  InFile.clear();
+  while ( getline(InFile, line) )
+    {
+      lease temp;
+      std::istringstream in(line);
+      std::string hash, tag;
+
+      in >> hash >> tag;
+      if ( tag == "journal" )
+	in >> gen;
+      else if ( tag == "lease" && in >> temp )
+	Leases += temp;
+    }
+
+  return gen;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'journal_catch_up'
+// Calls to : 'take_grids', 'add_leases', 'remove_leases',
+//            'release_grids', 'drop_leases', 'merge_it_List'
+// Applies one line of the journal to Table.
+static void replay_line(const std::string &line)
+{
+  std::istringstream in(line);
+  std::string tag;
+  int count = 0;
+  bool damaged = false;
+
+  in >> tag;
+  if ( tag == "C" )
+    {
+      std::string owner;
+      List<iterate> taken;
+      List<grid> grids;
+      iterate it;
+
+      in >> owner >> count;
+      for ( int i = 0; i < count && in >> it; i++ )
+	{
+	  taken += it;
+	  grids += it.ndl.grd;
+	}
+      damaged = ( Length(taken) != count );
+      if ( !damaged )
+	{
+	  take_grids(Table, grids);
+	  add_leases(Leases, taken, owner == "-" ? std::string() : owner);
+	}
+    }
+  else if ( tag == "R" )
+    {
+      List<grid> grids;
+      grid g;
+
+      in >> count;
+      for ( int i = 0; i < count && in >> g; i++ )
+	grids += g;
+      damaged = ( Length(grids) != count );
+      if ( !damaged )
+	{
+	  remove_leases(Leases, grids);
+	  release_grids(Table, grids);
+	}
+    }
+  else if ( tag == "M" )
+    {
+      int external = 0;
+      List<iterate> Add_List;
+      iterate it;
+
+      in >> external >> count;
+      for ( int i = 0; i < count && in >> it; i++ )
+	Add_List += it;
+      damaged = ( Length(Add_List) != count );
+      if ( !damaged )
+	{
+	  drop_leases(Leases, Add_List);
+	  merge_it_List(Table, Add_List, external != 0);
+	}
+    }
+  else
+    damaged = true;
+
+  if ( damaged )
+    cout << "Warning: ignored the journal line:" << endl << line << endl;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'replay_line'
+// Calls to : none
+// Replays 'take_fresh_grids': the first NOT_DONE iterate of each
+// grid in 'grids' becomes BEING_DONE.
+static void take_grids(List<iterate> &it_List, List<grid> &grids)
+{
+  grid_index take;
+
+  if ( IsEmpty(it_List) || IsEmpty(grids) )
+    return;
+  for ( First(grids); !Finished(grids); Next(grids) )
+    take.set(Current(grids), 1);
+
+  First(it_List);
+  while ( !Finished(it_List) )
+    {
+      iterate &temp_it = Current(it_List);
+      if ( temp_it.ndl.c_stat == NOT_DONE && take.find(temp_it.ndl.grd) >= 0 )
+	{
+	  take.set(temp_it.ndl.grd, -1);
+	  temp_it.ndl.c_stat = BEING_DONE;
+	}
+      Next(it_List);
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'journal_close', 'journal_catch_up'
+// Calls to : none
+static void clear_table()
+{
+  while ( !IsEmpty(Table) )
+    --Table;
+  while ( !IsEmpty(Leases) )
+    --Leases;
+  table_gen = -1;
+}
+
+////////////////////////////////////////////////////////////////////
@@ -0,0 +1,63 @@
+/*   File: share_journal.h
+
+     The journal of a shared (text) file <shared_file>.
+     Rather than rewriting <shared_file> for every grid,
+     the processes append one line per change to
+     <shared_file>.journal:
+
+       J <generation>                       (the first line)
+       C <owner> <n> <iterate> ... (n)      (grids were taken)
+       R <n> <grid> ... (n)                 (grids given back)
+       M <external> <n> <iterate> ... (n)   ('merge_it_List')
+
+     Each process keeps the table in memory, and brings
+     it up to date by replaying the lines appended by the
+     others since it last looked. The file locks are fcntl
+     locks on the journal, which vanish with a crashed
+     process; a line cut short by a crash is dropped.
+
+     When the journal grows beyond JOURNAL_COMPACT_SIZE,
+     it is folded into a new <shared_file> (renamed into
+     place), which ends with the leases ("# lease <owner>
+     <grid>") and the line "# journal <gen>".
+     The journal then starts over with generation <gen>.
+     A journal older than <shared_file> has already been
+     folded in, and is ignored.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#ifndef SHARE_JOURNAL_H
+#define SHARE_JOURNAL_H
+
+#include "2d_classes.h"
+#include "list.h"
+#include "share_table.h"
+
+////////////////////////////////////////////////////////////////////
+
+// The journal of <shared_file> is <shared_file> followed by this suffix.
+static const char JOURNAL_SUFFIX[] = ".journal";
+
+// Fold the journal into <shared_file> when it is this large (bytes).
+const long JOURNAL_COMPACT_SIZE = 32L * 1024 * 1024;
+
+////////////////////////////////////////////////////////////////////
+
+bool        journal_exists           (const char *);
+
+void        journal_open             (const char *);
+
+void        journal_close            ();
+
+find_result journal_take_fresh_grids (List<iterate> &, const int &);
+
+void        journal_release_own      (List<grid> &);
+
+void        journal_merge_it_List    (List<iterate> &, const bool &);
+
+void        journal_compact          ();
+
+////////////////////////////////////////////////////////////////////
+
+#endif // SHARE_JOURNAL_H
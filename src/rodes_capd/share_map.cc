@@ -0,0 +1,702 @@
+/*   File: share_map.cc
+
+     The binary, mmap'ed version of the shared file.
+     See 'share_map.h' for the layout.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "cost.h"
+#include "grid_hash.h"
+#include "lease.h"
+#include "share_map.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+static int             map_fd   = -1;   // The open binary file.
+static char           *map_base = NULL; // Where it is mapped...
+static size_t          map_size = 0;    // ...and how much of it.
+static pthread_mutex_t map_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Grid -> first slot holding it, for the slots before 'map_indexed'.
+// The records never move, so the other processes' appends are
+// simply added to the index when we next merge.
+static grid_index      map_index;
+static int32_t         map_indexed = 0;
+
+#ifdef COMPUTE_C1
+static const int32_t MAP_C1 = 1;
+#else
+static const int32_t MAP_C1 = 0;
+#endif
+
+static void         map_error          (const char *);
+static size_t       map_bytes          (const int32_t &);
+static map_header & header             ();
+static map_record & record             (const int32_t &);
+static void         map_remap          ();
+static void         map_lock           ();
+static void         map_unlock         ();
+static void         map_grow           (const int32_t &);
+static void         map_hint           (const int32_t &);
+static void         map_update_index   ();
+static bool         map_first          (const int32_t &);
+static int32_t      map_owner          ();
+static void         map_set            (const int32_t &, const iterate &);
+static void         map_append         (const iterate &);
+static int32_t      map_reclaim        ();
+static void         map_sort_hints     ();
+static void         record_to_iterate  (const map_record &, iterate &);
+static void         iterate_to_record  (const iterate &, map_record &);
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_the_flags' (rodes), 'main' (rodes_convert, rodes_coord)
+// Calls to : none
+// Returns true if 'file_name' starts with MAP_MAGIC.
+bool map_is_binary(const char *file_name)
+{
+  char magic[sizeof(MAP_MAGIC)];
+  int fd = open(file_name, O_RDONLY);
+
+  if ( fd < 0 )
+    return false;
+  bool result = ( read(fd, magic, sizeof(magic)) == (ssize_t) sizeof(magic) &&
+		  memcmp(magic, MAP_MAGIC, sizeof(magic)) == 0 );
+  close(fd);
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_the_flags' (rodes), 'map_read_it_List', 'map_write_it_List'
+// Calls to : 'lease_owner', 'map_remap', 'map_error'
+// The records hold the owner of a lease as a number ('map_owner'),
+// so [proc_nr] must be one, written as 'map_reclaim' writes it back.
+void map_open(const char *file_name)
+{
+  const std::string &owner = lease_owner();
+  if ( !owner.empty() )
+    {
+      std::ostringstream number;
+      long nr = atol(owner.c_str());
+      number << nr;
+      if ( number.str() != owner || nr < 0 ||
+	   nr >= std::numeric_limits<int32_t>::max() )
+	{
+	  cout << "Error: with the binary file " << file_name << ", [proc_nr]"
+	       << " must be a number (0, 1, 2,...), not '" << owner << "'." << endl;
+	  exit(1);
+	}
+    }
+
+  map_fd = open(file_name, O_RDWR);
+  if ( map_fd < 0 )
+    map_error(file_name);
+  map_index.clear();
+  map_indexed = 0;
+
+  map_remap();
+
+  map_header &h = header();
+  if ( memcmp(h.magic, MAP_MAGIC, sizeof(MAP_MAGIC)) != 0 ||
+       h.version != MAP_VERSION || h.record_size != (int32_t) sizeof(map_record) )
+    {
+      cout << "Error: " << file_name << " is not a binary shared file"
+	   << " of this version." << endl;
+      exit(1);
+    }
+  if ( h.c1 != MAP_C1 )
+    {
+      cout << "Error: " << file_name << " was written in "
+	   << (h.c1 ? "C0/C1" : "C0") << "-mode." << endl;
+      exit(1);
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'terminate_process' (rodes), 'map_read_it_List',
+//            'map_write_it_List'
+// Calls to : none
+void map_close()
+{
+  if ( map_base != NULL )
+    {
+      msync(map_base, map_size, MS_SYNC);
+      munmap(map_base, map_size);
+    }
+  if ( map_fd >= 0 )
+    close(map_fd);
+  map_base = NULL;
+  map_size = 0;
+  map_fd = -1;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_a_grid' (rodes)
+// Calls to : 'map_lock', 'map_update_index', 'map_first', 'map_set',
+//            'record_to_iterate', 'map_sort_hints', 'map_reclaim',
+//            'map_unlock'
+// The binary version of 'find_fresh_grids'. Takes (at most 'max')
+// hinted NOT_DONE slots, refilling the hints from the records if
+// needed. Only the hints are ordered by cost: the expensive grids
+// go first among the MAP_HINTS slots scanned at a time. Before we
+// wait for a grid, the grids of expired leases are given back. As
+// in 'take_fresh_grids', only the first record of a pair (u, v),
+// (-u, -v) is taken.
+find_result map_take_fresh_grids(List<iterate> &taken, const int &max)
+{
+  find_result result = NONE_LEFT;
+  bool reclaimed = false;
+  iterate it;
+
+  map_lock();
+  map_update_index();
+  map_header &h = header();
+  while ( Length(taken) < max )
+    {
+      while ( h.hint_next < h.hint_count && Length(taken) < max )
+	{
+	  int32_t slot = h.hint[h.hint_next++];
+	  if ( record(slot).c_stat == NOT_DONE && map_first(slot) ) // Else a stale hint.
+	    {
+	      record_to_iterate(record(slot), it);
+	      it.ndl.c_stat = BEING_DONE;
+	      map_set(slot, it);
+	      taken += it;
+	    }
+	}
+      if ( Length(taken) >= max )
+	break;
+      if ( h.scan_from >= h.count )
+	{
+	  if ( !IsEmpty(taken) || h.busy == 0 || reclaimed )
+	    break;
+	  reclaimed = true;
+	  if ( map_reclaim() == 0 )
+	    break;
+	  continue;
+	}
+
+      // Refill the hints, starting where the last scan stopped.
+      h.hint_next = h.hint_count = 0;
+      int32_t slot = h.scan_from;
+      while ( slot < h.count && h.hint_count < MAP_HINTS )
+	{
+	  if ( record(slot).c_stat == NOT_DONE && map_first(slot) )
+	    h.hint[h.hint_count++] = slot;
+	  slot++;
+	}
+      h.scan_from = slot;
+      map_sort_hints();
+    }
+  if ( !IsEmpty(taken) )
+    result = GOT_ONE;
+  else if ( h.busy > 0 )
+    result = WAITING_FOR_ONE;
+  map_unlock();
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'release_own_grids' (rodes)
+// Calls to : 'map_lock', 'map_owner', 'record_to_iterate', 'map_set',
+//            'map_unlock'
+// Gives back the grids an earlier run under our [proc_nr] left
+// leased to us, except those in 'resumed' (see 'own_leases').
+void map_release_own(List<grid> &resumed)
+{
+  grid_index keep;
+  iterate it;
+
+  if ( lease_owner().empty() )
+    return;
+  if ( !IsEmpty(resumed) )
+    for ( First(resumed); !Finished(resumed); Next(resumed) )
+      keep.set(Current(resumed), 1);
+
+  map_lock();
+  int32_t owner = map_owner();
+  for ( int32_t slot = 0; slot < header().count; slot++ )
+    {
+      const map_record &r = record(slot);
+      if ( r.owner != owner || (r.c_stat != BEING_DONE && r.c_stat != DO_AGAIN) )
+	continue;
+      record_to_iterate(r, it);
+      if ( keep.find(it.ndl.grd) >= 0 )
+	continue;
+      it.ndl.c_stat = NOT_DONE;
+      map_set(slot, it);
+      cout << "Released the grid " << it.ndl.grd
+	   << " of a lost process." << endl;
+    }
+  map_unlock();
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'insert_it_List' (rodes)
+// Calls to : 'map_lock', 'map_update_index', 'record_to_iterate', 'update',
+//            'map_set', 'child_iterates', 'widen_cone', 'map_append',
+//            'map_unlock'
+// The binary version of 'merge_it_List': the records already
+// present are updated in place; the remains of Add_List are
+// appended. Add_List is emptied. Just as in 'merge_it_List', a
+// pair of grids (u, v), (-u, -v) gets a single record, and an
+// image that hits a REFINED record is passed on to its children.
+void map_merge_it_List(List<iterate> &Add_List, const bool &external_input)
+{
+  iterate old_it, add_it;
+
+  map_lock();
+  map_update_index();
+
+  while ( !IsEmpty(Add_List) )
+    {
+      add_it = First(Add_List);
+      --Add_List;
+
+      int32_t slot = map_index.find(add_it.ndl.grd);
+      if ( slot >= 0 )
+	{
+	  /********************************************************/
+	  /*        HERE WE UPDATE THE STATUS OF 'old.it'         */
+	  /*                                                      */
+	  record_to_iterate(record(slot), old_it);
+	  update(old_it, add_it);
+	  map_set(slot, old_it);
+	  if ( old_it.ndl.c_stat == REFINED && add_it.ndl.c_stat == NOT_DONE )
+	    child_iterates(add_it, Add_List); // Merged in turn.
+	  /*                                                      */
+	  /********************************************************/
+	}
+      else
+	{
+	  if ( !external_input ) // Only widen cone openings if they
+	    widen_cone(add_it);  // come from internal computations.
+	  map_append(add_it);
+	  map_update_index();
+	}
+    }
+  map_unlock();
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main' (rodes_convert)
+// Calls to : 'map_open', 'record_to_iterate', 'map_close'
+// Appends all iterates stored in the binary file 'file_name' to it_List.
+void map_read_it_List(const char *file_name, List<iterate> &it_List)
+{
+  iterate it;
+
+  map_open(file_name);
+  map_lock();
+  for ( int32_t slot = 0; slot < header().count; slot++ )
+    {
+      record_to_iterate(record(slot), it);
+      it_List += it;
+    }
+  map_unlock();
+  map_close();
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main' (rodes_convert)
+// Calls to : 'map_open', 'map_append', 'map_close'
+// Overwrites the file 'file_name' with a binary file holding the
+// iterates of it_List (in the same order).
+void map_write_it_List(const char *file_name, List<iterate> &it_List)
+{
+  map_header h;
+
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, MAP_MAGIC, sizeof(MAP_MAGIC));
+  h.version = MAP_VERSION;
+  h.record_size = sizeof(map_record);
+  h.c1 = MAP_C1;
+
+  int fd = open(file_name, O_RDWR | O_CREAT | O_TRUNC, 0666);
+  if ( fd < 0 || write(fd, &h, sizeof(h)) != (ssize_t) sizeof(h) )
+    map_error(file_name);
+  close(fd);
+
+  map_open(file_name);
+  map_lock();
+  map_grow(Length(it_List));
+  First(it_List);
+  while( !Finished(it_List) )
+    {
+      map_append(Current(it_List));
+      Next(it_List);
+    }
+  map_unlock();
+  map_close();
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'map_open', 'map_write_it_List', 'map_remap', 'map_lock',
+//            'map_grow'
+// Calls to : 'exit(1)'
+static void map_error(const char *what)
+{
+  cout << "Error: share_map: " << what << ": " << strerror(errno) << endl;
+  exit(1);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// The size of a file with room for 'capacity' records.
+static size_t map_bytes(const int32_t &capacity)
+{
+  return sizeof(map_header) + (size_t) capacity * sizeof(map_record);
+}
+
+////////////////////////////////////////////////////////////////////
+
+static map_header & header()
+{
+  return *(map_header *) map_base;
+}
+
+////////////////////////////////////////////////////////////////////
+
+static map_record & record(const int32_t &slot)
+{
+  return ((map_record *) (map_base + sizeof(map_header)))[slot];
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'map_open', 'map_lock', 'map_grow'
+// Calls to : 'map_error'
+// Maps all of the file. Another process may have grown it since
+// we last looked, in which case we map it anew.
+static void map_remap()
+{
+  struct stat st;
+
+  if ( fstat(map_fd, &st) != 0 )
+    map_error("fstat");
+  if ( (size_t) st.st_size < sizeof(map_header) )
+    {
+      errno = EINVAL;
+      map_error("truncated file");
+    }
+  if ( (size_t) st.st_size == map_size )
+    return;
+
+  if ( map_base != NULL )
+    munmap(map_base, map_size);
+  map_size = st.st_size;
+  map_base = (char *) mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+			   MAP_SHARED, map_fd, 0);
+  if ( map_base == (char *) MAP_FAILED )
+    {
+      map_base = NULL;
+      map_error("mmap");
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: all functions reading or changing the records.
+// Calls to : 'map_remap', 'map_error'
+// Locks out the other threads (mutex) and processes (fcntl).
+static void map_lock()
+{
+  struct flock fl;
+
+  pthread_mutex_lock(&map_mutex);
+
+  memset(&fl, 0, sizeof(fl));
+  fl.l_type   = F_WRLCK;
+  fl.l_whence = SEEK_SET;
+  fl.l_start  = 0;
+  fl.l_len    = sizeof(map_header);
+  while ( fcntl(map_fd, F_SETLKW, &fl) != 0 )
+    if ( errno != EINTR )
+      map_error("fcntl");
+
+  map_remap();
+}
+
+////////////////////////////////////////////////////////////////////
+
+static void map_unlock()
+{
+  struct flock fl;
+
+  memset(&fl, 0, sizeof(fl));
+  fl.l_type   = F_UNLCK;
+  fl.l_whence = SEEK_SET;
+  fl.l_start  = 0;
+  fl.l_len    = sizeof(map_header);
+  fcntl(map_fd, F_SETLK, &fl);
+
+  pthread_mutex_unlock(&map_mutex);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'map_append', 'map_write_it_List'
+// Calls to : 'map_error', 'map_remap'
+// Makes room for 'more' records beyond header().count.
+static void map_grow(const int32_t &more)
+{
+  map_header &h = header();
+  if ( h.count + more <= h.capacity )
+    return;
+
+  int32_t capacity = 2 * h.capacity;
+  if ( capacity < h.count + more )
+    capacity = h.count + more;
+  if ( capacity < h.capacity + MAP_MIN_GROWTH )
+    capacity = h.capacity + MAP_MIN_GROWTH;
+
+  if ( ftruncate(map_fd, map_bytes(capacity)) != 0 )
+    map_error("ftruncate");
+  map_remap();
+  header().capacity = capacity;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'map_set', 'map_append'
+// Calls to : none
+// Remembers that 'slot' has become NOT_DONE. If there is no room
+// among the hints, the next scan must start at 'slot'.
+static void map_hint(const int32_t &slot)
+{
+  map_header &h = header();
+
+  if ( h.hint_count == MAP_HINTS && h.hint_next > 0 )
+    { // Drop the used hints.
+      memmove(h.hint, h.hint + h.hint_next,
+	      (h.hint_count - h.hint_next) * sizeof(int32_t));
+      h.hint_count -= h.hint_next;
+      h.hint_next = 0;
+    }
+  if ( h.hint_count < MAP_HINTS )
+    h.hint[h.hint_count++] = slot;
+  else if ( slot < h.scan_from )
+    h.scan_from = slot;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'map_merge_it_List', 'map_take_fresh_grids'
+// Calls to : none
+// Adds the records appended since we last looked to 'map_index'.
+static void map_update_index()
+{
+  for ( ; map_indexed < header().count; map_indexed++ )
+    {
+      const map_record &r = record(map_indexed);
+      grid g = {r.u, r.v, r.P};
+      map_index.insert(g, map_indexed);
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'map_take_fresh_grids'
+// Calls to : none
+// Is 'slot' the first record of its pair of grids? (The other one
+// is only there in files written before the pairs were merged.)
+static bool map_first(const int32_t &slot)
+{
+  const map_record &r = record(slot);
+  grid g = {r.u, r.v, r.P};
+  return ( map_index.find(g) == slot );
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'map_set', 'map_release_own'
+// Calls to : 'lease_owner'
+// Our 'owner' in the records; 0 if we hold no leases. ('map_open'
+// has checked that [proc_nr] is a number.)
+static int32_t map_owner()
+{
+  return lease_owner().empty() ? 0 : atoi(lease_owner().c_str()) + 1;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'map_take_fresh_grids', 'map_merge_it_List', 'map_reclaim',
+//            'map_release_own'
+// Calls to : 'iterate_to_record', 'map_owner', 'map_hint'
+// Overwrites the record in 'slot', keeping the header up to date.
+// A grid we take is leased to us; the lease ends with the grid
+// being done (or given back).
+static void map_set(const int32_t &slot, const iterate &it)
+{
+  map_header &h = header();
+  map_record &r = record(slot);
+  int32_t old_stat = r.c_stat;
+  int32_t owner = r.owner;
+
+  iterate_to_record(it, r);
+  if ( r.c_stat == BEING_DONE && old_stat == NOT_DONE )
+    r.owner = map_owner();
+  else if ( r.c_stat == BEING_DONE || r.c_stat == DO_AGAIN )
+    r.owner = owner;
+  if ( old_stat == BEING_DONE )
+    h.busy--;
+  if ( r.c_stat == BEING_DONE )
+    h.busy++;
+  if ( r.c_stat == NOT_DONE && old_stat != NOT_DONE )
+    map_hint(slot);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'map_merge_it_List', 'map_write_it_List'
+// Calls to : 'map_grow', 'iterate_to_record', 'map_hint'
+static void map_append(const iterate &it)
+{
+  map_grow(1);
+
+  map_header &h = header();
+  int32_t slot = h.count++;
+  map_record &r = record(slot);
+
+  iterate_to_record(it, r);
+  if ( r.c_stat == BEING_DONE )
+    h.busy++;
+  if ( r.c_stat == NOT_DONE )
+    map_hint(slot);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'map_take_fresh_grids'
+// Calls to : 'lease_expired', 'map_set', 'record_to_iterate'
+// Gives back the grids leased to processes whose lease has expired.
+// Returns the number of grids given back.
+static int32_t map_reclaim()
+{
+  std::map<int32_t, bool> expired; // To look at each owner only once.
+  int32_t count = 0;
+  iterate it;
+
+  for ( int32_t slot = 0; slot < header().count; slot++ )
+    {
+      const map_record &r = record(slot);
+      if ( r.owner == 0 || (r.c_stat != BEING_DONE && r.c_stat != DO_AGAIN) )
+	continue;
+      if ( expired.find(r.owner) == expired.end() )
+	{
+	  std::ostringstream owner;
+	  owner << r.owner - 1;
+	  expired[r.owner] = lease_expired(owner.str());
+	}
+      if ( expired[r.owner] )
+	{
+	  record_to_iterate(r, it);
+	  it.ndl.c_stat = NOT_DONE;
+	  map_set(slot, it);
+	  count++;
+	  cout << "Released the grid " << it.ndl.grd
+	       << " of a lost process." << endl;
+	}
+    }
+  return count;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'map_take_fresh_grids'
+// Calls to : 'cost_of_zones', 'Get_Grid_Zone'
+// Orders the hints just scanned by decreasing cost (see 'cost.h'),
+// keeping the order of the slots for equal costs.
+static void map_sort_hints()
+{
+  map_header &h = header();
+  double cost[ZONES + 1];
+  std::vector<std::pair<double, int32_t> > hints(h.hint_count);
+
+  cost_of_zones(cost);
+  for ( int32_t i = 0; i < h.hint_count; i++ )
+    {
+      const map_record &r = record(h.hint[i]);
+      grid g = {r.u, r.v, r.P};
+      hints[i].first  = - cost[Get_Grid_Zone(g)];
+      hints[i].second = h.hint[i];
+    }
+  std::sort(hints.begin(), hints.end()); // By (-cost, slot).
+  for ( int32_t i = 0; i < h.hint_count; i++ )
+    h.hint[i] = hints[i].second;
+}
+
+////////////////////////////////////////////////////////////////////
+
+static void record_to_iterate(const map_record &r, iterate &it)
+{
+  it.ndl.grd.u  = r.u;
+  it.ndl.grd.v  = r.v;
+  it.ndl.grd.P  = r.P;
+  it.ndl.c_stat = r.c_stat;
+  it.ndl.h_stat = r.h_stat;
+#ifdef COMPUTE_C1
+  it.ndl.ang     = Hull(r.ang_lo, r.ang_hi);
+  it.ndl.pre_exp = r.pre_exp;
+  it.ndl.min_exp = r.min_exp;
+#endif
+  it.inf_grd.u = r.inf_u;
+  it.inf_grd.v = r.inf_v;
+  it.inf_grd.P = r.inf_P;
+  it.sup_grd.u = r.sup_u;
+  it.sup_grd.v = r.sup_v;
+  it.sup_grd.P = r.sup_P;
+}
+
+////////////////////////////////////////////////////////////////////
+
+static void iterate_to_record(const iterate &it, map_record &r)
+{
+  memset(&r, 0, sizeof(r));
+  r.u      = it.ndl.grd.u;
+  r.v      = it.ndl.grd.v;
+  r.P      = it.ndl.grd.P;
+  r.c_stat = it.ndl.c_stat;
+  r.h_stat = it.ndl.h_stat;
+#ifdef COMPUTE_C1
+  r.ang_lo  = Inf(it.ndl.ang);
+  r.ang_hi  = Sup(it.ndl.ang);
+  r.pre_exp = it.ndl.pre_exp;
+  r.min_exp = it.ndl.min_exp;
+#endif
+  r.inf_u = it.inf_grd.u;
+  r.inf_v = it.inf_grd.v;
+  r.inf_P = it.inf_grd.P;
+  r.sup_u = it.sup_grd.u;
+  r.sup_v = it.sup_grd.v;
+  r.sup_P = it.sup_grd.P;
+}
+
+////////////////////////////////////////////////////////////////////
@@ -0,0 +1,99 @@
+/*   File: share_map.h
+
+     The binary version of the shared file. The iterates
+     are stored as fixed-size records, and the file is
+     mmap'ed by every process using it. Claiming a grid,
+     or inserting the images of a grid, then only touches
+     the records concerned, instead of reading and
+     rewriting the whole file (as 'find_fresh_grid' and
+     'insert_it_List' do for the text file).
+
+     The file starts with a 'map_header', holding a small
+     index ('hint') of slots known to be NOT_DONE. When it
+     runs out, it is refilled by scanning the records from
+     'scan_from' on. All changes are made in place, while
+     holding an fcntl write lock on the header bytes.
+
+     A record being done holds its owner, so that the
+     grids of a killed process are given back when its
+     lease expires (see 'lease.h').
+
+     A text file is converted to and from the binary
+     format by 'rodes_convert'.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#ifndef SHARE_MAP_H
+#define SHARE_MAP_H
+
+#include <stdint.h>
+
+#include "2d_classes.h"
+#include "list.h"
+#include "share_table.h"
+
+////////////////////////////////////////////////////////////////////
+
+// The first bytes of every binary shared file.
+static const char MAP_MAGIC[8] = {'R', 'O', 'D', 'E', 'S', 'M', 'A', 'P'};
+
+const int32_t MAP_VERSION = 1;
+
+// The number of NOT_DONE slots remembered in the header.
+const int32_t MAP_HINTS = 1024;
+
+// The file grows by at least this many records at a time.
+const int32_t MAP_MIN_GROWTH = 4096;
+
+////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+  char    magic[8];
+  int32_t version;
+  int32_t record_size;      // sizeof(map_record), to catch foreign files.
+  int32_t c1;               // 1 if written in C0/C1-mode.
+  int32_t count;            // Records in use.
+  int32_t capacity;         // Records the file has room for.
+  int32_t busy;             // Records with c_stat == BEING_DONE.
+  int32_t scan_from;        // No unhinted NOT_DONE record before this slot.
+  int32_t hint_next;        // hint[hint_next],...,hint[hint_count - 1]
+  int32_t hint_count;       // are (probably) NOT_DONE.
+  int32_t unused;
+  int32_t hint[MAP_HINTS];
+} map_header;
+
+typedef struct
+{
+  double  ang_lo, ang_hi;   // Cone angles (radians), C0/C1-mode only.
+  double  pre_exp, min_exp; // C0/C1-mode only.
+  int32_t u, v, P;
+  int32_t c_stat, h_stat;
+  int32_t inf_u, inf_v, inf_P;
+  int32_t sup_u, sup_v, sup_P;
+  int32_t owner;            // [proc_nr] + 1 of the leaseholder; 0 if none.
+                            // (So [proc_nr] must be a number.)
+} map_record;
+
+////////////////////////////////////////////////////////////////////
+
+bool        map_is_binary        (const char *);
+
+void        map_open             (const char *);
+
+void        map_close            ();
+
+find_result map_take_fresh_grids (List<iterate> &, const int &);
+
+void        map_release_own      (List<grid> &);
+
+void        map_merge_it_List    (List<iterate> &, const bool &);
+
+void        map_read_it_List     (const char *, List<iterate> &);
+
+void        map_write_it_List    (const char *, List<iterate> &);
+
+////////////////////////////////////////////////////////////////////
+
+#endif // SHARE_MAP_H
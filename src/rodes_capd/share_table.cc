@@ -0,0 +1,318 @@
+/*   File: share_table.cc
+
+     The in-memory operations on the table of
+     iterates kept in the shared file. Moved out
+     of 'rodes.cc' so that the coordinator can
+     apply exactly the same rules.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <vector>
+
+#include "cost.h"
+#include "grid_hash.h"
+#include "share_table.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'find_fresh_grid', 'insert_it_List' (rodes), 'main' (rodes_coord)
+// Calls to : none
+// Appends all iterates stored in the file 'file_name' to it_List.
+void read_it_List(const char *file_name, List<iterate> &it_List)
+{
+  iterate temp_it;
+  std::ifstream InFile(file_name, ios::in);
+
+  while ( InFile >> temp_it )
+    it_List += temp_it;
+  InFile.close();
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'find_fresh_grid', 'insert_it_List' (rodes), 'main' (rodes_coord)
+// Calls to : none
+// Overwrites the file 'file_name' with the iterates of it_List.
+void write_it_List(const char *file_name, List<iterate> &it_List)
+{
+  std::ofstream OutFile(file_name, ios::out);
+
+  First(it_List);
+  while( !Finished(it_List) )
+    {
+      OutFile << Current(it_List) << endl;
+      Next(it_List);
+    }
+  OutFile.close();
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'serve_get' (rodes_coord), 'get_a_table_grid' (rodes),
+//            'journal_take_fresh_grids'
+// Calls to : 'take_fresh_grids'
+// Marks the most expensive NOT_DONE iterate of Table as BEING_DONE,
+// and returns a copy of it via 'it'.
+find_result take_fresh_grid(List<iterate> &Table, iterate &it)
+{
+  List<iterate> taken;
+  find_result result = take_fresh_grids(Table, taken, 1);
+
+  if ( result == GOT_ONE )
+    it = First(taken);
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'take_fresh_grid', 'find_fresh_grids' (rodes)
+// Calls to : 'cost_of_zones', 'Get_Grid_Zone'
+// Marks the (at most) 'max' most expensive NOT_DONE iterates of
+// Table as BEING_DONE, and appends copies of them to 'taken', the
+// most expensive first. Iterates of equal cost are taken in the
+// order of Table.
+//
+// Only the first iterate of a pair (u, v), (-u, -v) is ever taken:
+// 'merge_it_List' updates no other. (A table written before the
+// pairs were merged may still hold both.)
+find_result take_fresh_grids(List<iterate> &Table, List<iterate> &taken,
+			     const int &max)
+{
+  find_result result = NONE_LEFT;
+  double cost[ZONES + 1];
+  std::vector<double>    best_cost;  // The most expensive so far,
+  std::vector<iterate *> best;       // in decreasing order of cost.
+  grid_index             seen;       // The grids before Current(Table).
+
+  if ( IsEmpty(Table) || max <= 0 )
+    return NONE_LEFT;
+  cost_of_zones(cost);
+  First(Table);
+  while ( !Finished(Table) )
+    {
+      iterate &temp_it = Current(Table);
+      if ( !seen.insert(temp_it.ndl.grd, 1) )
+	{ /* The other grid of the pair is before it. */ }
+      else if ( temp_it.ndl.c_stat == NOT_DONE )
+	{
+	  double c = cost[Get_Grid_Zone(temp_it.ndl.grd)];
+	  if ( (int) best.size() < max || c > best_cost.back() )
+	    {
+	      int i = best.size();
+	      while ( i > 0 && best_cost[i - 1] < c )
+		i--;
+	      best_cost.insert(best_cost.begin() + i, c);
+	      best.insert(best.begin() + i, &temp_it);
+	      if ( (int) best.size() > max )
+		{
+		  best_cost.pop_back();
+		  best.pop_back();
+		}
+	    }
+	}
+      else if ( temp_it.ndl.c_stat == BEING_DONE )
+	result = WAITING_FOR_ONE;
+      Next(Table);
+    }
+
+  for ( unsigned i = 0; i < best.size(); i++ )
+    {
+      best[i]->ndl.c_stat = BEING_DONE;
+      taken += *best[i];
+    }
+  return ( best.empty() ? result : GOT_ONE );
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'insert_it_List' (rodes), 'serve_request' (rodes_coord),
+//            'merge_it_List'
+// Calls to : 'update', 'widen_cone', 'child_iterates', 'merge_it_List'
+// Merges Add_List into Table. Iterates already present in Table
+// are updated in place; the remains of Add_List are appended.
+// Add_List is emptied.
+//
+// The iterates of Add_List are hashed on their grids, so that
+// each iterate of Table is looked up once. The result is the same
+// as comparing all pairs: each grid of Add_List updates the first
+// matching iterate of Table, in the order given by Add_List. Of
+// the grids not in Table, one iterate per pair (u, v), (-u, -v)
+// is appended, updated by the others in the order of Add_List.
+//
+// An image that hits a REFINED iterate is passed on to its four
+// grids of P + 1, which are merged in turn.
+void merge_it_List(List<iterate> &Table, List<iterate> &Add_List,
+		   const bool &external_input)
+{
+  std::vector<iterate> add(Length(Add_List));
+  std::vector<int>     next(add.size(), -1); // Same grid, later in Add_List.
+  std::vector<bool>    merged(add.size(), false);
+  grid_index           first;                // Grid -> first in Add_List.
+  List<iterate>        Refined_List;         // Passed on to P + 1.
+
+  for ( int i = 0; !IsEmpty(Add_List); i++ )
+    {
+      add[i] = First(Add_List);
+      --Add_List;
+    }
+  for ( int i = add.size() - 1; i >= 0; i-- )
+    {
+      next[i] = first.find(add[i].ndl.grd);
+      first.set(add[i].ndl.grd, i);
+    }
+
+  int left = add.size();
+  if ( !IsEmpty(Table) )
+    First(Table);
+  while( !Finished(Table) && left > 0 )
+    {
+      iterate &old_it = Current(Table);
+      int i = first.find(old_it.ndl.grd);
+      if ( i >= 0 )
+	{
+	  first.set(old_it.ndl.grd, -1); // Only the first match counts.
+	  for ( ; i >= 0; i = next[i] )
+	    {
+	      /********************************************************/
+	      /*        HERE WE UPDATE THE STATUS OF 'old.it'         */
+	      /*                                                      */
+	      update(old_it, add[i]);
+	      /*                                                      */
+	      /*                                                      */
+	      /********************************************************/
+	      if ( old_it.ndl.c_stat == REFINED && add[i].ndl.c_stat == NOT_DONE )
+		child_iterates(add[i], Refined_List);
+	      merged[i] = true;
+	      left--;
+	    }
+	}
+      Next(Table);
+    }
+
+  for ( unsigned i = 0; i < add.size(); i++ )
+    if ( !merged[i] )
+      { // Append the remains of Add_List to Table.
+	if ( !external_input ) // Only widen cone openings if they
+	  widen_cone(add[i]);  // come from internal computations.
+	for ( int j = next[i]; j >= 0; j = next[j] )
+	  { // The same grid, or the other one of the pair.
+	    update(add[i], add[j]);
+	    merged[j] = true;
+	  }
+	Table += add[i];
+      }
+
+  if ( !IsEmpty(Refined_List) )
+    merge_it_List(Table, Refined_List, external_input);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'merge_it_List', 'map_merge_it_List'
+// Calls to : none
+void widen_cone(iterate &it)
+{
+  /********************************************************/
+  /*    Widen the cone opening to minimize the risk of    */
+  /*    having to recompute due to cone leakage.          */
+  /*                                                      */
+#ifdef COMPUTE_C1
+  it.ndl.ang = Rescale(it.ndl.ang, ANG_FACTOR);
+  if ( diam(it.ndl.ang) < MIN_CONE_OPENING )
+    {
+      double mid = Mid(it.ndl.ang);
+      it.ndl.ang = mid + SymHull(MIN_CONE_OPENING / 2.0);
+    }
+#endif
+  /*   Now the cone opening is at least MIN_CONE_OPENING. */
+  /*                                                      */
+  /********************************************************/
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'merge_it_List', 'map_merge_it_List'
+// Calls to : none
+void update(iterate &old_it, const iterate &new_it)
+{
+  iterate result = old_it;
+
+  if ( new_it.ndl.c_stat == NOT_DONE ) // 'new_it' is an image...
+    { // 'new_it' is not the source it.
+      result.ndl.h_stat = new_it.ndl.h_stat;// ...and so it is HIT.
+#ifdef COMPUTE_C1
+      // 'old_it' has already been updated, or is now
+      // under computation by a different process.
+      result.ndl.pre_exp = Min(old_it.ndl.pre_exp, new_it.ndl.pre_exp);
+      if ( Subset(new_it.ndl.ang, old_it.ndl.ang) )
+	{ /* No need to widen the cone */ }
+      else
+	{ // We have to recompute with a wider cone.
+	  interval dummy;
+	  if ( Intersection(dummy, new_it.ndl.ang, old_it.ndl.ang) )
+	    { // Double the angular differences.
+	      double upper_ang_diff = Sup(new_it.ndl.ang) - Sup(old_it.ndl.ang);
+	      if ( upper_ang_diff < 0.0 )
+		upper_ang_diff = 0.0;
+	      double lower_ang_diff = Inf(new_it.ndl.ang) - Inf(old_it.ndl.ang);
+	      if ( lower_ang_diff > 0.0 )
+		lower_ang_diff = 0.0;
+	      result.ndl.ang = old_it.ndl.ang +
+		ANG_FACTOR * Hull(lower_ang_diff, upper_ang_diff);
+	    }
+	  else // The cones don't even intersect.
+	    result.ndl.ang = Rescale(Hull(new_it.ndl.ang, old_it.ndl.ang), ANG_FACTOR);
+	  if ( old_it.ndl.c_stat == BEING_DONE )
+	    result.ndl.c_stat = DO_AGAIN;
+	  if ( old_it.ndl.c_stat == DONE )
+	    result.ndl.c_stat = NOT_DONE;
+	  // We do not alter c_stat == FAILED, RESERVED or REFINED
+	  // (the cone of REFINED is passed on by 'merge_it_List').
+	}
+#endif // COMPUTE_C1
+    }
+  else // 'new_it' is the source, i.e., 'old_it' is
+    {  // now under computation by this process.
+      if ( old_it.ndl.c_stat == DO_AGAIN ) // The cone has been widened
+	{                                  // during this computation.
+	  result.ndl.c_stat = NOT_DONE;    // Only this process may release
+	}                                  // the 'it' for re-computation.
+      else // An uninterrupted computation.
+	{
+	  result.ndl.c_stat = new_it.ndl.c_stat; // DONE, FAILED, RESERVED
+	                                         // or REFINED.
+	  result.inf_grd = new_it.inf_grd;       // Save the hull of
+	  result.sup_grd = new_it.sup_grd;       // the images.
+#ifdef COMPUTE_C1
+	  result.ndl.min_exp = new_it.ndl.min_exp; // Save the minimal expansion.
+#endif // COMPUTE_C1
+	}
+    }
+  old_it = result; // Pass the result by reference.
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'merge_it_List', 'map_merge_it_List', 'work_on_grid' (rodes)
+// Calls to : 'grid_children'
+// Appends copies of 'it' on the four grids of P + 1 within its grid
+// (its children, see '--refine' in 'rodes') to it_List.
+void child_iterates(const iterate &it, List<iterate> &it_List)
+{
+  grid child[4];
+  iterate temp_it = it;
+
+  temp_it.inf_grd = NULL_GRID;
+  temp_it.sup_grd = NULL_GRID;
+  grid_children(it.ndl.grd, child);
+  for ( int i = 0; i < 4; i++ )
+    {
+      temp_it.ndl.grd = child[i];
+      it_List += temp_it;
+    }
+}
+
+////////////////////////////////////////////////////////////////////
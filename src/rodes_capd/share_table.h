@@ -0,0 +1,52 @@
+/*   File: share_table.h
+
+     The in-memory operations on the table of
+     iterates kept in the shared file. Used by
+     'rodes' (through the shared file) and by
+     the coordinator 'rodes_coord' (in memory).
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#ifndef SHARE_TABLE_H
+#define SHARE_TABLE_H
+
+#include <iostream>
+#include <fstream>
+
+#include "2d_classes.h"
+#include "classes.h"
+#include "list.h"
+
+////////////////////////////////////////////////////////////////////
+
+// The factor by which we widen the cone openings.
+const double ANG_FACTOR = 1.5;
+
+// The minimal cone opening allowed.
+const double MIN_CONE_OPENING = 5.0 * Sup(DEG_TO_RAD);
+
+// Enumerations used for search for grid.
+enum find_result {NONE_LEFT, WAITING_FOR_ONE, GOT_ONE};
+
+////////////////////////////////////////////////////////////////////
+
+void        read_it_List    (const char *, List<iterate> &);
+
+void        write_it_List   (const char *, List<iterate> &);
+
+find_result take_fresh_grid (List<iterate> &, iterate &);
+
+find_result take_fresh_grids(List<iterate> &, List<iterate> &, const int &);
+
+void        merge_it_List   (List<iterate> &, List<iterate> &, const bool &);
+
+void        update          (iterate &, const iterate &);
+
+void        widen_cone      (iterate &);
+
+void        child_iterates  (const iterate &, List<iterate> &);
+
+////////////////////////////////////////////////////////////////////
+
+#endif // SHARE_TABLE_H
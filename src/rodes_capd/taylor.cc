@@ -0,0 +1,460 @@
+/*   File: taylor.cc
+
+     A step of the integrator by Taylor series.
+     See 'taylor.h'.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include "taylor.h"
+#include "vector_field.h"
+#include "workspace.h"
+#include "trace.h"
+
+////////////////////////////////////////////////////////////////////
+
+// Set by 'Set_Taylor_Order': 0 for the corner method.
+static int taylor_order = 0;
+
+////////////////////////////////////////////////////////////////////
+
+// A value, and its partial derivatives with respect
+// to the starting point of the step.
+class jet
+{
+ public:
+  jet() : v(0.0) { clear(); }
+  jet(const interval &value) : v(value) { clear(); }
+
+  interval v;
+  interval d[SYSDIM];
+
+ private:
+  void clear() { for ( short j = 0; j < SYSDIM; j++ ) d[j] = 0.0; }
+};
+
+inline jet operator + (const jet &a, const jet &b)
+{
+  jet r(a.v + b.v);
+  for ( short j = 0; j < SYSDIM; j++ )
+    r.d[j] = a.d[j] + b.d[j];
+  return r;
+}
+
+inline jet operator - (const jet &a, const jet &b)
+{
+  jet r(a.v - b.v);
+  for ( short j = 0; j < SYSDIM; j++ )
+    r.d[j] = a.d[j] - b.d[j];
+  return r;
+}
+
+inline jet operator * (const jet &a, const jet &b)
+{
+  jet r(a.v * b.v);
+  for ( short j = 0; j < SYSDIM; j++ )
+    r.d[j] = a.d[j] * b.v + a.v * b.d[j];
+  return r;
+}
+
+inline jet operator * (const interval &c, const jet &a)
+{
+  jet r(c * a.v);
+  for ( short j = 0; j < SYSDIM; j++ )
+    r.d[j] = c * a.d[j];
+  return r;
+}
+
+inline jet operator * (const jet &a, const interval &c)
+{
+  return c * a;
+}
+
+inline interval Inverse(const interval &a)
+{
+  return 1.0 / a;
+}
+
+inline jet Inverse(const jet &a)
+{
+  jet r(1.0 / a.v);
+  interval dr = - r.v * r.v;
+  for ( short j = 0; j < SYSDIM; j++ )
+    r.d[j] = dr * a.d[j];
+  return r;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// The coefficients of the step: x[i][k] is that of s^k in
+// x_(i+1), and t[k] that of s^k in the time (t[0] = 0).
+template <class T>
+class taylor_series
+{
+ public:
+  T x[SYSDIM][TAYLOR_MAX_ORDER + 1];
+  T t[TAYLOR_MAX_ORDER + 1];
+};
+
+////////////////////////////////////////////////////////////////////
+
+static bool     A_Priori          (BOX &, double &, interval &,
+				   const parcel &, const double &);
+static bool     Variational_Bound (IMatrix &, const BOX &, const parcel &,
+				   const interval &);
+static double   Mag               (const interval &);
+static interval Meet              (const interval &, const interval &);
+
+template <class T>
+static void     Coefficients      (taylor_series<T> &, const short &,
+				   const short &, const int &);
+template <class T>
+static T        Series_Sum        (const T *, const int &, const interval &,
+				   const T &);
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_the_options' (rodes)
+// Calls to : none
+// The order of the series; 0 for the corner method.
+void Set_Taylor_Order(const int &order)
+{
+  taylor_order = ( order < 0 ? 0 : order );
+  if ( taylor_order > TAYLOR_MAX_ORDER )
+    {
+      cout << "Warning: the order of the Taylor series is at most "
+	   << TAYLOR_MAX_ORDER << "." << endl;
+      taylor_order = TAYLOR_MAX_ORDER;
+    }
+}
+
+// Called by: 'Flow' (return_map)
+// Calls to : none
+int Taylor_Order()
+{
+  return taylor_order;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by 'Flow' (return_map).
+// Flows pcl.box by 'trvl_dist' in the transversal direction, or, if
+// we cannot enclose that, by half as far, and so on TAYLOR_HALVINGS
+// times. Returns (by reference) the image Result_Box, the time it
+// took, the derivatives DPi of the step (as 'Get_DPi_Matrix'), and
+// how far it went. Returns false if we could not make the step at
+// all; 'Flow' then uses the corner method. Given a point 'center' of
+// pcl.box (for 'Lohner_Step'), its image goes to 'center_image';
+// otherwise the center of the box is used.
+bool Taylor_Step(BOX &Result_Box, interval &time, IMatrix &DPi,
+		 double &achieved, const parcel &pcl, const double &trvl_dist,
+		 const BOX *center, BOX *center_image)
+{
+  const short tr = pcl.trvl - 1;
+  const int   n  = taylor_order;
+  BOX      W(SYSDIM);          // The a priori enclosure of the step,
+  IMatrix  E(SYSDIM, SYSDIM);  // and of its derivatives.
+  interval h;                  // The length of the step.
+  double   new_level;          // The plane it goes to.
+  short    i, j;
+
+  achieved = trvl_dist;
+  for ( short halvings = 0;
+	!A_Priori(W, new_level, h, pcl, achieved) ||
+	  !Variational_Bound(E, W, pcl, h);
+	halvings++ )
+    {
+      if ( halvings == TAYLOR_HALVINGS )
+	return false;
+      achieved /= 2.0;
+    }
+  if ( achieved < trvl_dist )
+    Thread_Workspace().stats.clipped_steps++;
+  TRACE(2, TRACE_OUTER_BOX, pcl, W, achieved, n);
+
+  // The remainders: the coefficients of order n over W, with
+  // the derivatives (by the chain rule) over E.
+  taylor_series<jet> over;
+  for ( i = 0; i < SYSDIM; i++ )
+    {
+      over.x[i][0] = jet(W[i]);
+      if ( i != tr )
+	for ( j = 0; j < SYSDIM; j++ )
+	  over.x[i][0].d[j] = E(i + 1, j + 1);
+    }
+  Coefficients(over, pcl.trvl, pcl.sign, n);
+
+  // The step of the whole box, with its derivatives. Its series
+  // may be far wider than the a priori enclosures W and E (which
+  // hold over the whole step), so we take it within them.
+  taylor_series<jet> whole;
+  BOX whole_image(SYSDIM);
+  for ( i = 0; i < SYSDIM; i++ )
+    {
+      whole.x[i][0] = jet(pcl.box[i]);
+      if ( i != tr )
+	whole.x[i][0].d[i] = 1.0;
+    }
+  Coefficients(whole, pcl.trvl, pcl.sign, n);
+  for ( i = 0; i < SYSDIM; i++ )
+    {
+      jet image = Series_Sum(whole.x[i], n, h, over.x[i][n]);
+      whole_image[i] = ( i == tr ? image.v : Meet(image.v, W[i]) );
+      for ( j = 0; j < SYSDIM; j++ )
+	DPi(i + 1, j + 1) = ( i == tr || j == tr ? interval(0.0) :
+			      Meet(image.d[j], E(i + 1, j + 1)) );
+    }
+  time = Meet(Series_Sum(whole.t, n, h, over.t[n]).v,
+	      h * (interval((double) pcl.sign) / Vf_Range(W, pcl.trvl)));
+
+  // The steps of the corners and of the center of the box.
+  taylor_series<interval> point;
+  BOX corner_image[CORNERS + 1];
+  for ( int c = 0; c <= CORNERS; c++ )
+    {
+      short bit = 0;
+      for ( i = 0; i < SYSDIM; i++ )
+	if ( i == tr )
+	  point.x[i][0] = pcl.box[i];
+	else if ( c == CORNERS )
+	  point.x[i][0] = ( center != NULL ? (*center)[i] : interval(Mid(pcl.box[i])) );
+	else
+	  point.x[i][0] = ( (c >> bit++) & 1 ? Sup(pcl.box[i]) : Inf(pcl.box[i]) );
+      Coefficients(point, pcl.trvl, pcl.sign, n);
+
+      corner_image[c] = BOX(SYSDIM);
+      for ( i = 0; i < SYSDIM; i++ )
+	if ( i != tr )
+	  corner_image[c][i] = Series_Sum(point.x[i], n, h, over.x[i][n].v);
+    }
+  const BOX &mid_image = corner_image[CORNERS];
+
+  // Where no derivative vanishes, the image is the hull of those of
+  // the corners, elsewhere we use the mean value form.
+  for ( i = 0; i < SYSDIM; i++ )
+    {
+      if ( i == tr )
+	{
+	  Result_Box[i] = interval(new_level);
+	  continue;
+	}
+      bool monotone = true;
+      for ( j = 0; j < SYSDIM; j++ )
+	if ( j != tr && Subset(0.0, DPi(i + 1, j + 1)) )
+	  monotone = false;
+
+      interval image;
+      if ( monotone )
+	{
+	  image = corner_image[0][i];
+	  for ( int c = 1; c < CORNERS; c++ )
+	    image = intervalHull(image, corner_image[c][i]);
+	}
+      else
+	{
+	  image = mid_image[i];
+	  for ( j = 0; j < SYSDIM; j++ )
+	    if ( j != tr )
+	      image += DPi(i + 1, j + 1) * (pcl.box[j] - point.x[j][0]);
+	}
+      Result_Box[i] = Meet(image, whole_image[i]);
+    }
+  if ( center_image != NULL )
+    {
+      *center_image = mid_image;
+      (*center_image)[tr] = Result_Box[tr];
+    }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by 'Taylor_Step'.
+// Finds W, which contains the flow of pcl.box from its plane to the
+// one at 'dist' from it (at 'new_level', rounded outward); 'h' is the
+// length of the step. With g_i = sign * f_i / f_trvl, W is found when
+//   pcl.box + [0, h] * g(W) \subset W,
+// which we try TAYLOR_TRIES times. Returns false if it is not found,
+// or if the flow is not transversal to the planes in W.
+static bool A_Priori(BOX &W, double &new_level, interval &h,
+		     const parcel &pcl, const double &dist)
+{
+  const short    tr    = pcl.trvl - 1;
+  const double   level = Inf(pcl.box[tr]);  // Inf == Sup.
+  const interval sign((double) pcl.sign);
+  BOX vf(SYSDIM), next(SYSDIM);
+
+  if ( pcl.sign == 1 )
+    new_level = Sup(AddBounds(level, dist));
+  else
+    new_level = Inf(SubBounds(level, dist));
+  h = sign * (interval(new_level) - interval(level));
+  interval s = Hull(0.0, Sup(h));
+
+  W = pcl.box;
+  W[tr] = intervalHull(interval(level), interval(new_level));
+  for ( short k = 0; k < TAYLOR_TRIES; k++ )
+    {
+      Vf_Range(vf, W);
+      if ( pcl.sign == 1 ? !(Inf(vf[tr]) > 0.0) : !(Sup(vf[tr]) < 0.0) )
+	return false;
+
+      bool inside = true;
+      for ( short i = 0; i < SYSDIM; i++ )
+	if ( i != tr )
+	  {
+	    next[i] = pcl.box[i] + s * (sign * vf[i] / vf[tr]);
+	    if ( !Subset(next[i], W[i]) )
+	      inside = false;
+	  }
+      for ( short i = 0; i < SYSDIM; i++ )
+	if ( i != tr )
+	  W[i] = ( inside ? next[i] : Rescale(intervalHull(W[i], next[i]), TAYLOR_INFLATE) );
+      if ( inside )
+	return true;
+    }
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by 'Taylor_Step'.
+// Encloses the derivatives D(s) of the step (for i, j != trvl) with
+// respect to its start. By D' = Dg D and Gronwall's inequality,
+//   |D(s) - I| <= exp(L h) - 1 <= L h + (L h)^2,
+// where L is the (max row sum) norm of Dg over W. Returns false
+// unless L h <= 1.
+static bool Variational_Bound(IMatrix &E, const BOX &W, const parcel &pcl,
+			      const interval &h)
+{
+  const short tr = pcl.trvl - 1;
+  BOX     vf(SYSDIM);
+  IMatrix DVf(SYSDIM, SYSDIM);
+  double  L = 0.0;
+
+  Vf_Range(vf, W);
+  DVf_Range(DVf, W);
+  interval inv = 1.0 / vf[tr];
+  for ( short i = 0; i < SYSDIM; i++ )
+    if ( i != tr )
+      {
+	interval row(0.0);
+	for ( short j = 0; j < SYSDIM; j++ )
+	  if ( j != tr ) // d(f_i / f_trvl) / dx_j
+	    row += interval(Mag((DVf(i + 1, j + 1) * vf[tr] - vf[i] * DVf(tr + 1, j + 1))
+				* inv * inv));
+	if ( Sup(row) > L )
+	  L = Sup(row);
+      }
+
+  double Lh = Sup(L * h);
+  if ( !(Lh <= 1.0) ) // Also for NaN.
+    return false;
+  double eps = Sup(interval(Lh) + interval(Lh) * Lh);
+
+  for ( short i = 0; i < SYSDIM; i++ )
+    for ( short j = 0; j < SYSDIM; j++ )
+      if ( i == tr || j == tr )
+	E(i + 1, j + 1) = 0.0;
+      else
+	E(i + 1, j + 1) = ( i == j ? 1.0 : 0.0 ) + Symm_Radius(eps);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by 'Taylor_Step' (for each start).
+// Computes the coefficients of order 1,..., n from those of order 0,
+// x[.][0]. The field (see 'vector_field.cc') is
+//   f_1 = E1 x_1 - K1 (x_1 + x_2) x_3,
+//   f_2 = E2 x_2 + K1 (x_1 + x_2) x_3,
+//   f_3 = E3 x_3 + (x_1 + x_2) (K2 x_1 + K3 x_2),
+// and x_trvl = level + sign * s.
+template <class T>
+static void Coefficients(taylor_series<T> &ts, const short &trvl,
+			 const short &sign, const int &n)
+{
+  const short tr = trvl - 1;
+  T a[TAYLOR_MAX_ORDER];          // x_1 + x_2
+  T b[TAYLOR_MAX_ORDER];          // K2 x_1 + K3 x_2
+  T f[SYSDIM][TAYLOR_MAX_ORDER];  // The field,
+  T q[SYSDIM][TAYLOR_MAX_ORDER];  // f_i / f_trvl,
+  T r[TAYLOR_MAX_ORDER];          // and 1 / f_trvl.
+  T zero(interval(0.0));
+
+  ts.t[0] = zero;
+  for ( int k = 1; k <= n; k++ )
+    ts.x[tr][k] = T(interval( k == 1 ? (double) sign : 0.0 ));
+
+  for ( int k = 0; k < n; k++ )
+    {
+      a[k] = ts.x[0][k] + ts.x[1][k];
+      b[k] = K2_IV * ts.x[0][k] + K3_IV * ts.x[1][k];
+      T ax = a[0] * ts.x[2][k];
+      T ab = a[0] * b[k];
+      for ( int j = 1; j <= k; j++ )
+	{
+	  ax = ax + a[j] * ts.x[2][k - j];
+	  ab = ab + a[j] * b[k - j];
+	}
+      f[0][k] = E1_IV * ts.x[0][k] - K1_IV * ax;
+      f[1][k] = E2_IV * ts.x[1][k] + K1_IV * ax;
+      f[2][k] = E3_IV * ts.x[2][k] + ab;
+
+      // Quotients of series: (u / v)_k = (u_k - sum_{j=1..k} v_j (u / v)_(k-j)) / v_0.
+      if ( k == 0 )
+	r[0] = Inverse(f[tr][0]);
+      else
+	{
+	  T sum = zero;
+	  for ( int j = 1; j <= k; j++ )
+	    sum = sum - f[tr][j] * r[k - j];
+	  r[k] = sum * r[0];
+	}
+      interval c = interval((double) sign) / interval((double) (k + 1));
+      ts.t[k + 1] = c * r[k];
+      for ( short i = 0; i < SYSDIM; i++ )
+	if ( i != tr )
+	  {
+	    T sum = f[i][k];
+	    for ( int j = 1; j <= k; j++ )
+	      sum = sum - f[tr][j] * q[i][k - j];
+	    q[i][k] = sum * r[0];
+	    ts.x[i][k + 1] = c * q[i][k];
+	  }
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by 'Taylor_Step'.
+// Returns c[0] + c[1] h + ... + c[n-1] h^(n-1) + last h^n.
+template <class T>
+static T Series_Sum(const T *c, const int &n, const interval &h, const T &last)
+{
+  T sum = last;
+  for ( int k = n - 1; k >= 0; k-- )
+    sum = sum * h + c[k];
+  return sum;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// The largest absolute value in 'iv'.
+static double Mag(const interval &iv)
+{
+  return ( - Inf(iv) > Sup(iv) ? - Inf(iv) : Sup(iv) );
+}
+
+// The intersection of two enclosures of the same set.
+static interval Meet(const interval &a, const interval &b)
+{
+  double lo = ( Inf(a) > Inf(b) ? Inf(a) : Inf(b) );
+  double hi = ( Sup(a) < Sup(b) ? Sup(a) : Sup(b) );
+  if ( lo > hi )
+    throw Error_Handler("Taylor_Step: The enclosures do not overlap!");
+  return interval(lo, hi);
+}
+
+////////////////////////////////////////////////////////////////////
@@ -0,0 +1,49 @@
+/*   File: taylor.h
+
+     A step of the integrator by Taylor series, instead of
+     'Flow_By_Corner_Method'. Selected by 'rodes --taylor N'
+     (0, the corner method, by default).
+
+     Like the corner method, the step goes from one plane
+     x_trvl = level to the next, so the series are in the
+     transversal coordinate s, not in time: for i != trvl
+
+       dx_i/ds = sign * f_i / f_trvl,   dt/ds = sign / f_trvl.
+
+     Their coefficients up to order N are computed by
+     automatic differentiation (the Lorenz field is
+     quadratic: only products and quotients of series are
+     needed). The remainder is the coefficient of order N
+     over an a priori enclosure of the step. The image is
+     the hull of the images of the corners where the
+     derivatives do not vanish, and the mean value form
+     elsewhere, each within the image of the whole box.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#ifndef TAYLOR_H
+#define TAYLOR_H
+
+#include "classes.h"
+
+////////////////////////////////////////////////////////////////////
+
+const int    TAYLOR_MAX_ORDER = 40;   // CAPD's Lorenz examples use 35.
+const int    TAYLOR_HALVINGS  = 6;    // Of trvl_dist, before we give up.
+const int    TAYLOR_TRIES     = 6;    // To find the a priori enclosure.
+const double TAYLOR_INFLATE   = 1.1;  // Its widening between tries.
+
+////////////////////////////////////////////////////////////////////
+
+void Set_Taylor_Order (const int &);
+
+int  Taylor_Order     ();
+
+bool Taylor_Step      (BOX &, interval &, IMatrix &, double &,
+		       const parcel &, const double &,
+		       const BOX * = NULL, BOX * = NULL);
+
+////////////////////////////////////////////////////////////////////
+
+#endif // TAYLOR_H
@@ -0,0 +1,253 @@
+/*   File: taylor_test.cc
+
+     Checks the steps of 'Taylor_Step' (see 'taylor.h')
+     against the flow of sample points of the box: the
+     corners, the center and random points, flowed by
+     'Point_Flow' (see 'point_flow.h').
+
+     Each of a few boxes on the plane z = 27 (flowing
+     down, as given by 'iterate_to_parcel') is flowed by
+     each distance of a sweep, as 'Flow' does it: by
+     Taylor series, or, if that gives up, by 'Corner_Step'.
+     Then
+
+       - the image of every sample point must lie in the
+         image box, and its time in the time of the step,
+         for the Taylor step and for 'Corner_Step';
+       - the image boxes of the two methods, over the same
+         distance, must meet.
+
+     Among the steps, at least one must be halved (and
+     counted in 'clipped_steps'), and at least one must be
+     left to the corner method.
+
+     Usage: taylor_test [order] [points]
+            (default 20 and 100)
+
+     Compilation: make taylor_test
+
+     Latest edit: Sat Oct 17 2026
+*/
+
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+
+#include "classes.h"
+#include "error_handler.h"
+#include "return_map.h"
+#include "taylor.h"
+#include "point_flow.h"
+#include "vector_field.h"
+#include "workspace.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+const double TEST_LEVEL    = 27.0;  // The plane of the boxes.
+
+enum STEP_KIND { FULL, HALVED, CORNER, KINDS };  // How a step went.
+
+////////////////////////////////////////////////////////////////////
+
+static int  step         (const parcel &, const double &, const int &, int []);
+static int  check_points (const parcel &, const BOX &, const interval &,
+			  const int &, const char *);
+static void sample       (long double [], const parcel &, const int &);
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: none
+// Calls to : 'Set_Taylor_Order', 'step'
+int main(int argc, char *argv[])
+{
+  int order  = ( argc >= 2 ? atoi(argv[1]) : 20 );
+  int points = ( argc >= 3 ? atoi(argv[2]) : 100 );
+  if ( argc > 3 || order <= 0 || order > TAYLOR_MAX_ORDER || points < 0 )
+    {
+      cout << endl << "Usage: " << endl;
+      cout << "\t" << argv[0] << " [order] [points]\n\n"
+	   << "\twhich checks the steps by Taylor series of [order]\n"
+	   << "\t(default 20, at most " << TAYLOR_MAX_ORDER << ") against the flow of the\n"
+	   << "\tcorners, the center and [points] (default 100) random\n"
+	   << "\tpoints of a few boxes.\n" << endl;
+      exit(0);
+    }
+  Set_Taylor_Order(order);
+
+  // The centers (x1, x2) and radii of the boxes, and the longest
+  // distance they are flowed by: two where the flow crosses the
+  // plane fast (f3 about -70), and one at x2 = 0 where it crosses
+  // slowly (f3 = -SLOW_F3). The last turns back within a distance
+  // of about SLOW_F3 / 3 (where 'Flow' switches transversal), and is
+  // flowed only as far as the corner method can take it.
+  const double SLOW_F3 = 4.0;
+  const double slow_x1 = sqrt( (- Mid(E3_IV) * TEST_LEVEL - SLOW_F3) / Mid(K2_IV) );
+  const double boxes[][4] = { { 1.0,      1.0, 1e-3, 20.0 },
+			      { 3.0,     -2.0, 1e-2, 20.0 },
+			      { slow_x1,  0.0, 1e-3,  1.0 } };
+  const double dists[] = { 0.05, 0.5, 1.0, 5.0, 20.0 };
+  const int    BOXES = sizeof(boxes) / sizeof(boxes[0]);
+  const int    DISTS = sizeof(dists) / sizeof(dists[0]);
+
+  int kinds[KINDS] = { 0, 0, 0 };
+  int errors = 0;
+  srand(1);
+  for ( int b = 0; b < BOXES; b++ )
+    {
+      parcel pcl;
+      pcl.box    = BOX(SYSDIM);
+      pcl.box(1) = Hull(boxes[b][0] - boxes[b][2], boxes[b][0] + boxes[b][2]);
+      pcl.box(2) = Hull(boxes[b][1] - boxes[b][2], boxes[b][1] + boxes[b][2]);
+      pcl.box(3) = TEST_LEVEL;
+      pcl.trvl    = 3;
+      pcl.sign    = -1;
+      pcl.time    = 0.0;
+      pcl.message = 0;
+      for ( int d = 0; d < DISTS && dists[d] <= boxes[b][3]; d++ )
+	errors += step(pcl, dists[d], points, kinds);
+    }
+
+  if ( kinds[HALVED] == 0 )
+    {
+      cout << "Error: no step was halved." << endl;
+      errors++;
+    }
+  if ( kinds[CORNER] == 0 )
+    {
+      cout << "Error: no step was left to the corner method." << endl;
+      errors++;
+    }
+  cout << kinds[FULL] << " steps taken in full, " << kinds[HALVED] << " halved, "
+       << kinds[CORNER] << " by the corner method" << endl;
+  cout << "taylor steps of order " << order << ": "
+       << ( errors == 0 ? "ok" : "FAILED" ) << endl;
+  return ( errors == 0 ? 0 : 1 );
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main'
+// Calls to : 'Taylor_Step', 'Corner_Step', 'check_points'
+// Flows pcl by 'dist' as 'Flow' does, and checks the step against
+// 'points' random points (and the corners and center) of pcl.box.
+// Counts it in 'kinds'. Returns the number of errors found.
+static int step(const parcel &pcl, const double &dist, const int &points,
+		int kinds[])
+{
+  BOX      taylor_box(SYSDIM), corner_box(SYSDIM), meet(SYSDIM);
+  IMatrix  DPi(SYSDIM, SYSDIM);
+  interval taylor_time, corner_time;
+  double   achieved;
+  int      errors = 0;
+
+  cout << "box " << pcl.box << ", distance " << dist << ": ";
+  try
+    {
+      long clipped = Thread_Workspace().stats.clipped_steps;
+      bool taylor  = Taylor_Step(taylor_box, taylor_time, DPi, achieved, pcl, dist);
+      long counted = Thread_Workspace().stats.clipped_steps - clipped;
+
+      parcel corner_pcl = pcl;  // 'Corner_Step' may change its message.
+      double corner_achieved = Corner_Step(corner_box, corner_time, DPi, corner_pcl,
+					   taylor ? achieved : dist);
+      if ( !taylor )
+	{
+	  cout << "by the corner method, to " << corner_box(pcl.trvl) << endl;
+	  kinds[CORNER]++;
+	}
+      else
+	{
+	  cout << "went " << achieved << endl;
+	  kinds[ achieved < dist ? HALVED : FULL ]++;
+	  if ( counted != ( achieved < dist ? 1 : 0 ) )
+	    {
+	      cout << "Error: the step went " << achieved << " of " << dist
+		   << ", but " << counted << " clipped steps were counted." << endl;
+	      errors++;
+	    }
+	  errors += check_points(pcl, taylor_box, taylor_time, points, "Taylor_Step");
+
+	  // The corner method may have stopped short: then the
+	  // Taylor step is taken again, to the same plane.
+	  if ( corner_achieved < achieved &&
+	       ( !Taylor_Step(taylor_box, taylor_time, DPi, achieved, pcl, corner_achieved) ||
+		 achieved < corner_achieved ) )
+	    cout << "  (not compared with the corner method, which went "
+		 << corner_achieved << ")" << endl;
+	  else if ( !Intersection(meet, taylor_box, corner_box) )
+	    {
+	      cout << "Error: the images " << taylor_box << " and " << corner_box
+		   << " do not meet." << endl;
+	      errors++;
+	    }
+	}
+      errors += check_points(pcl, corner_box, corner_time, points, "Corner_Step");
+    }
+  catch( Error_Handler error )
+    {
+      error.Print_Message();
+      cout << "Error: could not flow the box " << pcl.box << endl;
+      errors++;
+    }
+  return errors;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'step'
+// Calls to : 'sample', 'Point_Flow', 'Point_Inside'
+// Flows sample points of pcl.box to the plane of 'image', and checks
+// that they land in 'image', in 'time'. Returns the number of points
+// that do not.
+static int check_points(const parcel &pcl, const BOX &image, const interval &time,
+			const int &points, const char *method)
+{
+  const short       tr    = pcl.trvl - 1;
+  const long double level = Inf(image[tr]);  // Inf == Sup.
+  long double x[SYSDIM], t;
+  int errors = 0;
+
+  for ( int k = 0; k < CORNERS + 1 + points; k++ )
+    {
+      sample(x, pcl, k);
+      Point_Flow(x, t, pcl.trvl, level);
+
+      bool in = Point_Inside(time, t);
+      for ( short i = 0; i < SYSDIM; i++ )
+	if ( i != tr && !Point_Inside(image[i], x[i]) )
+	  in = false;
+      if ( !in && errors++ < 3 )
+	cout << "Error: '" << method << "'. The image (" << (double) x[0] << ", "
+	     << (double) x[1] << ", " << (double) x[2] << ") at time " << (double) t
+	     << " of a point is not in " << image << " at time " << time << endl;
+    }
+  return errors;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'check_points'
+// The k:th sample point of pcl.box: its corners (in the coordinates
+// other than trvl) first, then its center, then random points.
+static void sample(long double x[], const parcel &pcl, const int &k)
+{
+  short bit = 0;
+
+  for ( short i = 0; i < SYSDIM; i++ )
+    {
+      const interval &side = pcl.box[i];
+      if ( i == pcl.trvl - 1 )
+	x[i] = Inf(side);
+      else if ( k < CORNERS )
+	x[i] = ( (k >> bit++) & 1 ? Sup(side) : Inf(side) );
+      else if ( k == CORNERS )
+	x[i] = Mid(side);
+      else
+	x[i] = Inf(side) + (Sup(side) - Inf(side)) * ((long double) rand() / RAND_MAX);
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
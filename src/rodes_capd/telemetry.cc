@@ -0,0 +1,146 @@
+/*   File: telemetry.cc
+
+     What it took to do a grid. See 'telemetry.h'.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <sstream>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "telemetry.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+static std::string stats_name; // Set by 'stats_open'.
+
+////////////////////////////////////////////////////////////////////
+
+grid_stats::grid_stats()
+{
+  clear();
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'grid_stats', 'work_on_grid' (rodes)
+// Calls to : none
+void grid_stats::clear()
+{
+  grd.u = grd.v = grd.P = 0;
+  c_stat              = NOT_DONE;
+  wall = cpu          = 0.0;
+  flow_steps          = 0;
+  multiple_partitions = 0;
+  pieces              = 0;
+  switches            = 0;
+  cube_exits          = 0;
+  peak_parcels        = 0;
+  returns             = 0;
+  clipped_steps       = 0;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'Flow_The_Parcel' (return_map), 'add'
+// Calls to : none
+void grid_stats::note_peak(const int &parcels)
+{
+  if ( parcels > peak_parcels )
+    peak_parcels = parcels;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'flow_pool::run'
+// Calls to : 'note_peak'
+// Adds the counts of another thread, which helped with the grid.
+void grid_stats::add(const grid_stats &st)
+{
+  cpu                 += st.cpu;
+  flow_steps          += st.flow_steps;
+  multiple_partitions += st.multiple_partitions;
+  pieces              += st.pieces;
+  switches            += st.switches;
+  cube_exits          += st.cube_exits;
+  returns             += st.returns;
+  clipped_steps       += st.clipped_steps;
+  note_peak(st.peak_parcels);
+}
+
+////////////////////////////////////////////////////////////////////
+
+ostream & operator << (ostream &out, const grid_stats &st)
+{
+  out << st.grd.u << " " << st.grd.v << " " << st.grd.P << " "
+      << st.c_stat << " " << st.wall << " " << st.cpu << " "
+      << st.flow_steps << " " << st.multiple_partitions << " "
+      << st.pieces << " " << st.switches << " "
+      << st.cube_exits << " " << st.peak_parcels << " "
+      << st.returns << " " << st.clipped_steps;
+  return out;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Reads one line, which may lack <returns> and <clipped_steps>.
+istream & operator >> (istream &in, grid_stats &st)
+{
+  std::string text;
+  while ( getline(in, text) && text.find_first_not_of(" \t") == std::string::npos )
+    ; // Skip empty lines.
+  if ( !in )
+    return in;
+
+  std::istringstream line(text);
+  line >> st.grd.u >> st.grd.v >> st.grd.P
+       >> st.c_stat >> st.wall >> st.cpu
+       >> st.flow_steps >> st.multiple_partitions
+       >> st.pieces >> st.switches
+       >> st.cube_exits >> st.peak_parcels;
+  if ( !line )
+    in.setstate(ios::failbit);
+  else if ( !(line >> st.returns >> st.clipped_steps) )
+    st.returns = st.clipped_steps = 0;
+  return in;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_the_flags' (rodes)
+// Calls to : none
+void stats_open(const char *shared_file)
+{
+  stats_name = std::string(shared_file) + STATS_SUFFIX;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'work_on_grid' (rodes)
+// Calls to : none
+// Appends the record 'st' to <shared_file>.stats. The line is
+// written at once (O_APPEND), so the records of several processes
+// (and threads) do not mix.
+void stats_write(const grid_stats &st)
+{
+  if ( stats_name.empty() )
+    return;
+
+  std::ostringstream line;
+  line << st << "\n";
+
+  int fd = open(stats_name.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0666);
+  if ( fd < 0 )
+    return;
+  std::string text = line.str();
+  if ( write(fd, text.data(), text.size()) != (ssize_t) text.size() )
+    cout << "Warning: could not write " << stats_name << endl;
+  close(fd);
+}
+
+////////////////////////////////////////////////////////////////////
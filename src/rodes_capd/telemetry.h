@@ -0,0 +1,68 @@
+/*   File: telemetry.h
+
+     What it took to do a grid. While a grid is being
+     done, the integrator counts its steps, splits,
+     switches of transversal and cube exits in the
+     'grid_stats' of the thread's workspace. When the
+     grid is done, 'work_on_grid' appends the record,
+     with the wall and CPU times, to <shared_file>.stats:
+
+       <u> <v> <P> <c_stat> <wall> <cpu> <flow_steps>
+       <multiple_partitions> <pieces>
+       <switches> <cube_exits> <peak_parcels>
+       <returns> <clipped_steps>
+
+     (one line per grid; older records end at <peak_parcels>).
+     'rodes_report' sums the records up by zone.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "2d_classes.h"
+
+////////////////////////////////////////////////////////////////////
+
+// The records of <shared_file> are appended to <shared_file>
+// followed by this suffix.
+static const char STATS_SUFFIX[] = ".stats";
+
+////////////////////////////////////////////////////////////////////
+
+class grid_stats
+{
+ public:
+  grid_stats();
+
+  void clear     ();
+  void note_peak (const int &);
+  void add       (const grid_stats &);
+
+  grid   grd;
+  int    c_stat;               // DONE or FAILED.
+  double wall;                 // Seconds,...
+  double cpu;                  // ...and CPU seconds of all its threads.
+  long   flow_steps;           // Calls to 'Flow'.
+  long   multiple_partitions;  // Calls to 'Multiple_Partition',...
+  long   pieces;               // ...and the parcels they made.
+  long   switches;             // Calls to 'Update_Transversal'.
+  long   cube_exits;           // Calls to 'Cube_Exit'.
+  int    peak_parcels;         // The longest list of parcels to flow.
+  long   returns;              // Parcels flowed to the stopping plane.
+  long   clipped_steps;        // Steps trimmed (or halved by 'Taylor_Step').
+
+  friend ostream & operator << (ostream &, const grid_stats &);
+  friend istream & operator >> (istream &, grid_stats &);
+};
+
+////////////////////////////////////////////////////////////////////
+
+void stats_open  (const char *);
+
+void stats_write (const grid_stats &);
+
+////////////////////////////////////////////////////////////////////
+
+#endif // TELEMETRY_H
@@ -0,0 +1,167 @@
+/*   File: trace.cc
+
+     Tracing of the integrator. See 'trace.h'.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "trace.h"
+#include "workspace.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+static int trace_fd = -1; // Set by 'trace_open'.
+
+#if TRACE_LEVEL > 0
+
+int trace_level = 0;
+
+static int             trace_threads = 0; // For 'trace_ring::thread'.
+static pthread_mutex_t trace_mutex   = PTHREAD_MUTEX_INITIALIZER;
+
+#endif
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_the_flags' (rodes)
+// Calls to : none
+// Appends the records to 'file_name' (<shared_file>_<proc_nr>.trace),
+// which starts with TRACE_MAGIC and the size of a record.
+void trace_open(const char *file_name)
+{
+  trace_fd = open(file_name, O_WRONLY | O_APPEND | O_CREAT, 0666);
+  if ( trace_fd < 0 )
+    {
+      cout << "Warning: could not open " << file_name
+	   << "; nothing is traced." << endl;
+      return;
+    }
+  if ( lseek(trace_fd, 0, SEEK_END) == 0 )
+    {
+      int size = sizeof(trace_record);
+      if ( write(trace_fd, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != sizeof(TRACE_MAGIC) ||
+	   write(trace_fd, &size, sizeof(size)) != sizeof(size) )
+	cout << "Warning: could not write " << file_name << endl;
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_the_options' (rodes)
+// Calls to : none
+void Set_Trace_Level(const int &level)
+{
+#if TRACE_LEVEL > 0
+  trace_level = level;
+#endif
+  if ( level > TRACE_LEVEL )
+    cout << "Warning: only trace levels up to " << TRACE_LEVEL
+	 << " are compiled in (make TRACE=" << level << ")." << endl;
+}
+
+////////////////////////////////////////////////////////////////////
+
+#if TRACE_LEVEL > 0
+
+trace_ring::trace_ring()
+  : first(0), count(0), seq(0), thread(-1)
+{ }
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'Trace'
+// Calls to : 'flush'
+// Adds 'rec', numbered. When the ring is full, it is written out, or
+// (without a file) the oldest record is overwritten.
+void trace_ring::add(const trace_record &rec)
+{
+  if ( thread < 0 )
+    {
+      pthread_mutex_lock(&trace_mutex);
+      thread = trace_threads++;
+      pthread_mutex_unlock(&trace_mutex);
+    }
+  if ( count == TRACE_RING )
+    {
+      if ( trace_fd >= 0 )
+	flush();
+      else
+	{
+	  first = (first + 1) % TRACE_RING;
+	  count--;
+	}
+    }
+
+  trace_record &next = records[(first + count) % TRACE_RING];
+  next        = rec;
+  next.seq    = seq++;
+  next.thread = thread;
+  count++;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'add', 'Trace_Flush'
+// Calls to : none
+// Appends the records to the file, oldest first. Each write is a
+// whole number of records (O_APPEND), so those of the threads do
+// not mix.
+void trace_ring::flush()
+{
+  if ( trace_fd < 0 || count == 0 )
+    return;
+
+  int tail = ( first + count <= TRACE_RING ? count : TRACE_RING - first );
+  if ( write(trace_fd, &records[first], tail * sizeof(trace_record)) < 0 ||
+       ( tail < count &&
+	 write(trace_fd, &records[0], (count - tail) * sizeof(trace_record)) < 0 ) )
+    cout << "Warning: could not write the trace." << endl;
+  first = count = 0;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: the TRACE macro
+// Calls to : 'trace_ring::add'
+// Records 'box', 'a' and 'b' (see 'trace_kind'), with the transversal
+// and direction of 'pcl', in the ring of the calling thread.
+void Trace(const int &level, const int &kind, const parcel &pcl, const BOX &box,
+	   const double &a, const double &b)
+{
+  trace_record rec;
+
+  rec.kind  = kind;
+  rec.level = level;
+  rec.trvl  = pcl.trvl;
+  rec.sign  = pcl.sign;
+  for ( short i = 0; i < SYSDIM; i++ )
+    {
+      rec.box[2 * i]     = Inf(box[i]);
+      rec.box[2 * i + 1] = Sup(box[i]);
+    }
+  rec.a = a;
+  rec.b = b;
+  Thread_Workspace().trace.add(rec);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'work_on_grid' (rodes), 'flow_pool::in_thread'
+// Calls to : 'trace_ring::flush'
+// Writes out what the calling thread has recorded.
+void Trace_Flush()
+{
+  Thread_Workspace().trace.flush();
+}
+
+#endif // TRACE_LEVEL > 0
+
+////////////////////////////////////////////////////////////////////
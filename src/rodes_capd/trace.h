@@ -0,0 +1,121 @@
+/*   File: trace.h
+
+     Tracing of the integrator. TRACE_LEVEL (0 by default,
+     or 'make TRACE=L') is the most detailed level compiled
+     in: above it the TRACE macro is empty, and its
+     arguments are never evaluated. Up to TRACE_LEVEL,
+     'rodes --trace L' chooses what is recorded (0, nothing,
+     by default):
+
+       1  each step of a parcel (Flow), its stops, switches
+          of transversal and cube entries, and each grid;
+       2  also the boxes within a step (Get_Flow_Time and
+          Flow_By_Corner_Method).
+
+     A record is a few bytes of binary, not formatted text.
+     Each thread keeps them in a ring in its workspace; when
+     the ring is full, and when a grid is done, the records
+     are appended to the file set by 'trace_open'. Without
+     a file the ring keeps the last TRACE_RING records.
+     'rodes_trace' prints them.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "classes.h"
+
+#ifndef TRACE_LEVEL
+#define TRACE_LEVEL 0
+#endif
+
+////////////////////////////////////////////////////////////////////
+
+// The file of a process is <shared_file>_<proc_nr> followed by this.
+static const char TRACE_SUFFIX[] = ".trace";
+
+// The file starts with this (and the size of a record).
+static const char TRACE_MAGIC[8] = { 'R', 'O', 'D', 'E', 'S', 'T', 'R', '1' };
+
+// The records kept by each thread before they are written.
+const int TRACE_RING = 1024;
+
+enum trace_kind
+{
+  TRACE_GRID,        // box: the grid's parcel;    a, b: u, v
+  TRACE_RESOLUTION,  // box: the parcel;           a, b: max_size, more_than_one
+  TRACE_FLOW,        // box: the parcel;           a:    trvl_dist
+  TRACE_STEP,        // box: the flowed parcel;    a, b: its time
+  TRACE_STOP,        // box: the returned parcel;  a, b: its time
+  TRACE_CUBE_ENTRY,  // box: the parcel
+  TRACE_SWITCH,      // box: the parcel;           a:    the new sign
+  TRACE_OUTER_BOX,   // box: Outer_Box;            a, b: trvl_dist, the Taylor order
+  TRACE_TRIMMED_BOX, // box: Outer_Box, trimmed;   a, b: trvl_dx, min_time
+  TRACE_FLOW_TIME,   // box: Outer_Box, tightened; a, b: the time
+  TRACE_CORNER_DX,   // box: dx;                   a:    trvl_dist
+  TRACE_CORNER_BOX,  // box: Result_Box;           a:    1 if DPi may vanish
+  TRACE_KINDS
+};
+
+static const char * const TRACE_KIND_NAMES[TRACE_KINDS] =
+  { "grid", "resolution", "flow", "step", "stop", "cube_entry", "switch",
+    "outer_box", "trimmed_box", "flow_time", "corner_dx", "corner_box" };
+
+typedef struct
+{
+  unsigned int   seq;              // Counted by each thread.
+  unsigned short thread;           // 0, 1,... in the order they trace.
+  unsigned char  kind;             // A 'trace_kind'.
+  unsigned char  level;
+  short          trvl;
+  short          sign;
+  double         box[2 * SYSDIM];  // Inf and Sup of each coordinate.
+  double         a, b;
+} trace_record;
+
+////////////////////////////////////////////////////////////////////
+
+#if TRACE_LEVEL > 0
+
+class trace_ring
+{
+ public:
+  trace_ring();
+
+  void add   (const trace_record &);
+  void flush ();
+
+ private:
+  trace_record records[TRACE_RING];
+  int          first;   // The oldest record,
+  int          count;   // and how many there are.
+  unsigned int seq;
+  int          thread;  // -1 until the first record.
+};
+
+extern int trace_level; // Set by 'Set_Trace_Level'.
+
+void Trace       (const int &, const int &, const parcel &, const BOX &,
+		  const double &, const double &);
+void Trace_Flush ();
+
+#define TRACE(level, kind, pcl, box, a, b)				\
+  do { if ( (level) <= TRACE_LEVEL && (level) <= trace_level )		\
+         Trace((level), (kind), (pcl), (box), (a), (b)); } while (0)
+
+#else
+
+inline void Trace_Flush () { }
+
+#define TRACE(level, kind, pcl, box, a, b) ((void) 0)
+
+#endif // TRACE_LEVEL > 0
+
+void trace_open      (const char *);
+void Set_Trace_Level (const int &);
+
+////////////////////////////////////////////////////////////////////
+
+#endif // TRACE_H
@@ -0,0 +1,160 @@
+/*   File: up_interval.cc
+
+     The functions of 'up_interval' that are not inlined.
+     See 'up_interval.h'.
+
+     The elementary functions of the C library are not
+     correctly rounded: their results are widened by a
+     few units in the last place.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include "classes.h"
+
+#ifdef HOISTED_ROUNDING
+
+#include <cmath>
+
+////////////////////////////////////////////////////////////////////
+
+// The units in the last place by which the results of
+// 'std::log', 'std::exp' and 'std::pow' are widened.
+static const int LIBM_ULPS = 2;
+
+static double      Below         (double);
+static double      Above         (double);
+static up_interval Power_Of_Point(const double &, const int &);
+
+////////////////////////////////////////////////////////////////////
+
+// [3.141592653589793, 3.1415926535897936]: the doubles
+// next to pi, read in at compile time.
+up_interval up_interval::pi()
+{
+  return up_interval(3.141592653589793, 3.1415926535897936);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'Flow_The_Parcel' (return_map)
+// Calls to : none
+void Check_Rounding()
+{
+  if ( fegetround() != FE_UPWARD )
+    throw Error_Handler("Check_Rounding: The rounding is no longer upward!");
+}
+
+////////////////////////////////////////////////////////////////////
+
+std::ostream & operator << (std::ostream &out, const up_interval &a)
+{
+  return out << "[" << a.leftBound() << "," << a.rightBound() << "]";
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'power'
+// Calls to : none
+// An interval containing x^n (n >= 0), by repeated squaring.
+static up_interval Power_Of_Point(const double &x, const int &n)
+{
+  up_interval result(1.0), base(x);
+
+  for ( int k = n; k > 0; k >>= 1 )
+    {
+      if ( k & 1 )
+	result *= base;
+      base *= base;
+    }
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////
+
+up_interval power(const up_interval &a, const int &n)
+{
+  if ( n < 0 )
+    return up_interval(1.0) / power(a, - n);
+  if ( n == 0 )
+    return up_interval(1.0);
+  if ( n % 2 == 1 ) // Increasing.
+    return up_interval::Neg_Lo(Power_Of_Point(a.leftBound(), n).nlo,
+			       Power_Of_Point(a.rightBound(), n).hi);
+  up_interval m = iabs(a);
+  return up_interval::Neg_Lo(Power_Of_Point(m.leftBound(), n).nlo,
+			     Power_Of_Point(m.rightBound(), n).hi);
+}
+
+// Only for intervals above zero.
+up_interval power(const up_interval &a, const up_interval &p)
+{
+  if ( a.leftBound() <= 0.0 )
+    throw Error_Handler("power: The interval is not above zero!");
+
+  // x^p is monotone in x, and in p: it is largest and smallest
+  // at the corners.
+  double c[4] = { std::pow(a.leftBound(),  p.leftBound()),
+		  std::pow(a.leftBound(),  p.rightBound()),
+		  std::pow(a.rightBound(), p.leftBound()),
+		  std::pow(a.rightBound(), p.rightBound()) };
+  double lo = c[0], hi = c[0];
+  for ( short i = 1; i < 4; i++ )
+    {
+      if ( c[i] < lo ) lo = c[i];
+      if ( c[i] > hi ) hi = c[i];
+    }
+  return up_interval(Max_Of(Below(lo), 0.0), Above(hi));
+}
+
+up_interval power(const up_interval &a, const double &p)
+{
+  return power(a, up_interval(p));
+}
+
+////////////////////////////////////////////////////////////////////
+
+up_interval sqrt(const up_interval &a)
+{
+  if ( a.leftBound() < 0.0 )
+    throw Error_Handler("sqrt: The interval is not above zero!");
+
+  // The square root is correctly rounded (upward): the double
+  // below it is below the root.
+  double lo = ( a.leftBound() > 0.0 ? nextafter(std::sqrt(a.leftBound()), 0.0) : 0.0 );
+  return up_interval(lo, std::sqrt(a.hi));
+}
+
+up_interval log(const up_interval &a)
+{
+  if ( a.leftBound() <= 0.0 )
+    throw Error_Handler("log: The interval is not above zero!");
+
+  return up_interval(Below(std::log(a.leftBound())), Above(std::log(a.hi)));
+}
+
+up_interval exp(const up_interval &a)
+{
+  return up_interval(Max_Of(Below(std::exp(a.leftBound())), 0.0),
+		     Above(std::exp(a.hi)));
+}
+
+////////////////////////////////////////////////////////////////////
+
+static double Below(double x)
+{
+  for ( int i = 0; i < LIBM_ULPS; i++ )
+    x = nextafter(x, - HUGE_VAL);
+  return x;
+}
+
+static double Above(double x)
+{
+  for ( int i = 0; i < LIBM_ULPS; i++ )
+    x = nextafter(x, HUGE_VAL);
+  return x;
+}
+
+////////////////////////////////////////////////////////////////////
+
+#endif // HOISTED_ROUNDING
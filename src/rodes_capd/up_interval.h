@@ -0,0 +1,297 @@
+/*   File: up_interval.h
+
+     Interval arithmetic with the rounding mode set once:
+     upward, for the whole program. Selected as 'interval'
+     in 'classes.h' with HOISTED_ROUNDING (see there, and
+     'make ROUNDING=up').
+
+     CAPD's intervals switch the rounding mode twice per
+     operation, and -ffloat-store spills every result to
+     memory. Here an interval is kept as (-lo, hi): with
+     the rounding upward, an upper bound of -x is a lower
+     bound of x, so both bounds of a sum or product are
+     rounded outwards without switching (-(-a * b) <= a * b).
+     The bounds are plain doubles, kept in SSE2 registers
+     (x86-64, or -msse2 -mfpmath=sse), which have no excess
+     precision: -ffloat-store is not needed.
+
+     The rounding is set upward by each file including this
+     header, before any of its constants are computed, and
+     threads inherit it from the thread creating them.
+     'Check_Rounding' makes sure nothing has changed it.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#ifndef UP_INTERVAL_H
+#define UP_INTERVAL_H
+
+#include <iostream>
+#include <fenv.h>
+
+#include "capd/basicalg/TypeTraits.h"
+
+#include "error_handler.h"
+
+////////////////////////////////////////////////////////////////////
+
+class up_interval
+{
+ public:
+  double nlo;  // - (the lower bound)
+  double hi;   //    the upper bound
+
+  up_interval() : nlo(0.0), hi(0.0) { }
+  up_interval(const double &x) : nlo(- x), hi(x) { }
+  up_interval(const double &lo, const double &up) : nlo(- lo), hi(up)
+  {
+    if ( lo > up )
+      throw Error_Handler("up_interval: The lower bound is above the upper bound!");
+  }
+
+  // From the bounds as they are kept.
+  static up_interval Neg_Lo(const double &neg_lo, const double &up)
+  {
+    up_interval iv;
+    iv.nlo = neg_lo;
+    iv.hi  = up;
+    return iv;
+  }
+  static up_interval pi();
+
+  double leftBound () const { return - nlo; }
+  double rightBound() const { return hi; }
+
+  up_interval mid() const  // Contains the center.
+  { return Neg_Lo(0.5 * nlo + (- 0.5 * hi), 0.5 * hi + (- 0.5 * nlo)); }
+
+  bool contains      (const double &x)      const { return - nlo <= x && x <= hi; }
+  bool contains      (const up_interval &x) const { return x.nlo <= nlo && x.hi <= hi; }
+  bool containsInInterior(const double &x)  const { return - nlo < x && x < hi; }
+  bool subset        (const up_interval &x) const { return nlo <= x.nlo && hi <= x.hi; }
+  bool subsetInterior(const up_interval &x) const { return nlo < x.nlo && hi < x.hi; }
+
+  up_interval & operator += (const up_interval &x) { nlo += x.nlo; hi += x.hi; return *this; }
+  up_interval & operator -= (const up_interval &x)
+  { double t = nlo + x.hi; hi += x.nlo; nlo = t; return *this; }
+  up_interval & operator *= (const up_interval &x);
+  up_interval & operator /= (const up_interval &x);
+};
+
+////////////////////////////////////////////////////////////////////
+
+// Sets the rounding upward. One in each file, constructed
+// before the constants of the file (like 'ios_base::Init').
+class round_upward
+{
+ public:
+  round_upward() { fesetround(FE_UPWARD); }
+};
+
+static round_upward round_upward_here;
+
+void Check_Rounding ();
+
+////////////////////////////////////////////////////////////////////
+
+inline double Max_Of(const double &a, const double &b)
+{ return a > b ? a : b; }
+
+inline up_interval operator - (const up_interval &a)
+{ return up_interval::Neg_Lo(a.hi, a.nlo); }
+
+inline up_interval operator + (const up_interval &a, const up_interval &b)
+{ return up_interval::Neg_Lo(a.nlo + b.nlo, a.hi + b.hi); }
+
+inline up_interval operator - (const up_interval &a, const up_interval &b)
+{ return up_interval::Neg_Lo(a.nlo + b.hi, a.hi + b.nlo); }
+
+// The hull of the four products of the bounds.
+inline up_interval operator * (const up_interval &a, const up_interval &b)
+{
+  double a_lo = - a.nlo, a_nhi = - a.hi, b_lo = - b.nlo;
+
+  return up_interval::Neg_Lo(Max_Of(Max_Of(a.nlo * b_lo, a.nlo * b.hi),
+				    Max_Of(a_nhi * b_lo, a_nhi * b.hi)),
+			     Max_Of(Max_Of(a_lo * b_lo, a_lo * b.hi),
+				    Max_Of(a.hi * b_lo, a.hi * b.hi)));
+}
+
+// The hull of the four quotients of the bounds.
+inline up_interval operator / (const up_interval &a, const up_interval &b)
+{
+  if ( b.nlo >= 0.0 && b.hi >= 0.0 )
+    throw Error_Handler("up_interval: Division by an interval containing zero!");
+
+  double a_lo = - a.nlo, a_nhi = - a.hi, b_lo = - b.nlo;
+
+  return up_interval::Neg_Lo(Max_Of(Max_Of(a.nlo / b_lo, a.nlo / b.hi),
+				    Max_Of(a_nhi / b_lo, a_nhi / b.hi)),
+			     Max_Of(Max_Of(a_lo / b_lo, a_lo / b.hi),
+				    Max_Of(a.hi / b_lo, a.hi / b.hi)));
+}
+
+inline up_interval & up_interval::operator *= (const up_interval &x)
+{ return *this = *this * x; }
+
+inline up_interval & up_interval::operator /= (const up_interval &x)
+{ return *this = *this / x; }
+
+////////////////////////////////////////////////////////////////////
+
+// With a double, fewer products are needed.
+
+inline up_interval operator + (const up_interval &a, const double &d)
+{ return up_interval::Neg_Lo(a.nlo + (- d), a.hi + d); }
+
+inline up_interval operator + (const double &d, const up_interval &a)
+{ return a + d; }
+
+inline up_interval operator - (const up_interval &a, const double &d)
+{ return up_interval::Neg_Lo(a.nlo + d, a.hi + (- d)); }
+
+inline up_interval operator - (const double &d, const up_interval &a)
+{ return up_interval::Neg_Lo(a.hi + (- d), a.nlo + d); }
+
+inline up_interval operator * (const up_interval &a, const double &d)
+{
+  if ( d >= 0.0 )
+    return up_interval::Neg_Lo(a.nlo * d, a.hi * d);
+  return up_interval::Neg_Lo(a.hi * (- d), a.nlo * (- d));
+}
+
+inline up_interval operator * (const double &d, const up_interval &a)
+{ return a * d; }
+
+inline up_interval operator / (const up_interval &a, const double &d)
+{
+  if ( d > 0.0 )
+    return up_interval::Neg_Lo(a.nlo / d, a.hi / d);
+  if ( d < 0.0 )
+    return up_interval::Neg_Lo(a.hi / (- d), a.nlo / (- d));
+  throw Error_Handler("up_interval: Division by zero!");
+}
+
+inline up_interval operator / (const double &d, const up_interval &a)
+{ return up_interval(d) / a; }
+
+////////////////////////////////////////////////////////////////////
+
+// As in CAPD: a < b if all of a is below all of b, etc.
+
+inline bool operator <  (const up_interval &a, const up_interval &b) { return a.hi < - b.nlo; }
+inline bool operator >  (const up_interval &a, const up_interval &b) { return b < a; }
+inline bool operator <= (const up_interval &a, const up_interval &b) { return a.hi <= - b.nlo; }
+inline bool operator >= (const up_interval &a, const up_interval &b) { return b <= a; }
+inline bool operator == (const up_interval &a, const up_interval &b)
+{ return a.nlo == b.nlo && a.hi == b.hi; }
+inline bool operator != (const up_interval &a, const up_interval &b) { return !(a == b); }
+
+inline bool operator <  (const up_interval &a, const double &d) { return a.hi < d; }
+inline bool operator >  (const up_interval &a, const double &d) { return - a.nlo > d; }
+inline bool operator <= (const up_interval &a, const double &d) { return a.hi <= d; }
+inline bool operator >= (const up_interval &a, const double &d) { return - a.nlo >= d; }
+inline bool operator <  (const double &d, const up_interval &a) { return a > d; }
+inline bool operator >  (const double &d, const up_interval &a) { return a < d; }
+inline bool operator <= (const double &d, const up_interval &a) { return a >= d; }
+inline bool operator >= (const double &d, const up_interval &a) { return a <= d; }
+inline bool operator == (const up_interval &a, const double &d) { return a == up_interval(d); }
+inline bool operator != (const up_interval &a, const double &d) { return !(a == d); }
+
+std::ostream & operator << (std::ostream &, const up_interval &);
+
+////////////////////////////////////////////////////////////////////
+
+// The functions of CAPD's intervals that are used (and those the
+// vectors and matrices of CAPD need).
+
+inline double leftBound (const up_interval &a) { return - a.nlo; }
+inline double rightBound(const up_interval &a) { return a.hi; }
+inline up_interval mid  (const up_interval &a) { return a.mid(); }
+
+inline up_interval diam(const up_interval &a)
+{ return up_interval::Neg_Lo((- a.hi) + (- a.nlo), a.hi + a.nlo); }
+
+inline up_interval intervalHull(const up_interval &a, const up_interval &b)
+{ return up_interval::Neg_Lo(Max_Of(a.nlo, b.nlo), Max_Of(a.hi, b.hi)); }
+
+inline bool intersection(const up_interval &a, const up_interval &b, up_interval &result)
+{
+  double nlo = ( a.nlo < b.nlo ? a.nlo : b.nlo ), hi = ( a.hi < b.hi ? a.hi : b.hi );
+  if ( - nlo > hi )
+    return false;
+  result = up_interval::Neg_Lo(nlo, hi);
+  return true;
+}
+
+inline up_interval intersection(const up_interval &a, const up_interval &b)
+{
+  up_interval result;
+  if ( !intersection(a, b, result) )
+    throw Error_Handler("up_interval: The intersection is empty!");
+  return result;
+}
+
+inline bool subset        (const up_interval &a, const up_interval &b) { return a.subset(b); }
+inline bool subsetInterior(const up_interval &a, const up_interval &b) { return a.subsetInterior(b); }
+
+// [Mig, Mag]
+inline up_interval iabs(const up_interval &a)
+{
+  if ( a.nlo <= 0.0 )  // 0 <= lo
+    return a;
+  if ( a.hi <= 0.0 )   // hi <= 0
+    return - a;
+  return up_interval::Neg_Lo(0.0, Max_Of(a.nlo, a.hi));
+}
+
+inline up_interval abs(const up_interval &a) { return iabs(a); }
+
+inline up_interval sqr(const up_interval &a)
+{
+  up_interval m = iabs(a);
+  return up_interval::Neg_Lo(m.nlo * (- m.nlo), m.hi * m.hi);
+}
+
+inline up_interval nonnegativePart(const up_interval &a)
+{
+  if ( a.hi < 0.0 )
+    throw Error_Handler("up_interval: The interval is negative!");
+  return up_interval::Neg_Lo(( a.nlo < 0.0 ? a.nlo : 0.0 ), a.hi);
+}
+
+up_interval power (const up_interval &, const int &);
+up_interval power (const up_interval &, const double &);
+up_interval power (const up_interval &, const up_interval &);
+up_interval sqrt  (const up_interval &);
+up_interval log   (const up_interval &);
+up_interval exp   (const up_interval &);
+
+////////////////////////////////////////////////////////////////////
+
+// What CAPD's vectors and matrices need to know of their entries.
+namespace capd
+{
+  template <> class TypeTraits< up_interval >
+  {
+  public:
+    typedef double Real;
+
+    static inline up_interval zero() { return up_interval(0.0); }
+    static inline up_interval one () { return up_interval(1.0); }
+    static inline int numberOfDigits() { return TypeTraits<double>::numberOfDigits(); }
+    static inline double epsilon()     { return TypeTraits<double>::epsilon(); }
+
+    static const bool isExact     = false;
+    static const bool isInteger   = false;
+    static const bool isInterval  = true;
+    static const bool isSeparable = true;
+
+    static inline bool isSingular(const up_interval &a) { return a.contains(0.0); }
+    static inline up_interval abs(const up_interval &a) { return iabs(a); }
+  };
+}
+
+////////////////////////////////////////////////////////////////////
+
+#endif // UP_INTERVAL_H
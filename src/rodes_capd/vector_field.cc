@@ -6,6 +6,7 @@
 */
 
 #include "vector_field.h"
+#include "workspace.h"
 
 ////////////////////////////////////////////////////////////////////
 
@@ -57,23 +58,22 @@ BOX Vf_Range(const BOX &bx)
   Naive_Vf_Range(vf_box, center);
   DVf_Range(DVf, bx);
 
-  return vf_box + DVf * symmrad;
+  Mult_Add(vf_box, vf_box, DVf, symmrad);
+  return vf_box;
 }
 
 ////////////////////////////////////////////////////////////////////
 
+// Same as above, but uses the scratch storage of the calling thread.
 void Vf_Range(BOX &result, const BOX &bx)
 {
-  static BOX center(SYSDIM);
-  static BOX symmrad(SYSDIM);
-  static BOX vf_box(SYSDIM);
-  static IMatrix DVf(SYSDIM, SYSDIM);
+  workspace &ws = Thread_Workspace();
 
-  Mid_And_SymRad(center, symmrad, bx);
-  Naive_Vf_Range(vf_box, center);
-  DVf_Range(DVf, bx);
+  Mid_And_SymRad(ws.vf_center, ws.vf_symmrad, bx);
+  Naive_Vf_Range(ws.vf_box, ws.vf_center);
+  DVf_Range(ws.vf_DVf, bx);
 
-  result = vf_box + DVf * symmrad;
+  Mult_Add(result, ws.vf_box, ws.vf_DVf, ws.vf_symmrad);
 }
 
 ////////////////////////////////////////////////////////////////////
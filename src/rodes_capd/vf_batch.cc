@@ -0,0 +1,157 @@
+/*   File: vf_batch.cc
+
+     The range of the 'lorenz' vector field over several
+     boxes at once. See 'vf_batch.h'.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <fenv.h>
+
+#include "vf_batch.h"
+#include "vector_field.h"
+
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
+
+////////////////////////////////////////////////////////////////////
+
+#ifdef __SSE2__
+
+// The constants of the field, as (-lo, hi) (see 'vf_constant').
+enum { E1_K, E2_K, E3_K, K1_K, K2_K, K3_K, TWO_K2_K, TWO_K3_K,
+       K2_PLUS_K3_K, CONSTANTS };
+
+const int MAX_LANES = 4;
+
+// SSE2 (on by default on x86-64): 2 boxes at a time.
+namespace sse2
+{
+#define VF_TARGET
+
+typedef __m128d lanes;
+const int LANES = 2;
+
+static inline lanes L_Set (const double &x)       { return _mm_set1_pd(x); }
+static inline lanes L_Load(const double *p)       { return _mm_loadu_pd(p); }
+static inline void  L_Store(double *p, lanes x)   { _mm_storeu_pd(p, x); }
+static inline lanes L_Add (lanes x, lanes y)      { return _mm_add_pd(x, y); }
+static inline lanes L_Mul (lanes x, lanes y)      { return _mm_mul_pd(x, y); }
+static inline lanes L_Max (lanes x, lanes y)      { return _mm_max_pd(x, y); }
+static inline lanes L_Neg (lanes x)  // Exact: flips the sign bits.
+{ return _mm_xor_pd(x, _mm_set1_pd(-0.0)); }
+
+#include "vf_lanes.h"
+#undef VF_TARGET
+}
+
+// AVX: 4 boxes at a time. Only these functions are compiled for AVX,
+// and only called where the processor has it (see 'vf_kernel').
+namespace avx
+{
+#define VF_TARGET __attribute__((target("avx")))
+
+typedef __m256d lanes;
+const int LANES = 4;
+
+static inline VF_TARGET lanes L_Set (const double &x)     { return _mm256_set1_pd(x); }
+static inline VF_TARGET lanes L_Load(const double *p)     { return _mm256_loadu_pd(p); }
+static inline VF_TARGET void  L_Store(double *p, lanes x) { _mm256_storeu_pd(p, x); }
+static inline VF_TARGET lanes L_Add (lanes x, lanes y)    { return _mm256_add_pd(x, y); }
+static inline VF_TARGET lanes L_Mul (lanes x, lanes y)    { return _mm256_mul_pd(x, y); }
+static inline VF_TARGET lanes L_Max (lanes x, lanes y)    { return _mm256_max_pd(x, y); }
+static inline VF_TARGET lanes L_Neg (lanes x)  // Exact: flips the sign bits.
+{ return _mm256_xor_pd(x, _mm256_set1_pd(-0.0)); }
+
+#include "vf_lanes.h"
+#undef VF_TARGET
+}
+
+typedef void (*vf_lanes_fn)(double *, double *, const double *, const double *,
+			    const double [][2]);
+
+////////////////////////////////////////////////////////////////////
+
+// Called by 'Vf_Range_Batch'.
+// Picks the kernel once: AVX if the processor (and system) has it.
+static vf_lanes_fn vf_kernel(int &lanes)
+{
+  static const bool has_avx = __builtin_cpu_supports("avx");
+
+  lanes = ( has_avx ? avx::LANES : sse2::LANES );
+  return ( has_avx ? avx::Vf_Range_Lanes : sse2::Vf_Range_Lanes );
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by 'Vf_Range_Batch'.
+// The constants of the field as (-lo, hi), for the lanes.
+static void vf_constant(double k[][2], const int &n, const interval &iv)
+{
+  k[n][0] = - Inf(iv);
+  k[n][1] = Sup(iv);
+}
+
+#endif // __SSE2__
+
+////////////////////////////////////////////////////////////////////
+
+// Called by 'Some_May_Vanish', 'None_May_Vanish'.
+// Returns the ranges of the vector field over the n boxes bx[0],...,
+// bx[n - 1] in vf[0],..., vf[n - 1], 4 (AVX) or 2 (SSE2) boxes at a
+// time. The last lanes are filled up with the last box. The interval
+// arithmetic is done here, outside of the code compiled for AVX.
+void Vf_Range_Batch(BOX *vf, const BOX *bx, const int &n)
+{
+#ifdef __SSE2__
+  double lo[3 * MAX_LANES], hi[3 * MAX_LANES];
+  double vf_lo[3 * MAX_LANES], vf_hi[3 * MAX_LANES];
+  double k[CONSTANTS][2];
+  int lanes;
+  vf_lanes_fn Vf_Range_Lanes = vf_kernel(lanes);
+#ifndef HOISTED_ROUNDING
+  int mode = fegetround();
+#endif
+
+  vf_constant(k, E1_K, E1_IV);
+  vf_constant(k, E2_K, E2_IV);
+  vf_constant(k, E3_K, E3_IV);
+  vf_constant(k, K1_K, K1_IV);
+  vf_constant(k, K2_K, K2_IV);
+  vf_constant(k, K3_K, K3_IV);
+  vf_constant(k, TWO_K2_K, TWO_K2_IV);
+  vf_constant(k, TWO_K3_K, TWO_K3_IV);
+  vf_constant(k, K2_PLUS_K3_K, K2_PLUS_K3_IV);
+
+  for ( int first = 0; first < n; first += lanes )
+    {
+      for ( int j = 0; j < lanes; j++ )
+	{
+	  const BOX &box = bx[ first + j < n ? first + j : n - 1 ];
+	  for ( short i = 0; i < 3; i++ )
+	    {
+	      lo[i * lanes + j] = Inf(box[i]);
+	      hi[i * lanes + j] = Sup(box[i]);
+	    }
+	}
+
+#ifdef HOISTED_ROUNDING
+      Vf_Range_Lanes(vf_lo, vf_hi, lo, hi, k);  // The rounding is upward.
+#else
+      fesetround(FE_UPWARD);  // For all of the lanes' arithmetic.
+      Vf_Range_Lanes(vf_lo, vf_hi, lo, hi, k);
+      fesetround(mode);
+#endif
+
+      for ( int j = 0; j < lanes && first + j < n; j++ )
+	for ( short i = 0; i < 3; i++ )
+	  vf[first + j][i] = interval(vf_lo[i * lanes + j], vf_hi[i * lanes + j]);
+    }
+#else
+  for ( int j = 0; j < n; j++ )
+    Vf_Range(vf[j], bx[j]);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////
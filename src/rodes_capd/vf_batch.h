@@ -0,0 +1,31 @@
+/*   File: vf_batch.h
+
+     The range of the 'lorenz' vector field over several
+     boxes at once. 'Vf_Range_Batch' gives what 'Vf_Range'
+     gives for each box (the mean value form, with the
+     partial derivatives over the box), but evaluates the
+     field and its partial derivatives for 2 (SSE2) or 4
+     (AVX) boxes in the lanes of one vector register.
+     Both are built; AVX is used where the processor has
+     it (checked once, when first called).
+
+     Each interval is kept as (-lo, hi), and all of the
+     arithmetic is rounded upwards: the lower bounds are
+     then rounded downwards, since -(-a * b) <= a * b.
+     Without SSE2 each box is done by 'Vf_Range'.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#ifndef VF_BATCH_H
+#define VF_BATCH_H
+
+#include "classes.h"
+
+////////////////////////////////////////////////////////////////////
+
+void Vf_Range_Batch (BOX *, const BOX *, const int &);
+
+////////////////////////////////////////////////////////////////////
+
+#endif // VF_BATCH_H
@@ -0,0 +1,112 @@
+/*   File: vf_bench.cc
+
+     Times the range of the vector field over the corner
+     boxes of 'None_May_Vanish': 'Vf_Range' (CAPD, one box
+     at a time) against 'Vf_Range_Batch' (see 'vf_batch.h').
+     Also checks that the two ranges overlap, and compares
+     their widths.
+
+     Usage: vf_bench [rounds]
+
+     Compilation: make vf_bench
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+#include <sys/time.h>
+
+#include "classes.h"
+#include "vector_field.h"
+#include "vf_batch.h"
+#include "workspace.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+static double seconds_since (const struct timeval &);
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: none
+// Calls to : 'Vf_Range', 'Vf_Range_Batch', 'seconds_since'
+int main(int argc, char *argv[])
+{
+  int rounds = ( argc == 2 ? atoi(argv[1]) : 100000 );
+  if ( rounds <= 0 )
+    {
+      cout << endl << "Usage: " << endl;
+      cout << "\t" << argv[0] << " [rounds]\n\n"
+	   << "\twhich times the range of the vector field over "
+	   << CORNERS << " boxes,\n"
+	   << "\t[rounds] (default 100000) times.\n" << endl;
+      exit(0);
+    }
+
+  // Corner boxes as met near the origin.
+  BOX bx[CORNERS], vf[CORNERS], vf_batch[CORNERS];
+  srand(1);
+  for ( int k = 0; k < CORNERS; k++ )
+    {
+      bx[k] = vf[k] = vf_batch[k] = BOX(SYSDIM);
+      for ( short i = 1; i <= SYSDIM; i++ )
+	{
+	  double mid = 20.0 * rand() / RAND_MAX - 10.0;
+	  double rad = 1e-3 * rand() / RAND_MAX;
+	  bx[k](i) = Hull(mid - rad, mid + rad);
+	}
+    }
+
+  struct timeval start;
+  gettimeofday(&start, NULL);
+  for ( int n = 0; n < rounds; n++ )
+    for ( int k = 0; k < CORNERS; k++ )
+      Vf_Range(vf[k], bx[k]);
+  double scalar = seconds_since(start);
+
+  gettimeofday(&start, NULL);
+  for ( int n = 0; n < rounds; n++ )
+    Vf_Range_Batch(vf_batch, bx, CORNERS);
+  double batch = seconds_since(start);
+
+  double width = 0.0, width_batch = 0.0;
+  bool overlap = true;
+  for ( int k = 0; k < CORNERS; k++ )
+    for ( short i = 1; i <= SYSDIM; i++ )
+      {
+	width       += Diam(vf[k](i));
+	width_batch += Diam(vf_batch[k](i));
+	if ( Sup(vf[k](i)) < Inf(vf_batch[k](i)) ||
+	     Sup(vf_batch[k](i)) < Inf(vf[k](i)) )
+	  overlap = false;
+      }
+
+  cout << rounds << " x " << CORNERS << " boxes:" << endl;
+  cout << "  Vf_Range       " << setw(10) << scalar << " s" << endl;
+  cout << "  Vf_Range_Batch " << setw(10) << batch << " s   ("
+       << ( batch > 0.0 ? scalar / batch : 0.0 ) << " times faster)" << endl;
+  cout << "  widths (batch / scalar): "
+       << ( width > 0.0 ? width_batch / width : 0.0 ) << endl;
+  if ( !overlap )
+    {
+      cout << "Error: the ranges do not overlap!" << endl;
+      return 1;
+    }
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////
+
+static double seconds_since(const struct timeval &start)
+{
+  struct timeval stop;
+
+  gettimeofday(&stop, NULL);
+  return (stop.tv_sec - start.tv_sec) + 1e-6 * (stop.tv_usec - start.tv_usec);
+}
+
+////////////////////////////////////////////////////////////////////
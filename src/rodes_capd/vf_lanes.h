@@ -0,0 +1,145 @@
+/*   File: vf_lanes.h
+
+     The range of the 'lorenz' vector field over LANES
+     boxes, one in each lane of a vector register. Only
+     for 'vf_batch.cc', which includes this file once for
+     each width, inside a namespace defining the type
+     'lanes', the constant LANES, the operations L_Set,...,
+     L_Neg, and VF_TARGET: the instruction set these
+     functions are compiled for.
+
+     Nothing here may call a function of a shared header
+     (such as 'classes.h'): compiled for AVX, it would be
+     used by the callers not compiled for it.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+////////////////////////////////////////////////////////////////////
+
+// An interval in each lane, kept as (-lo, hi). With upward rounding
+// both bounds are then rounded outwards.
+typedef struct
+{
+  lanes nlo;
+  lanes hi;
+} lane_interval;
+
+static inline VF_TARGET lane_interval I_Const(const double c[2])
+{
+  lane_interval r = { L_Set(c[0]), L_Set(c[1]) };
+  return r;
+}
+
+static inline VF_TARGET lane_interval I_Point(lanes x)
+{
+  lane_interval r = { L_Neg(x), x };
+  return r;
+}
+
+static inline VF_TARGET lane_interval I_Add(const lane_interval &a,
+					    const lane_interval &b)
+{
+  lane_interval r = { L_Add(a.nlo, b.nlo), L_Add(a.hi, b.hi) };
+  return r;
+}
+
+static inline VF_TARGET lane_interval I_Sub(const lane_interval &a,
+					    const lane_interval &b)
+{
+  lane_interval r = { L_Add(a.nlo, b.hi), L_Add(a.hi, b.nlo) };
+  return r;
+}
+
+static inline VF_TARGET lane_interval I_Neg(const lane_interval &a)
+{
+  lane_interval r = { a.hi, a.nlo };
+  return r;
+}
+
+// The hull of the four products of the bounds: hi is the largest
+// (rounded up), and -lo the largest of the negated products
+// (-a * b = (-a) * b, rounded up).
+static inline VF_TARGET lane_interval I_Mul(const lane_interval &a,
+					    const lane_interval &b)
+{
+  lanes a_lo = L_Neg(a.nlo), a_nhi = L_Neg(a.hi), b_lo = L_Neg(b.nlo);
+  lane_interval r;
+
+  r.hi  = L_Max(L_Max(L_Mul(a_lo, b_lo),    L_Mul(a_lo, b.hi)),
+		L_Max(L_Mul(a.hi, b_lo),    L_Mul(a.hi, b.hi)));
+  r.nlo = L_Max(L_Max(L_Mul(a.nlo, b_lo),   L_Mul(a.nlo, b.hi)),
+		L_Max(L_Mul(a_nhi, b_lo),   L_Mul(a_nhi, b.hi)));
+  return r;
+}
+
+// The largest absolute value in the interval.
+static inline VF_TARGET lanes I_Mag(const lane_interval &a)
+{
+  return L_Max(a.nlo, a.hi);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by 'Vf_Range_Batch'.
+// Does LANES boxes: box k of the lanes has the bounds lo[i * LANES + k],
+// hi[i * LANES + k] (i = 0, 1, 2). The ranges are returned the same
+// way. The constants of the field are in k[] (see 'vf_constant').
+// As in 'Vf_Range': vf = f(center) + DVf(bx) * [-r, r].
+static VF_TARGET void Vf_Range_Lanes(double *vf_lo, double *vf_hi,
+				     const double *lo, const double *hi,
+				     const double k[][2])
+{
+  const lane_interval E1_L = I_Const(k[E1_K]), E2_L = I_Const(k[E2_K]);
+  const lane_interval E3_L = I_Const(k[E3_K]), K1_L = I_Const(k[K1_K]);
+  const lane_interval K2_L = I_Const(k[K2_K]), K3_L = I_Const(k[K3_K]);
+  const lane_interval TWO_K2_L = I_Const(k[TWO_K2_K]);
+  const lane_interval TWO_K3_L = I_Const(k[TWO_K3_K]);
+  const lane_interval K2_PLUS_K3_L = I_Const(k[K2_PLUS_K3_K]);
+  const lanes half = L_Set(0.5);
+
+  lane_interval x[3], c[3];
+  lanes r[3];
+  for ( short i = 0; i < 3; i++ )
+    {
+      lanes x_lo = L_Load(lo + i * LANES), x_hi = L_Load(hi + i * LANES);
+      x[i].nlo = L_Neg(x_lo);
+      x[i].hi  = x_hi;
+      // lo/2 and hi/2 are exact, so the center (rounded up) is in
+      // the box, and the radius (rounded up) reaches both of its ends.
+      lanes center = L_Add(L_Mul(half, x_lo), L_Mul(half, x_hi));
+      c[i] = I_Point(center);
+      r[i] = L_Max(L_Add(x_hi, L_Neg(center)), L_Add(center, x[i].nlo));
+    }
+
+  // The field at the center (see 'Naive_Vf_Range').
+  lane_interval C1 = I_Add(c[0], c[1]);
+  lane_interval C2 = I_Mul(I_Mul(K1_L, C1), c[2]);
+  lane_interval f[3];
+  f[0] = I_Sub(I_Mul(E1_L, c[0]), C2);
+  f[1] = I_Add(I_Mul(E2_L, c[1]), C2);
+  f[2] = I_Add(I_Mul(E3_L, c[2]),
+	       I_Mul(C1, I_Add(I_Mul(K2_L, c[0]), I_Mul(K3_L, c[1]))));
+
+  // The partial derivatives over the box (see 'DVf_Range').
+  lane_interval B1 = I_Mul(K1_L, I_Add(x[0], x[1]));
+  lane_interval B2 = I_Mul(K1_L, x[2]);
+  lane_interval D[3][3];
+  D[0][0] = I_Sub(E1_L, B2);  D[0][1] = I_Neg(B2);          D[0][2] = I_Neg(B1);
+  D[1][0] = B2;               D[1][1] = I_Add(E2_L, B2);    D[1][2] = B1;
+  D[2][0] = I_Add(I_Mul(TWO_K2_L, x[0]), I_Mul(K2_PLUS_K3_L, x[1]));
+  D[2][1] = I_Add(I_Mul(K2_PLUS_K3_L, x[0]), I_Mul(TWO_K3_L, x[1]));
+  D[2][2] = E3_L;
+
+  // D * [-r, r] = [-s, s], with s = sum_j |D(i,j)| * r(j).
+  for ( short i = 0; i < 3; i++ )
+    {
+      lanes s = L_Mul(I_Mag(D[i][0]), r[0]);
+      s = L_Add(s, L_Mul(I_Mag(D[i][1]), r[1]));
+      s = L_Add(s, L_Mul(I_Mag(D[i][2]), r[2]));
+      L_Store(vf_lo + i * LANES, L_Neg(L_Add(f[i].nlo, s)));
+      L_Store(vf_hi + i * LANES, L_Add(f[i].hi, s));
+    }
+}
+
+////////////////////////////////////////////////////////////////////
@@ -0,0 +1,118 @@
+/*   File: wakeup.cc
+
+     Waking the processes waiting for a fresh grid.
+     See 'wakeup.h'.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <string>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#ifdef __linux
+#include <sys/inotify.h>
+#endif
+
+#include "wakeup.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+static std::string bell_name; // <shared_file>.bell
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_the_flags' (rodes)
+// Calls to : none
+// Creates the bell of 'shared_file', unless it exists.
+void wakeup_open(const char *shared_file)
+{
+  bell_name = std::string(shared_file) + WAKEUP_SUFFIX;
+
+  int fd = open(bell_name.c_str(), O_WRONLY | O_CREAT, 0666);
+  if ( fd >= 0 )
+    close(fd);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_a_grid' (rodes)
+// Calls to : none
+// Starts listening for the bell. Returns the handle to pass on to
+// 'wakeup_wait' or 'wakeup_cancel'; -1 if we cannot listen.
+int wakeup_arm()
+{
+#ifdef __linux
+  if ( bell_name.empty() )
+    return -1;
+
+  int fd = inotify_init();
+  if ( fd < 0 )
+    return -1;
+  if ( inotify_add_watch(fd, bell_name.c_str(), IN_MODIFY) < 0 )
+    {
+      close(fd);
+      return -1;
+    }
+  return fd;
+#else
+  return -1;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_a_grid' (rodes)
+// Calls to : 'wakeup_cancel'
+// Waits until the bell rings (after 'wakeup_arm'), but at most
+// 'seconds' seconds.
+void wakeup_wait(const int &handle, const unsigned &seconds)
+{
+  if ( handle < 0 )
+    {
+      sleep(seconds);
+      return;
+    }
+
+  struct pollfd pfd;
+  pfd.fd = handle;
+  pfd.events = POLLIN;
+  while ( poll(&pfd, 1, 1000 * seconds) < 0 && errno == EINTR )
+    { /* A signal; wait again. */ }
+  wakeup_cancel(handle);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_a_grid' (rodes), 'wakeup_wait'
+// Calls to : none
+void wakeup_cancel(const int &handle)
+{
+  if ( handle >= 0 )
+    close(handle);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'insert_it_List' (rodes)
+// Calls to : none
+// Rings the bell: the waiting processes look for a grid again.
+void wakeup_ring()
+{
+  if ( bell_name.empty() )
+    return;
+
+  int fd = open(bell_name.c_str(), O_WRONLY);
+  if ( fd < 0 )
+    return;
+  char byte = '\n';
+  if ( pwrite(fd, &byte, 1, 0) != 1 )
+    { /* Nobody will hear it; they time out instead. */ }
+  close(fd);
+}
+
+////////////////////////////////////////////////////////////////////
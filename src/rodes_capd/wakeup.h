@@ -0,0 +1,38 @@
+/*   File: wakeup.h
+
+     Wakes the processes waiting for a fresh grid, as soon
+     as some process has inserted its images. The waiting
+     process watches (inotify) the file <shared_file>.bell,
+     which 'wakeup_ring' writes to. Without inotify (or for
+     processes on other hosts, sharing the file over NFS),
+     we simply wait for the full time-out, as before.
+
+     A process looking for a grid calls 'wakeup_arm' before
+     looking, so that a ring in between is not missed.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#ifndef WAKEUP_H
+#define WAKEUP_H
+
+////////////////////////////////////////////////////////////////////
+
+// The bell of <shared_file> is <shared_file> followed by this suffix.
+static const char WAKEUP_SUFFIX[] = ".bell";
+
+////////////////////////////////////////////////////////////////////
+
+void wakeup_open   (const char *);
+
+int  wakeup_arm    ();
+
+void wakeup_wait   (const int &, const unsigned &);
+
+void wakeup_cancel (const int &);
+
+void wakeup_ring   ();
+
+////////////////////////////////////////////////////////////////////
+
+#endif // WAKEUP_H
@@ -0,0 +1,79 @@
+/*   File: workspace.cc
+
+     The per-thread scratch storage of the integrator.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <pthread.h>
+
+#include "workspace.h"
+
+////////////////////////////////////////////////////////////////////
+
+static pthread_key_t  workspace_key;
+static pthread_once_t workspace_once = PTHREAD_ONCE_INIT;
+
+static void Delete_Workspace (void *);
+static void Create_Key       ();
+
+////////////////////////////////////////////////////////////////////
+
+workspace::workspace()
+  : vf_center(SYSDIM), vf_symmrad(SYSDIM), vf_box(SYSDIM),
+    vf_DVf(SYSDIM, SYSDIM),
+    lu_vv(SYSDIM + 1), lu_result(SYSDIM), lu_matrix(SYSDIM, SYSDIM)
+{
+  for ( short k = 0; k < 2; k++ )
+    {
+      poincare[k]   = BOX(SYSDIM);
+      side_box[k]   = BOX(SYSDIM);
+      corner_box[k] = BOX(SYSDIM);
+      corner_box_vf[k] = BOX(SYSDIM);
+    }
+  for ( short k = 0; k < CORNERS; k++ )
+    {
+      point_in[k]   = DVector(SYSDIM);
+      point_out[k]  = DVector(SYSDIM);
+      corner_in[k]  = BOX(SYSDIM);
+      corner_out[k] = BOX(SYSDIM);
+      corner_out_vf[k] = BOX(SYSDIM);
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: the system, when a thread exits.
+static void Delete_Workspace(void *ws)
+{
+  delete (workspace *) ws;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'pthread_once'
+static void Create_Key()
+{
+  pthread_key_create(&workspace_key, Delete_Workspace);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'Vf_Range', 'Invert_And_Mult', 'Some_May_Vanish',
+//            'None_May_Vanish', etc.
+// Returns the workspace of the calling thread. It is
+// created the first time a thread asks for it.
+workspace & Thread_Workspace()
+{
+  pthread_once(&workspace_once, Create_Key);
+
+  workspace *ws = (workspace *) pthread_getspecific(workspace_key);
+  if ( ws == NULL )
+    {
+      ws = new workspace;
+      pthread_setspecific(workspace_key, ws);
+    }
+  return *ws;
+}
+
+////////////////////////////////////////////////////////////////////
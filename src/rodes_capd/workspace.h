@@ -0,0 +1,71 @@
+/*   File: workspace.h
+
+     The scratch storage of the integrator. These used
+     to be 'static' variables in the low level functions,
+     which made the integrator non-reentrant. Now every
+     thread gets its own workspace via 'Thread_Workspace'.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include "classes.h"
+#include "telemetry.h"
+#include "trace.h"
+
+////////////////////////////////////////////////////////////////////
+
+// The number of corners of a codim-1 face: 2^(SYSDIM - 1).
+// Unlike POWER (low_functions.h) this is a compile time constant.
+const int CORNERS = 1 << (SYSDIM - 1);
+
+////////////////////////////////////////////////////////////////////
+
+class workspace
+{
+ public:
+  workspace();
+
+  // Used by 'Vf_Range'.
+  BOX     vf_center;
+  BOX     vf_symmrad;
+  BOX     vf_box;
+  IMatrix vf_DVf;
+
+  // Used by 'LU_Decompose', 'LU_Backsub' and 'Invert_And_Mult'.
+  int     lu_indx[SYSDIM + 1];
+  IVector lu_vv;        // Indexed 1,...,SYSDIM, hence one extra element.
+  BOX     lu_result;
+  IMatrix lu_matrix;
+
+  // Used by 'Some_May_Vanish'.
+  BOX     poincare[2];
+  BOX     side_box[2];
+  BOX     corner_box[2];
+  BOX     corner_box_vf[2];     // The field over corner_box.
+
+  // Used by 'None_May_Vanish'.
+  DVector point_in[CORNERS];
+  DVector point_out[CORNERS];
+  BOX     corner_in[CORNERS];
+  BOX     corner_out[CORNERS];
+  BOX     corner_out_vf[CORNERS]; // The field over corner_out.
+
+  // The counts for the grid being done by the thread.
+  grid_stats stats;
+
+#if TRACE_LEVEL > 0
+  // What the thread has traced, and not yet written.
+  trace_ring trace;
+#endif
+};
+
+////////////////////////////////////////////////////////////////////
+
+workspace & Thread_Workspace ();
+
+////////////////////////////////////////////////////////////////////
+
+#endif // WORKSPACE_H
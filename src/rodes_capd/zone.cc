@@ -0,0 +1,212 @@
+/*   File: zone.cc
+
+     The zones of the Poincare section. See 'zone.h'.
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#include <fenv.h>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "zone.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////
+
+// Zone #9 contains W^s(0): the boxes pass close to the origin, and
+// take long to flow. So do the boxes in zones #16 and #17, where
+// the transversal has to switch often. (The values compiled in; see
+// 'Read_Zones'.)
+static zone_parameters zone_table[ZONES + 1] =
+  { //  max_size  more_than_one  cost
+    {   0.000,    0.0,           0.0 }, // (Not used.)
+    {   0.010,    1.1,           2.0 }, // Zone #1  [+4.5, +inf]
+    {   0.012,    1.1,           1.5 }, // Zone #2  [+4.0, +4.5]
+    {   0.015,    1.1,           1.2 }, // Zone #3  [+3.5, +4.0]
+    {   0.019,    1.1,           1.0 }, // Zone #4  [+3.0, +3.5]
+    {   0.024,    1.1,           1.0 }, // Zone #5  [+2.5, +3.0]
+    {   0.030,    1.1,           1.0 }, // Zone #6  [+2.0, +2.5]
+    {   0.032,    1.1,           1.0 }, // Zone #7  [+1.5, +2.0]
+    {   0.035,    1.1,           2.0 }, // Zone #8  [+1.0, +1.5]
+    {   0.040,    1.1,           8.0 }, // Zone #9  [+0.5, +1.0] - contains W^s(0).
+    {   0.035,    1.1,           3.0 }, // Zone #10 [+0.0, +0.5]
+    {   0.032,    1.1,           1.5 }, // Zone #11 [-1.0, +0.0]
+    {   0.029,    1.1,           1.0 }, // Zone #12 [-2.0, -1.0]
+    {   0.026,    1.1,           1.0 }, // Zone #13 [-3.0, -2.0]
+    {   0.023,    1.1,           1.2 }, // Zone #14 [-4.0, -3.0]
+    {   0.020,    1.1,           1.5 }, // Zone #15 [-4.296875, -4.0]
+    {   0.015,    1.2,           4.0 }, // Zone #16 [-4.36328125, -4.296875]
+    {   0.012,    1.3,           8.0 }  // Zone #17 [-inf, -4.36328125]
+  };
+
+static double scale_factor = SCALE_FACTOR;
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'Set_Max_Size' (return_map), 'Get_Grid_Zone'
+// Calls to : none
+// Returns the zone of the point (x, y) of the Poincare section.
+int Get_Zone(const double &x_in, const double &y)
+{
+  double x = x_in;
+
+  if ( 5 * y < 2 * x ) // Reflect onto upper branch.
+    x = - x;
+
+  if ( x < - 1118 / 256.0 ) return 17;
+  if ( x < - 1100 / 256.0 ) return 16;
+  if ( x > + 4.5 )          return 1;
+  if ( x > + 4.0 )          return 2;
+  if ( x > + 3.5 )          return 3;
+  if ( x > + 3.0 )          return 4;
+  if ( x > + 2.5 )          return 5;
+  if ( x > + 2.0 )          return 6;
+  if ( x > + 1.5 )          return 7;
+  if ( x > + 1.0 )          return 8;
+  if ( x > + 0.5 )          return 9;
+  if ( x > + 0.0 )          return 10;
+  if ( x > - 1.0 )          return 11;
+  if ( x > - 2.0 )          return 12;
+  if ( x > - 3.0 )          return 13;
+  if ( x > - 4.0 )          return 14;
+  return 15;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'grid_cost' (cost)
+// Calls to : 'Get_Zone'
+// The zone of the midpoint of the grid g (see 'grid_to_box').
+int Get_Grid_Zone(const grid &g)
+{
+  double scale = ldexp(1.0, -g.P);
+
+  return Get_Zone(g.u * scale, g.v * scale);
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'Set_Max_Size' (return_map), 'grid_cost' (cost)
+// Calls to : none
+const zone_parameters & Get_Zone_Parameters(const int &zone)
+{
+  if ( zone < 1 || zone > ZONES )
+    return zone_table[15];
+  return zone_table[zone];
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main' (rodes_tune)
+// Calls to : none
+void Set_Zone_Parameters(const int &zone, const zone_parameters &param)
+{
+  if ( zone >= 1 && zone <= ZONES )
+    zone_table[zone] = param;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'Corner_Step' (return_map), 'cache_open' (result_cache)
+// Calls to : none
+double Get_Scale_Factor()
+{
+  return scale_factor;
+}
+
+// Called by: 'main' (rodes_tune)
+// Calls to : none
+void Set_Scale_Factor(const double &factor)
+{
+  scale_factor = factor;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'get_the_options' (rodes), 'main' (rodes_tune)
+// Calls to : none
+// Reads the zone table from the file 'file_name' (see 'zone.h').
+// Returns false, leaving the table as it was, if the file cannot be
+// read or has a line we do not understand.
+bool Read_Zones(const char *file_name)
+{
+  std::ifstream InFile(file_name, ios::in);
+  zone_parameters table[ZONES + 1];
+  double factor = scale_factor;
+  std::string line;
+  int line_nr = 0;
+
+  if ( !InFile )
+    {
+      cout << "Error: cannot read the zone file " << file_name << endl;
+      return false;
+    }
+  for ( int zone = 0; zone <= ZONES; zone++ )
+    table[zone] = zone_table[zone];
+
+  while ( getline(InFile, line) )
+    {
+      std::istringstream in(line);
+      std::string word, rest;
+      zone_parameters param;
+      int zone;
+
+      line_nr++;
+      if ( !(in >> word) || word[0] == '#' )
+	continue;
+      if ( word == "scale_factor" )
+	{
+	  if ( in >> factor && !(in >> rest) && factor >= 1.0 )
+	    continue;
+	}
+      else
+	{
+	  std::istringstream zone_in(word);
+	  if ( zone_in >> zone && zone >= 1 && zone <= ZONES &&
+	       in >> param.max_size >> param.more_than_one >> param.cost &&
+	       !(in >> rest) && param.max_size > 0.0 &&
+	       param.more_than_one > 1.0 && param.cost > 0.0 )
+	    {
+	      table[zone] = param;
+	      continue;
+	    }
+	}
+      cout << "Error: " << file_name << ", line " << line_nr
+	   << ": " << line << endl;
+      return false;
+    }
+
+  for ( int zone = 0; zone <= ZONES; zone++ )
+    zone_table[zone] = table[zone];
+  scale_factor = factor;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+
+// Called by: 'main' (rodes_tune)
+// Calls to : none
+// Writes the zone table, as read by 'Read_Zones'. (The rounding may
+// have been left upward by the integrator: the decimals would then
+// be rounded up too.)
+void Write_Zones(ostream &out)
+{
+  std::streamsize precision = out.precision(10);
+  int rounding = fegetround();
+
+  fesetround(FE_TONEAREST);
+
+  out << "# <zone> <max_size> <more_than_one> <cost>" << endl
+      << "scale_factor " << scale_factor << endl;
+  for ( int zone = 1; zone <= ZONES; zone++ )
+    out << zone << " " << zone_table[zone].max_size << " "
+	<< zone_table[zone].more_than_one << " " << zone_table[zone].cost << endl;
+  out.precision(precision);
+  fesetround(rounding);
+}
+
+////////////////////////////////////////////////////////////////////
@@ -0,0 +1,70 @@
+/*   File: zone.h
+
+     The zones of the Poincare section z = 27, by the
+     distance to the stable manifold of the origin
+     (x ~ +0.75). Each zone has its own resolution
+     ('max_size', 'more_than_one'; see 'Set_Max_Size'
+     in 'return_map.cc') and a rough a priori cost of
+     a grid, relative to the cheapest zones. The cost
+     is used for doing the expensive grids first (see
+     'cost.h'), not for the computations themselves.
+
+     The table may be read from a file ('rodes --zones
+     <file>'), as written by 'Write_Zones' (and by the
+     tuner 'rodes_tune'):
+
+       # Any comment.
+       scale_factor <x>
+       <zone> <max_size> <more_than_one> <cost>
+
+     one line per zone; the zones left out keep the values
+     compiled in. 'scale_factor' widens the boxes of the
+     coarse enclosure in 'Flow' (return_map.cc).
+
+     Latest edit: Fri Oct 16 2026
+*/
+
+#ifndef ZONE_H
+#define ZONE_H
+
+#include <iostream>
+
+#include "2d_classes.h"
+
+////////////////////////////////////////////////////////////////////
+
+// The zones are numbered 1, 2,..., ZONES.
+const int ZONES = 17;
+
+// Used in 'Flow' for the coarse enclosure, unless the zone file
+// has another 'scale_factor'.
+const double SCALE_FACTOR = 1.1;
+
+typedef struct
+{
+  double max_size;      // The largest side of a box being flowed.
+  double more_than_one; // Prevents flipping between transversals.
+  double cost;          // A priori cost of a grid (relative).
+} zone_parameters;
+
+////////////////////////////////////////////////////////////////////
+
+int                     Get_Zone            (const double &, const double &);
+
+int                     Get_Grid_Zone       (const grid &);
+
+const zone_parameters & Get_Zone_Parameters (const int &);
+
+void                    Set_Zone_Parameters (const int &, const zone_parameters &);
+
+double                  Get_Scale_Factor    ();
+
+void                    Set_Scale_Factor    (const double &);
+
+bool                    Read_Zones          (const char *);
+
+void                    Write_Zones         (std::ostream &);
+
+////////////////////////////////////////////////////////////////////
+
+#endif // ZONE_H